@@ -0,0 +1,109 @@
+/** Microbenchmarks: closest point search on the reference spline and the ellipsoid decomposition of free space */
+#include "benchmarks.h"
+
+#include <mpc_planner_util/parameters.h>
+
+#include <ros_tools/spline.h>
+
+#include <decomp_util/ellipsoid_decomp.h>
+
+#include <cmath>
+#include <random>
+
+namespace MPCPlanner
+{
+    /** @brief Query points that follow the path with lateral noise, at most `step` apart */
+    static std::vector<Eigen::Vector2d> queryPoints(int count, double step)
+    {
+        std::mt19937 rng(SyntheticScene::SEED);
+        std::normal_distribution<double> lateral(0., 0.5);
+
+        std::vector<Eigen::Vector2d> points;
+        points.reserve(count);
+        for (int i = 0; i < count; i++)
+            points.emplace_back(std::fmod(i * step, SyntheticScene::LENGTH), lateral(rng));
+        return points;
+    }
+
+    /** @brief Tracking: the query moves a little each call, such that only the segments around the previous result are searched */
+    static void BM_SplineClosestPointLocal(benchmark::State &bench)
+    {
+        std::vector<double> x, y;
+        generateReferencePath(x, y, bench.range(0));
+        RosTools::Spline2D spline(x, y);
+
+        auto points = queryPoints(1000, 0.05);
+        int segment;
+        double t;
+        size_t i = 0;
+        for (auto _ : bench)
+        {
+            spline.findClosestPoint(points[i], segment, t);
+            benchmark::DoNotOptimize(t);
+            i = (i + 1) % points.size();
+        }
+    }
+
+    /** @brief Initialization: every query jumps, such that the whole spline is searched */
+    static void BM_SplineClosestPointGlobal(benchmark::State &bench)
+    {
+        std::vector<double> x, y;
+        generateReferencePath(x, y, bench.range(0));
+        RosTools::Spline2D spline(x, y);
+
+        auto points = queryPoints(1000, 7.3);
+        int segment;
+        double t;
+        size_t i = 0;
+        for (auto _ : bench)
+        {
+            spline.findClosestPoint(points[i], segment, t);
+            benchmark::DoNotOptimize(t);
+            i = (i + 1) % points.size();
+        }
+    }
+
+    /** @brief Decompose the free space along the horizon, with the obstacles rasterized as occupied points on their boundary */
+    static void BM_EllipsoidDecompDilate(benchmark::State &bench)
+    {
+        const int N = CONFIG["N"].as<int>();
+        const double dt = CONFIG["integrator_step"].as<double>();
+        const double range = CONFIG["decomp"]["range"].as<double>(2.);
+        const double resolution = 0.05; // [m] Of the (costmap) occupied points
+
+        vec_Vec2f occupied;
+        for (auto &obstacle : generateObstacles(bench.range(0)))
+        {
+            int num_points = std::max(8, (int)std::ceil(2. * M_PI * obstacle.radius / resolution));
+            for (int i = 0; i < num_points; i++)
+            {
+                double angle = 2. * M_PI * i / num_points;
+                occupied.emplace_back(obstacle.position(0) + obstacle.radius * std::cos(angle),
+                                      obstacle.position(1) + obstacle.radius * std::sin(angle));
+            }
+        }
+
+        vec_Vec2f path;
+        for (int k = 0; k < N; k++)
+            path.emplace_back(k * dt * SyntheticScene::VELOCITY, 0.);
+
+        EllipsoidDecomp2D decomp;
+        decomp.set_local_bbox(Vec2f(range, range));
+        decomp.set_obs(occupied);
+        for (auto _ : bench)
+        {
+            decomp.dilate(path, 0);
+            benchmark::ClobberMemory();
+        }
+        bench.counters["occupied_points"] = occupied.size();
+    }
+
+    void registerGeometryBenchmarks(const std::vector<int> &obstacle_counts)
+    {
+        for (auto *bm : {benchmark::RegisterBenchmark("Spline2D::findClosestPoint/local", BM_SplineClosestPointLocal),
+                         benchmark::RegisterBenchmark("Spline2D::findClosestPoint/global", BM_SplineClosestPointGlobal)})
+            bm->ArgName("path_points")->Arg(50)->Arg(SyntheticScene::PATH_POINTS)->Arg(1000);
+
+        withObstacleCounts(benchmark::RegisterBenchmark("EllipsoidDecomp2D::dilate", BM_EllipsoidDecompDilate), obstacle_counts);
+    }
+}
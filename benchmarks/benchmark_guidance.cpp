@@ -0,0 +1,153 @@
+/** Microbenchmarks: the guidance planner kernels (visibility, homology comparison, PRM construction and spline optimization) */
+#include "benchmarks.h"
+
+#include <guidance_planner/config.h>
+#include <guidance_planner/cubic_spline.h>
+#include <guidance_planner/environment.h>
+#include <guidance_planner/prm.h>
+#include <guidance_planner/homotopy_comparison/homology.h>
+
+#include <ros_tools/clock.h>
+
+#include <memory>
+#include <random>
+
+using namespace GuidancePlanner;
+
+namespace MPCPlanner
+{
+    /** @brief Loads guidance_planner/config/params.yaml (relative to the working directory) once */
+    static Config &guidanceConfig()
+    {
+        static Config config;
+        return config;
+    }
+
+    static ObstacleSnapshot guidanceObstacles(int count)
+    {
+        auto obstacles = std::make_shared<std::vector<Obstacle>>();
+        int id = 0;
+        for (auto &obstacle : generateObstacles(count))
+            obstacles->emplace_back(id++, obstacle.position, obstacle.velocity, Config::DT, Config::N, obstacle.radius);
+        return obstacles;
+    }
+
+    /** @brief Passing all obstacles on the left and on the right (homology distinct if any obstacle is in between) */
+    struct GuidancePaths
+    {
+        std::vector<Node> nodes;
+        GeometricPath left, right;
+
+        GuidancePaths()
+        {
+            const double length = Config::DT * Config::N * SyntheticScene::VELOCITY;
+            const double width = SyntheticScene::WIDTH;
+
+            nodes.reserve(4); // The paths point into the nodes
+            nodes.emplace_back(0, SpaceTimePoint(0., 0., 0.), NodeType::GUARD);
+            nodes.emplace_back(1, SpaceTimePoint(0.5 * length, width, (double)(Config::N / 2)), NodeType::GUARD);
+            nodes.emplace_back(2, SpaceTimePoint(0.5 * length, -width, (double)(Config::N / 2)), NodeType::GUARD);
+            nodes.emplace_back(3, SpaceTimePoint(length, 0., (double)Config::N), NodeType::GOAL);
+
+            left = GeometricPath({&nodes[0], &nodes[1], &nodes[3]});
+            right = GeometricPath({&nodes[0], &nodes[2], &nodes[3]});
+        }
+    };
+
+    /** @brief Through IsVisible(), which is the ray cast for the (non-gridded) Environment */
+    static void BM_IsVisibleRayCast(benchmark::State &bench)
+    {
+        guidanceConfig();
+        Environment environment;
+        environment.Init();
+        environment.LoadObstacles(guidanceObstacles(bench.range(0)), std::vector<Halfspace>{});
+
+        // Connections between random space-time points, as in the PRM
+        std::mt19937 rng(SyntheticScene::SEED);
+        std::uniform_real_distribution<double> x(0., SyntheticScene::LENGTH), y(-0.5 * SyntheticScene::WIDTH, 0.5 * SyntheticScene::WIDTH);
+        std::uniform_int_distribution<int> k(0, Config::N);
+
+        std::vector<std::pair<SpaceTimePoint, SpaceTimePoint>> connections;
+        for (int i = 0; i < 256; i++)
+        {
+            int k_start = k(rng), k_end = k(rng);
+            connections.emplace_back(SpaceTimePoint(x(rng), y(rng), (double)std::min(k_start, k_end)),
+                                     SpaceTimePoint(x(rng), y(rng), (double)std::max(k_start, k_end)));
+        }
+
+        size_t i = 0;
+        for (auto _ : bench)
+        {
+            benchmark::DoNotOptimize(environment.IsVisible(connections[i].first, connections[i].second));
+            i = (i + 1) % connections.size();
+        }
+    }
+
+    /** @brief Without the cache of H-values (cleared each cycle by the PRM), comparing over all obstacles */
+    static void BM_HomologyAreEquivalent(benchmark::State &bench)
+    {
+        guidanceConfig();
+        Environment environment;
+        environment.Init();
+        environment.LoadObstacles(guidanceObstacles(bench.range(0)), std::vector<Halfspace>{});
+
+        GuidancePaths paths;
+        Homology homology;
+        for (auto _ : bench)
+        {
+            homology.Clear();
+            benchmark::DoNotOptimize(homology.AreEquivalent(paths.left, paths.right, environment, true));
+        }
+    }
+
+    static void BM_PRMUpdate(benchmark::State &bench)
+    {
+        Config &config = guidanceConfig();
+
+        PRM prm;
+        prm.Init(&config);
+        prm.SetClock(std::make_shared<RosTools::VirtualClock>()); // Do not let the sampling time out: the same work each iteration
+
+        // Goals spread over the width of the road at the end of the horizon
+        const double length = Config::DT * Config::N * SyntheticScene::VELOCITY;
+        std::vector<Goal> goals;
+        for (double y = -2.; y <= 2.; y += 1.)
+            goals.emplace_back(Eigen::Vector2d(length, y), std::abs(y));
+
+        prm.LoadData(guidanceObstacles(bench.range(0)), std::vector<Halfspace>{}, Eigen::Vector2d::Zero(), 0.,
+                     Eigen::Vector2d(SyntheticScene::VELOCITY, 0.), goals);
+
+        for (auto _ : bench)
+            benchmark::DoNotOptimize(&prm.Update());
+
+        bench.counters["samples"] = config.n_samples_;
+    }
+
+    static void BM_CubicSplineOptimize(benchmark::State &bench)
+    {
+        Config &config = guidanceConfig();
+        ObstacleSnapshot obstacles = guidanceObstacles(bench.range(0));
+
+        GuidancePaths paths;
+        const CubicSpline3D initial(paths.left, &config, Eigen::Vector2d(SyntheticScene::VELOCITY, 0.));
+        CubicSpline3D spline;
+        for (auto _ : bench)
+        {
+            bench.PauseTiming(); // Optimize() modifies the spline
+            spline = initial;
+            bench.ResumeTiming();
+
+            spline.Optimize(*obstacles);
+            benchmark::ClobberMemory();
+        }
+    }
+
+    void registerGuidanceBenchmarks(const std::vector<int> &obstacle_counts)
+    {
+        withObstacleCounts(benchmark::RegisterBenchmark("Environment::IsVisibleRayCast", BM_IsVisibleRayCast), obstacle_counts)
+            ->Unit(benchmark::kNanosecond);
+        withObstacleCounts(benchmark::RegisterBenchmark("Homology::AreEquivalent", BM_HomologyAreEquivalent), obstacle_counts);
+        withObstacleCounts(benchmark::RegisterBenchmark("PRM::Update", BM_PRMUpdate), obstacle_counts);
+        withObstacleCounts(benchmark::RegisterBenchmark("CubicSpline3D::Optimize", BM_CubicSplineOptimize), obstacle_counts);
+    }
+}
@@ -0,0 +1,179 @@
+/** Microbenchmarks: obstacle preparation, the linearized collision constraints and a full solve of the MPC */
+#include "benchmarks.h"
+
+#include <mpc_planner/data_preparation.h>
+
+/** @note: Autogenerated */
+#include <mpc_planner_modules/modules.h>
+
+#include <mpc_planner_solver/solver_interface.h>
+#include <mpc_planner_solver/state.h>
+#include <mpc_planner_types/module_data.h>
+#include <mpc_planner_types/realtime_data.h>
+#include <mpc_planner_util/parameters.h>
+
+#include <ros_tools/clock.h>
+
+#include <algorithm>
+
+namespace MPCPlanner
+{
+    static State initialState()
+    {
+        State state;
+        state.set("x", 0.);
+        state.set("y", 0.);
+        state.set("psi", 0.);
+        state.set("v", SyntheticScene::VELOCITY);
+        state.set("spline", 0.);
+        return state;
+    }
+
+    /** @brief Obstacles with analytic constant velocity predictions, as delivered by the simulator (before ensureObstacleSize) */
+    static std::vector<DynamicObstacle> dynamicObstacles(int count)
+    {
+        const int N = CONFIG["N"].as<int>();
+        const double dt = CONFIG["integrator_step"].as<double>();
+
+        std::vector<DynamicObstacle> obstacles;
+        int index = 0;
+        for (auto &obstacle : generateObstacles(count))
+        {
+            obstacles.emplace_back(index++, obstacle.position, 0., obstacle.radius);
+            setConstantVelocityPrediction(obstacles.back().prediction, obstacle.position, obstacle.velocity, dt, N);
+        }
+        return obstacles;
+    }
+
+    static RealTimeData realTimeData(int num_obstacles, const State &state)
+    {
+        RealTimeData data;
+        data.robot_area = defineRobotArea(CONFIG["robot"]["length"].as<double>(), CONFIG["robot"]["width"].as<double>(),
+                                          CONFIG["n_discs"].as<int>());
+        data.past_trajectory = FixedSizeTrajectory(200);
+
+        generateReferencePath(data.reference_path.x, data.reference_path.y);
+        for (size_t i = 0; i < data.reference_path.x.size(); i++)
+        {
+            data.reference_path.psi.push_back(0.);
+            data.reference_path.v.push_back(SyntheticScene::VELOCITY);
+            data.reference_path.s.push_back(data.reference_path.x[i]);
+        }
+        data.goal = Eigen::Vector2d(SyntheticScene::LENGTH, 0.);
+        data.goal_received = true;
+
+        data.dynamic_obstacles = dynamicObstacles(num_obstacles);
+        ensureObstacleSize(data.dynamic_obstacles, state);
+        return data;
+    }
+
+    /** @brief Ranks (above max_obstacles) or pads (below) the obstacles and expands the predictions that are kept */
+    static void BM_EnsureObstacleSize(benchmark::State &bench)
+    {
+        State state = initialState();
+        const std::vector<DynamicObstacle> input = dynamicObstacles(bench.range(0));
+        std::vector<DynamicObstacle> obstacles;
+        for (auto _ : bench)
+        {
+            bench.PauseTiming();
+            obstacles = input;
+            bench.ResumeTiming();
+
+            ensureObstacleSize(obstacles, state);
+            benchmark::DoNotOptimize(obstacles.data());
+        }
+    }
+
+    /** @brief Shared by the benchmarks that need a solver: constructing it loads the generated solver */
+    static std::shared_ptr<Solver> &sharedSolver()
+    {
+        static std::shared_ptr<Solver> solver;
+        if (!solver)
+        {
+            solver = std::make_shared<Solver>();
+            solver->reset();
+            solver->setClock(std::make_shared<RosTools::VirtualClock>()); // The solver timeout never expires
+        }
+        return solver;
+    }
+
+    /** @brief Linearize all obstacles (not limited to max_obstacles) around the braking trajectory */
+    static void BM_LinearizedConstraintsUpdate(benchmark::State &bench)
+    {
+        const int num_obstacles = bench.range(0);
+        State state = initialState();
+        sharedSolver()->initializeWithBraking(state);
+
+        RealTimeData data;
+        data.robot_area = defineRobotArea(CONFIG["robot"]["length"].as<double>(), CONFIG["robot"]["width"].as<double>(),
+                                          CONFIG["n_discs"].as<int>());
+        data.dynamic_obstacles = dynamicObstacles(num_obstacles);
+        expandPredictions(data.dynamic_obstacles);
+
+        // Reserve constraints for all obstacles
+        const int max_obstacles = CONFIG["max_obstacles"].as<int>();
+        CONFIG["max_obstacles"] = std::max(max_obstacles, num_obstacles);
+        LinearizedConstraints module(sharedSolver());
+        CONFIG["max_obstacles"] = max_obstacles;
+
+        ModuleData module_data;
+        for (auto _ : bench)
+        {
+            module.update(state, data, module_data);
+            benchmark::ClobberMemory();
+        }
+    }
+
+    /** @brief One solve of the MPC as configured (all modules), from the same initial guess each iteration */
+    static void BM_SolverSolve(benchmark::State &bench)
+    {
+        State state = initialState();
+        RealTimeData data = realTimeData(bench.range(0), state);
+
+        std::vector<std::shared_ptr<ControllerModule>> modules;
+        initializeModules(modules, sharedSolver());
+        for (auto &module : modules)
+        {
+            module->onDataReceived(data, "reference_path");
+            module->onDataReceived(data, "dynamic obstacles");
+        }
+
+        // Prepare the problem as the planner does
+        ModuleData module_data;
+        sharedSolver()->initializeWithBraking(state);
+        sharedSolver()->setXinit(state);
+        for (auto &module : modules)
+            module->update(state, data, module_data);
+        for (int k = 0; k < sharedSolver()->N; k++)
+        {
+            for (auto &module : modules)
+                module->setParameters(data, module_data, k);
+        }
+        sharedSolver()->loadWarmstart();
+        sharedSolver()->_params.solver_timeout = 1.;
+
+        auto prepared = std::make_shared<Solver>(1);
+        *prepared = *sharedSolver();
+        int exit_flag = 0, failures = 0;
+        for (auto _ : bench)
+        {
+            bench.PauseTiming();
+            *sharedSolver() = *prepared;
+            bench.ResumeTiming();
+
+            exit_flag = sharedSolver()->solve();
+            failures += exit_flag != 1;
+        }
+
+        bench.counters["exit_flag"] = exit_flag;
+        bench.counters["failures"] = failures;
+    }
+
+    void registerModuleBenchmarks(const std::vector<int> &obstacle_counts)
+    {
+        withObstacleCounts(benchmark::RegisterBenchmark("ensureObstacleSize", BM_EnsureObstacleSize), obstacle_counts);
+        withObstacleCounts(benchmark::RegisterBenchmark("LinearizedConstraints::update", BM_LinearizedConstraintsUpdate), obstacle_counts);
+        withObstacleCounts(benchmark::RegisterBenchmark("Solver::solve", BM_SolverSolve), obstacle_counts)
+            ->Unit(benchmark::kMillisecond);
+    }
+}
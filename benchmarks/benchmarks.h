@@ -0,0 +1,54 @@
+#ifndef MPC_PLANNER_BENCHMARKS_H
+#define MPC_PLANNER_BENCHMARKS_H
+
+#include <benchmark/benchmark.h>
+
+#include <Eigen/Dense>
+
+#include <vector>
+
+/**
+ * Microbenchmarks of the planner kernels (Google Benchmark) on synthetic, seeded scenes: the robot starts in the
+ * origin heading along x over a straight reference path, with obstacles scattered (and moving) ahead of it.
+ * Benchmarks that scale with the number of obstacles are registered once per obstacle count (see main.cpp).
+ */
+
+namespace MPCPlanner
+{
+    struct SyntheticObstacle
+    {
+        Eigen::Vector2d position;
+        Eigen::Vector2d velocity;
+        double radius;
+    };
+
+    /** @brief Dimensions of the synthetic scene */
+    struct SyntheticScene
+    {
+        static constexpr double LENGTH = 30.;     // [m] Length of the reference path
+        static constexpr double WIDTH = 8.;       // [m] Obstacles are placed within [-WIDTH / 2, WIDTH / 2] of the path
+        static constexpr double VELOCITY = 1.5;   // [m/s] Initial (and reference) velocity of the robot
+        static constexpr int PATH_POINTS = 200;   // Points of the reference path
+        static constexpr unsigned int SEED = 1;
+    };
+
+    /** @brief The same obstacles for the same count and seed, such that all kernels see the same scene */
+    std::vector<SyntheticObstacle> generateObstacles(int count, unsigned int seed = SyntheticScene::SEED);
+
+    /** @brief Waypoints of the straight reference path (x, y) */
+    void generateReferencePath(std::vector<double> &x, std::vector<double> &y, int points = SyntheticScene::PATH_POINTS);
+
+    /** @brief Register a benchmark for each obstacle count */
+    inline benchmark::internal::Benchmark *withObstacleCounts(benchmark::internal::Benchmark *bm, const std::vector<int> &obstacle_counts)
+    {
+        for (int count : obstacle_counts)
+            bm->Arg(count);
+        return bm->ArgName("obstacles")->Unit(benchmark::kMicrosecond);
+    }
+
+    void registerGeometryBenchmarks(const std::vector<int> &obstacle_counts);
+    void registerGuidanceBenchmarks(const std::vector<int> &obstacle_counts);
+    void registerModuleBenchmarks(const std::vector<int> &obstacle_counts);
+}
+
+#endif // MPC_PLANNER_BENCHMARKS_H
@@ -0,0 +1,111 @@
+/**
+ * Microbenchmarks of the planner kernels on synthetic scenes (Google Benchmark), without ROS, a GPU or network access.
+ * Built when configured with -DBUILD_BENCHMARKS=ON.
+ * Run from the repository root (the guidance planner loads guidance_planner/config/params.yaml relative to it).
+ *
+ * Usage: mpc_planner_benchmarks [--config <dir>] [--obstacles <n,n,...>] [--benchmark_* options]
+ *  --config:    directory with settings.yaml (default: mpc_planner_jackalsimulator/config)
+ *  --obstacles: obstacle counts of the benchmarks that scale with the number of obstacles (default: 1,4,16,64,128)
+ *
+ * For example, to compare the kernels without the solver between two builds:
+ *  mpc_planner_benchmarks --benchmark_filter=-Solver --benchmark_out=kernels.json --benchmark_out_format=json
+ */
+#include "benchmarks.h"
+
+#include <mpc_planner_util/parameters.h>
+
+#include <ros_tools/random_generator.h>
+
+#include <filesystem>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+
+namespace fs = std::filesystem;
+
+namespace MPCPlanner
+{
+    std::vector<SyntheticObstacle> generateObstacles(int count, unsigned int seed)
+    {
+        std::mt19937 rng(seed);
+        std::uniform_real_distribution<double> x(2., SyntheticScene::LENGTH), y(-0.5 * SyntheticScene::WIDTH, 0.5 * SyntheticScene::WIDTH);
+        std::uniform_real_distribution<double> velocity(-1., 1.), radius(0.3, 0.6);
+
+        std::vector<SyntheticObstacle> obstacles(count);
+        for (auto &obstacle : obstacles)
+        {
+            obstacle.position = Eigen::Vector2d(x(rng), y(rng));
+            obstacle.velocity = Eigen::Vector2d(velocity(rng), velocity(rng));
+            obstacle.radius = radius(rng);
+        }
+        return obstacles;
+    }
+
+    void generateReferencePath(std::vector<double> &x, std::vector<double> &y, int points)
+    {
+        x.resize(points);
+        y.resize(points);
+        for (int i = 0; i < points; i++)
+        {
+            x[i] = SyntheticScene::LENGTH * i / (double)(points - 1);
+            y[i] = 0.;
+        }
+    }
+}
+
+static std::vector<int> parseCounts(const std::string &list)
+{
+    std::vector<int> counts;
+    std::stringstream stream(list);
+    std::string count;
+    while (std::getline(stream, count, ','))
+        counts.push_back(std::stoi(count));
+    return counts;
+}
+
+int main(int argc, char **argv)
+{
+    // Removes the --benchmark_* options
+    benchmark::Initialize(&argc, argv);
+
+    fs::path config_path = "mpc_planner_jackalsimulator/config";
+    std::vector<int> obstacle_counts = {1, 4, 16, 64, 128};
+    for (int i = 1; i < argc; i += 2)
+    {
+        std::string option = argv[i];
+        if (i + 1 >= argc)
+        {
+            std::cerr << "Missing value for " << option << "\n";
+            return 1;
+        }
+
+        if (option == "--config")
+            config_path = argv[i + 1];
+        else if (option == "--obstacles")
+            obstacle_counts = parseCounts(argv[i + 1]);
+        else
+        {
+            std::cerr << "Unknown option: " << option << "\n";
+            return 1;
+        }
+    }
+
+    if (fs::is_directory(config_path))
+        config_path /= "settings.yaml";
+    if (!fs::exists(config_path))
+    {
+        std::cerr << "Config file not found: " << config_path << "\n";
+        return 1;
+    }
+    Configuration::getInstance().initialize(config_path.string());
+    RosTools::RandomGenerator::setDefaultSeed(1);
+
+    MPCPlanner::registerGeometryBenchmarks(obstacle_counts);
+    MPCPlanner::registerGuidanceBenchmarks(obstacle_counts);
+    MPCPlanner::registerModuleBenchmarks(obstacle_counts);
+
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
@@ -71,6 +71,7 @@ namespace GuidancePlanner
 
     // Sampling parameters
     double sample_margin_;
+    double cull_margin_; // Obstacles further than this from the sampling region are not loaded
 
     // Weights (deprecated, only here so that cubicspline3d still compiles)
     double geometric_weight_, smoothness_weight_, collision_weight_, velocity_tracking_;
@@ -91,6 +92,7 @@ namespace GuidancePlanner
     bool visualize_all_samples_, visualize_homology_;
     bool dynamically_propagate_nodes_;
     bool project_from_obstacles_;
+    bool cull_obstacles_;
     bool debug_continuous_replanning_;
   };
 }
@@ -195,6 +195,8 @@ namespace GuidancePlanner
         void Visualize();
 
     private:
+        friend struct CubicSpline3DAccess; // Tests compare Optimize() against a dense reference
+
         // Spline in 3D
         tk::spline x_;
         tk::spline y_;
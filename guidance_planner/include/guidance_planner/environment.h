@@ -36,7 +36,8 @@ namespace GuidancePlanner
     virtual void Init();
 
   public:
-    virtual void LoadObstacles(const std::vector<Obstacle> &dynamic_obstacles, const std::vector<Halfspace> &static_obstacles);
+    /** @brief Keeps a reference to the obstacle snapshot (no copy) */
+    virtual void LoadObstacles(const ObstacleSnapshot &dynamic_obstacles, const std::vector<Halfspace> &static_obstacles);
     virtual void SetPosition(const Eigen::Vector2d &pos) { (void)pos; };
 
     /** @brief Check if a point is in collision */
@@ -53,12 +54,33 @@ namespace GuidancePlanner
     /** @brief Only for dynamic obstacles and deprecated. 2-D version of IsVisibility for a particular time */
     virtual bool IsVisible2D(const SpaceTimePoint &point_one, const SpaceTimePoint &point_two);
 
-    virtual std::vector<Obstacle> &GetDynamicObstacles() { return dynamic_obstacles_; };
+    virtual const std::vector<Obstacle> &GetDynamicObstacles() { return *dynamic_obstacles_; };
+
+    /** @brief Static obstacles are vertical cylinders in 2D x [0, T], such that their 2D circles suffice */
+    struct StaticCircle
+    {
+      Eigen::Vector2d position;
+      double radius;
+
+      StaticCircle(const Eigen::Vector2d &pos, const double r) : position(pos), radius(r) {}
+
+      bool operator==(const StaticCircle &other) const { return position == other.position && radius == other.radius; }
+    };
+
+    const std::vector<StaticCircle> &GetStaticCircles() const { return static_circles_; };
 
   protected:
-    std::vector<Obstacle> dynamic_obstacles_;
+    ObstacleSnapshot dynamic_obstacles_{std::make_shared<const std::vector<Obstacle>>()}; // All obstacles (static obstacles are flagged with is_static_)
     std::vector<Halfspace> static_obstacles_;
 
+    std::vector<StaticCircle> static_circles_; // Cached over cycles, only rebuilt when the static obstacles change
+
+    /** @brief Rebuild the static circles from the loaded obstacles if they changed. Returns true if they changed */
+    bool UpdateStaticCircles();
+
+    /** @brief Check if the 2D projection of a line stays clear of all static obstacles */
+    bool IsVisibleStatic(const Eigen::Vector2d &point_one, const Eigen::Vector2d &point_two) const;
+
     /** @brief Various implementations of visibility checks */
     virtual bool IsVisibleRayCast(const SpaceTimePoint &point_one, const SpaceTimePoint &point_two); // Fast for constant velocity prediction
     virtual bool IsVisibleRaySampling(const SpaceTimePoint &point_one, const SpaceTimePoint &point_two);
@@ -69,7 +91,7 @@ namespace GuidancePlanner
   public:
     virtual void Init() override;
     virtual void SetPosition(const Eigen::Vector2d &pos) override { grid_.SetOrigin(pos); };
-    virtual void LoadObstacles(const std::vector<Obstacle> &dynamic_obstacles,
+    virtual void LoadObstacles(const ObstacleSnapshot &dynamic_obstacles,
                                const std::vector<Halfspace> &static_obstacles) override;
 
     virtual bool InCollision(const SpaceTimePoint &point, double with_margin = 0.) override;
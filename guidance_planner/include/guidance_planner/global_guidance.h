@@ -6,6 +6,8 @@
 
 #include <guidance_planner/types/types.h>
 
+#include <ros_tools/data_recorder.h>
+
 namespace RosTools
 {
   class DataSaver;
@@ -38,6 +40,19 @@ namespace GuidancePlanner
 
     /** @brief Load the obstacles to be used in the PRM, each obstacle needs to have at least the current position and N future predicted positions */
     void LoadObstacles(const std::vector<Obstacle> &obstacles, const std::vector<Halfspace> &static_obstacles);
+
+    /** @brief Load obstacles without copying them, they become the (immutable) obstacle snapshot of this cycle */
+    void LoadObstacles(std::vector<Obstacle> &&obstacles, const std::vector<Halfspace> &static_obstacles);
+
+    /**
+     * @brief Load obstacles by swapping them into the snapshot of this cycle. `obstacles` receives the storage of an earlier
+     * snapshot that is no longer in use, such that the caller can refill it in the next cycle without allocating
+     */
+    void SwapObstacles(std::vector<Obstacle> &obstacles, const std::vector<Halfspace> &static_obstacles);
+
+    /** @brief The obstacles of this cycle, with their predictions extended to the horizon */
+    ObstacleSnapshot GetObstacles() const { return obstacles_; };
+
     void LoadStaticObstacles(const std::vector<Halfspace> &static_obstacles);
 
     // Supply the reference path, but do not sample goals from it
@@ -56,6 +71,7 @@ namespace GuidancePlanner
     void SetTrackOnlyTheSelectedHomology() { config_->track_selected_homology_only_ = true; }
     void SetPlanningFrequency(double f) { config_->CONTROL_DT = 1. / f; }
     void DoNotPropagateNodes() { prm_.DoNotPropagateNodes(); }
+    void SetClock(std::shared_ptr<RosTools::Clock> clock) { prm_.SetClock(clock); } /** @brief Clock of the PRM timeout */
 
     /**
      * @brief Compute Guidance trajectories
@@ -82,6 +98,16 @@ namespace GuidancePlanner
       static OutputTrajectory &Empty(const Eigen::Vector2d &start, Config *config);
     };
 
+    /** @brief Statistics of the obstacle relevance culling in the last update */
+    struct CullStatistics
+    {
+      int loaded{0};   // Obstacles that were loaded
+      int relevant{0}; // Obstacles whose prediction comes near the sampling region
+      int culled{0};   // Obstacles that were ignored
+    };
+
+    const CullStatistics &GetCullStatistics() const { return cull_statistics_; }
+
     /** @brief Returns how many guidance trajectories were found */
     int NumberOfGuidanceTrajectories() const;
 
@@ -127,6 +153,10 @@ namespace GuidancePlanner
     /** @brief Export data for external analysis */
     void saveData(RosTools::DataSaver &data_saver);
 
+    /** @brief Register the recorded columns once, then record each cycle (binary recorder) */
+    void addColumns(RosTools::DataRecorder &recorder);
+    void saveData(RosTools::DataRecorder &recorder);
+
     Config *GetConfig() const { return config_.get(); };
 
     SpaceTimePoint::TVector GetStart() const { return prm_.GetStart(); };         /** @brief Get the start position */
@@ -142,6 +172,18 @@ namespace GuidancePlanner
 
     double PathSelectionCost(const GeometricPath &path);
 
+    /** @brief Define the sampling region as the segment [s_start, s_end] of the reference path with the road width */
+    void SetSamplingRegion(const std::shared_ptr<RosTools::Spline2D> &reference_path, double s_start, double s_end,
+                           double road_width_left, double road_width_right);
+
+    /** @brief A buffer of `buffers` that is no longer shared and can be refilled (a new one if both are still in use) */
+    static std::shared_ptr<std::vector<Obstacle>> *GetUnsharedBuffer(std::shared_ptr<std::vector<Obstacle>> (&buffers)[2],
+                                                                     const ObstacleSnapshot &current);
+
+    /** @brief Keep only the obstacles whose swept prediction comes near the sampling region */
+    void CullObstacles();
+    bool IsRelevant(const Obstacle &obstacle) const;
+
     /** Visualization functions */
     void VisualizeGeometricPaths(int path_nr = -1);
     void VisualizeTrajectories(bool highlight_selected = true, int path_nr = -1);
@@ -152,6 +194,9 @@ namespace GuidancePlanner
   private:
     std::shared_ptr<Config> config_; // Owns the configuration
 
+    RosTools::BenchmarkerHandle guidance_benchmarker_, prm_benchmarker_, processing_benchmarker_;
+    RosTools::ColumnHandle prm_runtime_column_, processing_runtime_column_, relevant_obstacles_column_, culled_obstacles_column_;
+
     PRM prm_;
     GraphSearch graph_search_;
     // LearningGuidance learning_guidance_; /** @note Learning disabled */
@@ -169,8 +214,17 @@ namespace GuidancePlanner
     std::unique_ptr<ColorManager> color_manager_;
 
     // Real-time data
-    std::vector<Obstacle> obstacles_;
+    ObstacleSnapshot obstacles_{std::make_shared<const std::vector<Obstacle>>()};
+    ObstacleSnapshot relevant_obstacles_{std::make_shared<const std::vector<Obstacle>>()}; // Obstacles used in the update (after culling)
     std::vector<Halfspace> static_obstacles_;
+    std::shared_ptr<std::vector<Obstacle>> obstacle_buffers_[2]; // Storage of the snapshots, reused once no longer shared
+    std::shared_ptr<std::vector<Obstacle>> relevant_buffers_[2]; // Storage of the culled snapshots
+    std::vector<Obstacle> spare_obstacles_;                      // Culled obstacles that are kept for their storage
+
+    std::vector<double> sampling_region_s_;         // Path parameters of the centerline points
+    std::vector<Eigen::Vector2d> sampling_region_; // Centerline of the sampled reference path segment (empty: sample between the goals)
+    double sampling_region_width_{0.};
+    CullStatistics cull_statistics_;
 
     Eigen::Vector2d start_;
     bool goals_set_ = false;
@@ -4,17 +4,22 @@
 #include <guidance_planner/config.h>
 #include <guidance_planner/types/type_define.h>
 #include <guidance_planner/types/space_time_point.h>
+#include <guidance_planner/types/node.h>
+#include <guidance_planner/types/connection.h>
 
 #include <string>
 #include <vector>
-#include <list>
 #include <Eigen/Dense>
 
 namespace GuidancePlanner
 {
-  class Node;
   class Goal;
-  /** @brief The Visibility-PRM Graph */
+  /**
+   * @brief The Visibility-PRM Graph
+   *
+   * @note Nodes and edges are stored in flat arrays and referred to by integer handles (their index). Storage is reserved
+   * for the maximum number of nodes in Initialize, so that pointers to nodes remain valid while the graph is constructed.
+   */
   class Graph
   {
   public:
@@ -23,8 +28,8 @@ namespace GuidancePlanner
     Graph(const Graph &other) = delete; // No copying allowed
 
   public:
-    Node *start_node_;
-    std::vector<Node *> goal_nodes_;
+    int start_node_;
+    std::vector<int> goal_nodes_;
     Config *config_;
 
     /** @brief Initialize the graph with a start and goal */
@@ -32,17 +37,32 @@ namespace GuidancePlanner
     void Initialize(const SpaceTimePoint::TVector &start, std::vector<Goal> &goals);
 
     /**
-     * @brief Adds a node to the graph and returns a pointer to the node in the new list
+     * @brief Adds a node to the graph and returns its handle
      */
-    Node *AddNode(const Node &node);
+    int AddNode(const Node &node);
+
+    /** @brief Connect nodes a and b with an edge (directed forward in time) and return the handle of the edge */
+    int AddEdge(int a, int b);
+
+    /** @brief Replace the neighbour of node by new_neighbour (connecting both) and mark the old neighbour as replaced */
+    bool ReplaceNeighbour(int node, int neighbour_to_replace, int new_neighbour);
+
+    Node &GetNode(int handle) { return nodes_[handle]; }
+    const Node &GetNode(int handle) const { return nodes_[handle]; }
+
+    const Connection &GetEdge(int handle) const { return edges_[handle]; }
+    const std::vector<Connection> &GetEdges() const { return edges_; }
+
+    /** @brief Handles of all guards in the graph (including the start) */
+    const std::vector<int> &GetGuards() const { return guards_; }
 
     /**
      * @brief Get a list of nodes that are neighbours of both nodes in the input list
      *
      * @param nodes A list of two nodes, that must both be guards
-     * @return std::vector<Node *> A list of shared neighbours
+     * @return std::vector<int> A list of shared neighbours
      */
-    std::vector<Node *> GetSharedNeighbours(const std::vector<Node *> &nodes);
+    std::vector<int> GetSharedNeighbours(const std::vector<int> &nodes) const;
 
     int GetNodeID();
 
@@ -51,10 +71,15 @@ namespace GuidancePlanner
     void Clear();
     void Print();
 
-    std::list<Node> nodes_; // @note std::list instead of std::vector to ensure that pointers remain valid
+    std::vector<Node> nodes_; // @note Contiguous, capacity is reserved in Initialize so that pointers remain valid
 
   private:
+    std::vector<Connection> edges_;
+    std::vector<int> guards_;
+
     int current_id_ = 0;
+
+    void Reserve(int num_goals);
   };
 
 } // namespace Homotopy
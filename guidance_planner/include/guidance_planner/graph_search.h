@@ -16,10 +16,18 @@ namespace GuidancePlanner
 
     public:
         GraphSearch();
-        void Search(const Graph &graph, unsigned int max_paths, std::vector<Node *> &L, std::vector<GeometricPath> &T, const Node *goal);
+        /**
+         * @brief Depth-first search for paths from the last node in L to the goal
+         *
+         * @param L Handles of the visited nodes (initially only the start)
+         * @param E Handles of the edges between the visited nodes (initially empty)
+         * @param T Found paths
+         * @param goal Handle of the goal node
+         */
+        void Search(const Graph &graph, unsigned int max_paths, std::vector<int> &L, std::vector<int> &E, std::vector<GeometricPath> &T, int goal);
 
     private:
-        bool HasBeenVisited(const std::vector<Node *> &L, const Node *node);
+        bool HasBeenVisited(const std::vector<int> &L, int node);
     };
 }
 #endif // __GRAPH_SEARCH_H__
\ No newline at end of file
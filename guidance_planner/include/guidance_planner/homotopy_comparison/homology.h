@@ -64,7 +64,13 @@ namespace GuidancePlanner
 
   private:
     /** @brief Integrate the H-value over a geometric path (with cached values) */
-    double PathHValue(const GeometricPath &path, std::vector<double> &cached_h, const int obstacle_id);
+    double PathHValue(const GeometricPath &path, std::vector<double> &cached_h, const Obstacle &obstacle, const int obstacle_id);
+
+    /** @brief H-value of a straight line from start to end around the loaded obstacle */
+    double LineHValue(const SpaceTimePoint &start, const SpaceTimePoint &end, const Obstacle &obstacle, int thread_id = 0);
+
+    /** @brief Closed-form H-value of a straight line around a static (vertical) obstacle: the angle it sweeps in revolutions */
+    static double StaticLineHValue(const Eigen::Vector2d &center, const Eigen::Vector2d &start, const Eigen::Vector2d &end);
 
     /** @brief Integrate the H-value in a point over an obstacle */
     double ObstacleHValue(const Eigen::Vector3d &r, const Eigen::Vector3d &dr);
@@ -17,6 +17,7 @@
 
 #include <guidance_planner/types/paths.h>
 
+#include <ros_tools/profiling.h>
 #include <ros_tools/random_generator.h>
 
 namespace RosTools
@@ -58,7 +59,7 @@ namespace GuidancePlanner
      * @param velocity The start velocity
      * @param goal Goal positions organized with the furthest away goal at the end of the vector
      */
-    void LoadData(const std::vector<Obstacle> &obstacles, const std::vector<Halfspace> &static_obstacles, const Eigen::Vector2d &start, const double orientation,
+    void LoadData(const ObstacleSnapshot &obstacles, const std::vector<Halfspace> &static_obstacles, const Eigen::Vector2d &start, const double orientation,
                   const Eigen::Vector2d &velocity, const std::vector<Goal> &goals);
 
     /** @brief Load the reference path to sample along it */
@@ -71,6 +72,9 @@ namespace GuidancePlanner
       do_not_propagate_nodes_ = true;
     };
 
+    /** @brief Clock of the sampling timeout (nullptr: the default clock) */
+    void SetClock(std::shared_ptr<RosTools::Clock> clock) { clock_ = clock; }
+
     /** @brief Propagate the graph to the next iteration by lowering the time axis */
     void PropagateGraph(const std::vector<GeometricPath> &paths);
 
@@ -103,14 +107,14 @@ namespace GuidancePlanner
   private:
     void SampleNewPoints();
 
-    void FindVisibleGuards(SpaceTimePoint sample, std::vector<Node *> &visible_guards);
+    void FindVisibleGuards(SpaceTimePoint sample, std::vector<int> &visible_guards);
     bool IsGoalVisible(SpaceTimePoint sample, int goal_index) const;
-    Node *CheckGoalConnection(Node &new_node, Node *guard, Node *goal) const;
+    bool CheckGoalConnection(Node &new_node, int guard, int goal) const;
 
-    void AddSample(int i, SpaceTimePoint &sample, const std::vector<Node *> guards, bool sample_is_from_previous_iteration);
+    void AddSample(int i, SpaceTimePoint &sample, const std::vector<int> &guards, bool sample_is_from_previous_iteration);
     void AddGuard(int i, SpaceTimePoint &sample);
-    void AddNewConnector(Node &new_node, const std::vector<Node *> &visible_guards);
-    void ReplaceConnector(Node &new_node, Node *neighbour, const std::vector<Node *> &visible_guards);
+    void AddNewConnector(Node &new_node, const std::vector<int> &visible_guards);
+    void ReplaceConnector(Node &new_node, int neighbour, const std::vector<int> &visible_guards);
 
     /** @brief Propagate a node from this PRM instance "t" to the next instance "t+1". Specify a path if the node belonged to a path*/
     void PropagateNode(const Node &node, const GeometricPath *path = nullptr);
@@ -126,6 +130,9 @@ namespace GuidancePlanner
     bool do_not_propagate_nodes_{false};
 
     Config *config_;
+    std::shared_ptr<RosTools::Clock> clock_;
+
+    RosTools::BenchmarkerHandle homotopy_benchmarker_; // Timed in parallel (per thread)
 
     std::unique_ptr<Graph> graph_;                            // PRM Graph
     std::unique_ptr<HomotopyComparison> topology_comparison_; // H-invariant or UVD comparison
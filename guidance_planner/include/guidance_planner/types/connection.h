@@ -7,85 +7,57 @@
 
 namespace GuidancePlanner
 {
+    class Config;
 
-    /** @brief Connect two points with a steering function */
-    class Connection
+    /** @brief Defines the steering function of a Connection */
+    enum class ConnectionType
     {
-    public:
-        Connection(Node *a, Node *b);
-
-        Connection(const Connection &other)
-        {
-            a_ = other.getStart();
-            b_ = other.getEnd();
-        }
-
-        // Define the copy assignment operator
-        Connection &operator=(const Connection &other)
-        {
-            if (this != &other)
-            {
-                // Copy assign each member appropriately
-                this->a_ = other.getStart();
-                this->b_ = other.getEnd();
-                // Add copying logic for other members
-            }
-            return *this;
-        }
-
-    public:
-        virtual SpaceTimePoint operator()(double s) const = 0;
-
-        virtual bool isValid(Config *config, double orientation) const;
-        virtual void getIntegrationNodes(bool is_first, std::vector<SpaceTimePoint> &nodes) const;
-
-        virtual double length() const = 0;
-        virtual double lengthWithTime() const = 0;
-
-        Node *getStart() const { return a_; }
-        Node *getEnd() const { return b_; }
-
-    protected:
-        Node *a_;
-        Node *b_;
+        STRAIGHT = 0,
+        DUBINS = 1
     };
 
-    class StraightConnection : public Connection
+    /**
+     * @brief Connect two points with a steering function
+     *
+     * @note Connections are small value types (no virtual dispatch, no heap allocations) so that they can be stored in flat arrays
+     * by the graph and by paths, and copied cheaply.
+     */
+    class Connection
     {
     public:
-        StraightConnection(Node *a, Node *b);
+        /** @brief Connect a to b with the steering function selected in the configuration (Config::use_dubins_path_) */
+        Connection(const Node *a, const Node *b);
 
-        StraightConnection(const StraightConnection &other)
-            : Connection(other){};
-
-        SpaceTimePoint operator()(double s) const override;
-        double length() const override;
-        double lengthWithTime() const override;
-    };
-
-    class DubinsConnection : public Connection
-    {
     public:
-        DubinsConnection(Node *a, Node *b);
+        SpaceTimePoint operator()(double s) const;
 
-        DubinsConnection(const DubinsConnection &other) = default;
+        bool isValid(Config *config, double orientation) const;
+        void getIntegrationNodes(bool is_first, std::vector<SpaceTimePoint> &nodes) const;
 
-    public:
-        SpaceTimePoint operator()(double s) const override;
-        double length() const override;
-        double lengthWithTime() const override;
+        double length() const { return length_; }
+        double lengthWithTime() const { return length_with_time_; }
 
-        virtual bool isValid(Config *config, double orientation) const override;
-        virtual void getIntegrationNodes(bool is_first, std::vector<SpaceTimePoint> &nodes) const override;
+        const Node *getStart() const { return a_; }
+        const Node *getEnd() const { return b_; }
+
+        /** @brief Point this connection to other nodes with the same state (e.g., copies of its end points) */
+        void Rebind(const Node *a, const Node *b);
 
     private:
-        DubinsPath path_;
-        std::vector<SpaceTimePoint> sampled_path_;
+        const Node *a_;
+        const Node *b_;
+
+        ConnectionType type_;
 
-        bool valid_{false};
+        DubinsPath path_; // Only used for Dubins connections
+
+        bool valid_{true};
         double length_{0.0};
         double length_with_time_{0.0};
+
+        void InitializeDubins();
+        SpaceTimePoint SampleDubins(double s) const;
     };
 } // namespace GuidancePlanner
 
-#endif // __CONNECTION_H__
\ No newline at end of file
+#endif // __CONNECTION_H__
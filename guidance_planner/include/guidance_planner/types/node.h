@@ -31,14 +31,14 @@ namespace GuidancePlanner
 
         int belongs_to_path_ = -1; /** @note Set a posteriori for visualization */
 
-        std::vector<Node *> neighbours_; // Neighbouring nodes
+        std::vector<int> neighbours_; // Handles of neighbouring nodes in the graph
+        std::vector<int> edges_;      // Handles of the edges to these neighbours (same order)
 
         Node(int id, const SpaceTimePoint &point, const NodeType &node_type);
 
+        /** @brief Copy the state of another node under a new id (without its graph connectivity) */
         Node(int id, const Node &other);
 
-        bool ReplaceNeighbour(Node *node_to_replace, Node *new_node);
-
         double DistanceTo(const Node &other);
 
         friend bool operator==(const Node &lhs, const Node &rhs);
@@ -4,37 +4,44 @@
 #include <guidance_planner/types/types.h>
 #include <guidance_planner/types/connection.h>
 
-#include <memory>
-#include <list>
+#include <vector>
 
 namespace GuidancePlanner
 {
 
-  /** @brief A path that connects several nodes */
+  class Graph;
+
+  /**
+   * @brief A path that connects several nodes
+   *
+   * @note Paths found in the graph refer to the edges of the graph by handle, other paths own their (few) connections
+   */
   struct GeometricPath
   {
     GeometricPath()
     {
     }
     /** @brief Convert a vector of nodes to a path directly */
-    GeometricPath(const std::vector<Node *> &nodes);
+    GeometricPath(const std::vector<const Node *> &nodes);
 
-    GeometricPath(const GeometricPath &other)
-    {
-      connections_ = other.GetConnections();
-      ComputeDistanceVector();
-    }
-    GeometricPath &operator=(const GeometricPath &other)
-    {
-      connections_ = other.GetConnections();
-      ComputeDistanceVector();
-      return *this;
-    }
+    /** @brief Construct a path from consecutive edges of the graph (the graph must outlive this path) */
+    GeometricPath(const Graph &graph, const std::vector<int> &edges);
 
     /** @brief Evaluate this path at 0 <= s <= 1
      *  @return Interpolated point in discrete time space (i.e., k in [0, N]) */
     SpaceTimePoint operator()(double s) const;
 
+    /**
+     * @brief Evaluate this path where it reaches time index k (i.e., invert its time coordinate)
+     *
+     * @note Time is monotone over the path and linear in the distance along each connection, such that the node times form an
+     * exact lookup table. Queries with increasing k are O(1) amortized by reusing the cursor.
+     *
+     * @param k Time index to find (clamped to the time range of the path)
+     * @param cursor Connection to start the search from (initially 0), set to the connection containing k
+     */
+    SpaceTimePoint AtTime(double k, size_t &cursor) const;
+
     bool isValid(Config *config, const Eigen::Vector2d &start_velocity, double start_orientation);
 
     std::vector<Eigen::Vector2d> GetKParameterized() const;
@@ -53,11 +60,13 @@ namespace GuidancePlanner
     /** @brief Loop through nodes, get the highest "k" */
     double EndTimeIndex() const;
 
-    Node *GetStart() const;
-    Node *GetEnd() const;
+    const Node *GetStart() const;
+    const Node *GetEnd() const;
 
-    const std::vector<std::shared_ptr<Connection>> &GetConnections() const { return connections_; }
-    std::vector<Node *> GetNodes() const;
+    size_t NumConnections() const { return graph_edges_ != nullptr ? edges_.size() : connections_.size(); }
+    const Connection &GetConnection(size_t i) const { return graph_edges_ != nullptr ? (*graph_edges_)[edges_[i]] : connections_[i]; }
+
+    std::vector<const Node *> GetNodes() const;
     std::vector<SpaceTimePoint> GetIntegrationNodes() const;
 
     /** @brief Return this path as a vector of Eigen::Vector3d */
@@ -74,27 +83,41 @@ namespace GuidancePlanner
 
     void ComputeDistanceVector();
 
-    std::vector<std::shared_ptr<Connection>> connections_;
+    const std::vector<Connection> *graph_edges_{nullptr}; // Edges of the graph that this path was found in
+    std::vector<int> edges_;                              // Handles of the edges of this path (if found in a graph)
+    std::vector<Connection> connections_;                 // Connections of this path (if not found in a graph)
+
     bool validity_checked_{false};
     bool valid_{false};
+
+    friend struct StandaloneGeometricPath;
   };
 
   bool operator==(const GeometricPath &a, const GeometricPath &b);
 
+  /** @brief A path that owns copies of its nodes, so that it remains valid after the graph is cleared */
   struct StandaloneGeometricPath
   {
     GeometricPath path;
-    std::list<Node> saved_nodes_;
+    std::vector<Node> saved_nodes_;
 
     StandaloneGeometricPath()
     {
     }
 
-    StandaloneGeometricPath(const std::list<Node> &nodes);
+    StandaloneGeometricPath(const std::vector<Node> &nodes);
     StandaloneGeometricPath(const GeometricPath &other);
 
+    StandaloneGeometricPath(const StandaloneGeometricPath &other);
+    StandaloneGeometricPath &operator=(const StandaloneGeometricPath &other);
+
     // To cast to a GeometricPath
-    operator GeometricPath &();
+    operator GeometricPath &() { return path; }
+    operator const GeometricPath &() const { return path; }
+
+  private:
+    /** @brief Point the connections of the path to the saved nodes */
+    void BindToSavedNodes();
   };
 
   class IDAssigner
@@ -120,8 +143,9 @@ namespace std
     size_t operator()(const GuidancePlanner::GeometricPath &x) const
     {
       size_t seed = 0;
-      for (auto &node : x.GetNodes()) // We hash the IDs of the nodes in this path
+      for (size_t i = 0; i <= x.NumConnections(); i++) // We hash the IDs of the nodes in this path
       {
+        const GuidancePlanner::Node *node = i < x.NumConnections() ? x.GetConnection(i).getStart() : x.GetEnd();
         int hash_id = node->type_ == GuidancePlanner::NodeType::GOAL ? -10 : node->id_;
 
         seed ^= (uint32_t)(hash_id) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
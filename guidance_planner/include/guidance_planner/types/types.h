@@ -20,6 +20,7 @@
 
 #include <Eigen/Dense>
 
+#include <memory>
 #include <vector>
 
 namespace GuidancePlanner
@@ -71,10 +72,18 @@ namespace GuidancePlanner
         std::vector<Eigen::Vector2d> positions_;
         double radius_;
 
+        bool is_static_{false}; /** Static obstacles occupy the same 2D circle over the entire horizon */
+
         Obstacle(int id, const Eigen::Vector2d &pos, const Eigen::Vector2d &velocity, double dt, int N, double radius);
-        Obstacle(int id, const std::vector<Eigen::Vector2d> &positions, double radius);
+        Obstacle(int id, std::vector<Eigen::Vector2d> positions, double radius, bool is_static = false);
+
+        /** @brief True if the prediction does not move (e.g., a zero-velocity prediction) */
+        bool HasStaticPrediction() const;
     };
 
+    /** @brief Obstacles of one planning cycle. Immutable, such that all components (and threads) can share them without copies */
+    typedef std::shared_ptr<const std::vector<Obstacle>> ObstacleSnapshot;
+
     struct Goal
     {
         Node *node = nullptr;
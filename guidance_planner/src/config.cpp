@@ -68,6 +68,7 @@ namespace GuidancePlanner
     n_samples_ = gp["sampling"]["n_samples"].as<int>(50);
     timeout_ = gp["sampling"]["timeout"].as<double>(10.0);
     sample_margin_ = gp["sampling"]["margin"].as<double>(0.0);
+    cull_margin_ = gp["sampling"]["cull_margin"].as<double>(1.0);
 
     // Homotopy settings
     n_paths_ = gp["homotopy"]["n_paths"].as<int>(4);
@@ -125,6 +126,7 @@ namespace GuidancePlanner
     // Enable flags
     dynamically_propagate_nodes_ = gp["enable"]["dynamically_propagate_nodes"].as<bool>(true);
     project_from_obstacles_ = gp["enable"]["project_from_obstacles"].as<bool>(false);
+    cull_obstacles_ = gp["enable"]["cull_obstacles"].as<bool>(true);
 
     // Test node settings
     debug_continuous_replanning_ = gp["test_node"]["continuous_replanning"].as<bool>(true);
@@ -6,6 +6,7 @@
 #include <guidance_planner/utils.h>
 
 #include <ros_tools/math.h>
+#include <ros_tools/banded_cholesky.h>
 
 using namespace GuidancePlanner;
 
@@ -67,19 +68,13 @@ void CubicSpline3D::ConvertToTrajectory(const GeometricPath &path)
   //     sampled_k(k) = path.nodes_[k]->point_.Time();
 
   /** @note We need to find throughout the spline, where the integer "k"s are */
-  double last_s = -0.1;                                      //-0.1;
+  size_t connection_cursor = 0;                              // The sampled k are increasing, so the search only moves forward
   for (int k_idx = 1; k_idx < sampled_k.size() - 1; k_idx++) // Then add from the first until the last sampled point (which exclude start and end)
   {
     double k = sampled_k[k_idx];
 
-    // A bisection finds the point where the 3rd coordinate of this spline is equal to "k".
-    double s_cur = RosTools::Bisection(
-        last_s, 1., [&](double s)
-        { return path(s)(2) - k; },
-        1e-3);
-
-    control_points_.AddPoint(path(s_cur));
-    last_s = s_cur; // Limit the search to [last_k, 1]
+    // Find the point where the 3rd coordinate of this spline is equal to "k"
+    control_points_.AddPoint(path.AtTime(k, connection_cursor));
 
     // control_points_.PrintLast();
   }
@@ -108,135 +103,73 @@ void CubicSpline3D::Optimize(const std::vector<Obstacle> &obstacles)
 {
   PRM_LOG("BSpline::Optimize()");
 
+  // The QP is banded: smoothness couples each coordinate of a control point to the same coordinate of the two neighbouring
+  // points on both sides (offsets 2 and 4 in the vectorized control points) and obstacles couple the x and y of one point.
+  // The system is therefore solved with a banded Cholesky factorization. The workspace is reused by all splines optimized on
+  // the same thread.
+  static thread_local RosTools::BandedCholesky H;
+  static thread_local Eigen::VectorXd f;
+
+  const int num_points = control_points_.NumPoints();
+  const int num_vars = 2 * num_points;
+
   // Compute the velocity control points
 
   for (int repeat_id = 0; repeat_id < 1; repeat_id++)
   {
+    H.Reset(num_vars, 4);
+    f.resize(num_vars);
 
     // CLOSE TO GEOMETRIC PATH //
     PRM_LOG("BSpline Optimize - Adding cost to geometric path");
 
-    // Vector of G (points on the original path)
-    Eigen::VectorXd f_g = Eigen::Map<Eigen::VectorXd>(initial_control_points_.points_.data(),
-                                                      initial_control_points_.points_.cols() * initial_control_points_.points_.rows());
-
-    // Simply identity weights
-    Eigen::MatrixXd H_g =
-        config_->geometric_weight_ * 2. * Eigen::MatrixXd::Identity(control_points_.NumPoints() * 2, control_points_.NumPoints() * 2);
-    f_g = config_->geometric_weight_ * -2 * f_g;
+    // Vector of G (points on the original path), simply identity weights
+    Eigen::Map<const Eigen::VectorXd> g(initial_control_points_.points_.data(), num_vars);
+    for (int j = 0; j < num_vars; j++)
+      H(j, j) = config_->geometric_weight_ * 2.;
+    f = config_->geometric_weight_ * -2 * g;
 
     // SMOOTHNESS //
     PRM_LOG("BSpline Optimize - Adding smoothness cost");
 
-    Eigen::MatrixXd H_s = Eigen::MatrixXd::Zero(2 * control_points_.NumPoints(), 2 * control_points_.NumPoints());
-    Eigen::VectorXd f_s;
-
-    bool one_padding = true;
-    Eigen::MatrixXd M1, M3;
-
-    if (one_padding)
-    {
-      M1 = Eigen::MatrixXd::Zero(2 * 1, control_points_.NumPoints() * 2); // Start, 2 = num of not optimized points at the sides
-      M3 = Eigen::MatrixXd::Zero(2 * 1, control_points_.NumPoints() * 2); // End
-    }
-    else
-    {
-      M1 = Eigen::MatrixXd::Zero(2 * 2, control_points_.NumPoints() * 2); // Start, 2 = num of not optimized points at the sides
-      M3 = Eigen::MatrixXd::Zero(2 * 2, control_points_.NumPoints() * 2); // End
-    }
-
-    for (int diag_id = 0; diag_id < control_points_.NumPoints() && diag_id < 3; diag_id++)
+    // Diagonals (6, -4, 1) at offsets (0, 2, 4). One padded control point on each side lowers the first and last diagonal
+    // entries by one.
+    const double smoothness_values[3] = {6., -4., 1.};
+    for (int diag_id = 0; diag_id < num_points && diag_id < 3; diag_id++)
     {
-      double val;
-
-      switch (diag_id)
-      {
-      case 0:
-        val = 6;
-
-        break;
-      case 1:
-        val = -4;
-        break;
-      case 2:
-        val = 1;
-        break;
-      }
-      // Set each value along the selected diagonal
-      for (int j = 0; j < H_s.rows() - diag_id * 2; j++)
+      for (int j = 0; j < num_vars - diag_id * 2; j++)
       {
-        if (one_padding && diag_id == 0 && (j <= 1 || j >= H_s.rows() - diag_id * 2 - 2)) // Extension for one control point on the side
-
-          H_s(j + diag_id * 2, j) = val - 1; // Set the lower diagonal
-        else
-          H_s(j + diag_id * 2, j) = val; // Set the lower diagonal
-
-        if (diag_id > 0)                 // For diag_id == 0, lower = upper
-          H_s(j, j + diag_id * 2) = val; // Set the upper diagonal
-      }
+        double val = smoothness_values[diag_id];
+        if (diag_id == 0 && (j <= 1 || j >= num_vars - 2)) // Extension for one control point on the side
+          val -= 1.;
 
-      if (diag_id >= 2)
-        continue;
-
-      double f_val;
-      if (one_padding)
-      {
-        switch (diag_id)
-        {
-        case 0:
-          f_val = -2;
-          break;
-        case 1:
-          f_val = 1;
-          break;
-        }
-        for (int j = 0; j < 2; j++)
-        {
-          M1(j, j + 2 * diag_id) = f_val;
-          M3(j, M3.cols() - diag_id * 2 - 2 + j) = f_val;
-        }
-      }
-      else
-      {
-        switch (diag_id)
-        {
-        case 0:
-          f_val = 1;
-          break;
-        case 1:
-          f_val = -4;
-          break;
-        }
-        for (int j = 0; j < M1.rows() - diag_id * 2; j++)
-        {
-          M1(j + diag_id * 2, j) = f_val;
-          M3(j, M3.cols() - 2 * 2 + j + diag_id * 2) = f_val;
-        }
+        H(j + diag_id * 2, j) += config_->smoothness_weight_ * val;
       }
     }
 
-    // std::cout << H_s << std::endl;
-    // std::cout << M1 << std::endl;
-    // std::cout << M3 << std::endl;
-
-    // Construct f from the padded points on both sides of the spline
+    // Construct f from the padded points on both sides of the spline (-2 on the closest point, 1 on the next point)
     Eigen::VectorXd start, end;
     control_points_.GetStartVectorized(start);
     control_points_.GetEndVectorized(end); /** @todo End is incorrect now (should be only 1) - Although it is okay */
 
-    f_s = start.transpose() * M1;
-    f_s += end.transpose() * M3; // = half, but we solve for xHx + 2fx
+    for (int j = 0; j < 2; j++) // = half, but we solve for xHx + 2fx
+    {
+      f(j) += config_->smoothness_weight_ * -2. * start(j);
+      f(num_vars - 2 + j) += config_->smoothness_weight_ * -2. * end(j);
 
-    // Add this cost
-    H_g += config_->smoothness_weight_ * H_s;
-    f_g += config_->smoothness_weight_ * f_s;
+      if (num_points > 1)
+      {
+        f(2 + j) += config_->smoothness_weight_ * start(j);
+        f(num_vars - 4 + j) += config_->smoothness_weight_ * end(j);
+      }
+    }
 
     // OBSTACLES REPULSIVE//
     PRM_LOG("BSpline Optimize - Adding obstacle avoidance cost");
 
     // Distance = Ax - b, e^(-x) taylor expansion 2nd degree -> quadratic cost
     // For each control point
-    for (int i = 0; i < control_points_.NumPoints(); i++)
+    for (int i = 0; i < num_points; i++)
     {
       // Check for all obstacles
       for (auto &obstacle : obstacles)
@@ -255,15 +188,16 @@ void CubicSpline3D::Optimize(const std::vector<Obstacle> &obstacles)
 
         Eigen::Vector2d A_i = -(obstacle_pos - control_pos).normalized();
 
-        Eigen::MatrixXd H_i = A_i * A_i.transpose() / 2.;
+        Eigen::Matrix2d H_i = A_i * A_i.transpose() / 2.;
 
         double b_i = obstacle.radius_;
 
-        Eigen::VectorXd f_i = -(1 + b_i) * A_i.transpose() - 2 * obstacle_pos.transpose() * H_i.transpose(); /*A_i * A_i.transpose()*/
-                                                                                                             // Obstacle f is missing
+        Eigen::Vector2d f_i = -(1 + b_i) * A_i - 2 * H_i * obstacle_pos; // Obstacle f is missing
 
-        H_g.block(i * 2, i * 2, 2, 2) = H_g.block(i * 2, i * 2, 2, 2) + config_->collision_weight_ * H_i;
-        f_g.block(i * 2, 0, 2, 1) = f_g.block(i * 2, 0, 2, 1) + config_->collision_weight_ * f_i;
+        H(i * 2, i * 2) += config_->collision_weight_ * H_i(0, 0);
+        H(i * 2 + 1, i * 2) += config_->collision_weight_ * H_i(1, 0);
+        H(i * 2 + 1, i * 2 + 1) += config_->collision_weight_ * H_i(1, 1);
+        f.segment<2>(i * 2) += config_->collision_weight_ * f_i;
       }
     }
 
@@ -272,24 +206,27 @@ void CubicSpline3D::Optimize(const std::vector<Obstacle> &obstacles)
     // Then we penalize distance to this spline, which should try to track the velocity
     // Note that otherwise, the velocity penalty is 4th order rather than quadratic
     Eigen::MatrixXd velocity_spline_control_points_ = ComputeVelocitySplinePoints();
-    Eigen::VectorXd f_v = Eigen::Map<Eigen::VectorXd>(velocity_spline_control_points_.data(),
-                                                      velocity_spline_control_points_.cols() * velocity_spline_control_points_.rows());
+    Eigen::Map<const Eigen::VectorXd> v(velocity_spline_control_points_.data(), num_vars);
 
     // Simply identity weights
-    Eigen::MatrixXd H_v =
-        config_->velocity_tracking_ * 2. * Eigen::MatrixXd::Identity(control_points_.NumPoints() * 2, control_points_.NumPoints() * 2);
-    f_v = config_->velocity_tracking_ * -2 * f_v;
-
-    H_g += H_v;
-    f_g += f_v;
+    for (int j = 0; j < num_vars; j++)
+      H(j, j) += config_->velocity_tracking_ * 2.;
+    f += config_->velocity_tracking_ * -2 * v;
 
     // SOLVE //
-    // Unconstrained QP analytic solution
-    Eigen::VectorXd new_points_vectorized = -H_g.inverse() * f_g;
+    // Unconstrained QP analytic solution: H x = -f
+    if (!H.Factorize())
+    {
+      PRM_WARN("Spline optimization is not positive definite, keeping the initial control points");
+      break;
+    }
+
+    f = -f;
+    H.Solve(f, f);
 
     // Convert vector back to matrix format
-    for (int i = 0; i < control_points_.NumPoints(); i++)
-      control_points_.SetPoint(i, new_points_vectorized.block(i * 2, 0, 2, 1));
+    for (int i = 0; i < num_points; i++)
+      control_points_.SetPoint(i, f.segment<2>(i * 2));
   }
 
   // POST-CHECK, PROJECT POINTS OUTSIDE OF OBSTACLES //
@@ -509,14 +446,14 @@ std::vector<Eigen::Vector3d> &CubicSpline3D::GetSamples()
 
   sampled_points_.clear();
 
-  Eigen::VectorXd sampled_t = Eigen::VectorXd::LinSpaced(20, 0., trajectory_spline_->parameterLength());
+  std::vector<double> sampled_t = RosTools::linspace(0., trajectory_spline_->parameterLength(), 20);
+
+  std::vector<Eigen::Vector2d> points;
+  trajectory_spline_->getPoints(sampled_t, points);
+
+  for (size_t i = 0; i < sampled_t.size(); i++)
+    sampled_points_.emplace_back(points[i](0), points[i](1), sampled_t[i]);
 
-  for (int i = 0; i < sampled_t.size(); i++)
-  {
-    double t = sampled_t(i);
-    Eigen::Vector2d cur_point = trajectory_spline_->getPoint(t);
-    sampled_points_.emplace_back(cur_point(0), cur_point(1), t);
-  }
   return sampled_points_;
 }
 
@@ -526,18 +463,21 @@ double CubicSpline3D::WeightVelocity()
 {
   double result = 0.;
 
-  Eigen::ArrayXd t_sampled = Eigen::ArrayXd::LinSpaced(100, 0., trajectory_spline_->parameterLength());
+  std::vector<double> t_sampled = RosTools::linspace(0., trajectory_spline_->parameterLength(), 100);
+
+  std::vector<Eigen::Vector2d> points, velocities;
+  trajectory_spline_->getPoints(t_sampled, points, &velocities);
 
-  for (int i = 0; i < t_sampled.rows(); i++)
+  for (size_t i = 0; i < t_sampled.size(); i++)
   {
-    double cur_velocity = trajectory_spline_->getVelocity(t_sampled[i]).norm();
+    double cur_velocity = velocities[i].norm();
 
     result += (Config::reference_velocity_ - cur_velocity) *
               (Config::reference_velocity_ - cur_velocity); // Quadratic error w.r.t. the reference
   }
 
   // Average the error over the number of evaluations
-  result /= (double)t_sampled.rows();
+  result /= (double)t_sampled.size();
 
   return result;
 }
@@ -554,12 +494,19 @@ void CubicSpline3D::ComputeAccelerationWeights()
 
   acceleration_weight_ = 0.;
 
-  Eigen::ArrayXd t_sampled = Eigen::ArrayXd::LinSpaced(100, 0., trajectory_spline_->parameterLength());
+  std::vector<double> t_sampled = RosTools::linspace(0., trajectory_spline_->parameterLength(), 100);
 
-  for (int i = 0; i < t_sampled.rows(); i++)
-    acceleration_weight_ += trajectory_spline_->getAcceleration(t_sampled[i]).norm() * std::pow(0.95, i);
+  std::vector<Eigen::Vector2d> points, accelerations;
+  trajectory_spline_->getPoints(t_sampled, points, nullptr, &accelerations);
+
+  double discount = 1.;
+  for (size_t i = 0; i < t_sampled.size(); i++)
+  {
+    acceleration_weight_ += accelerations[i].norm() * discount;
+    discount *= 0.95;
+  }
 
-  acceleration_weight_ /= (double)t_sampled.rows();
+  acceleration_weight_ /= (double)t_sampled.size();
 
   acceleration_weights_computed_ = true;
 }
@@ -607,7 +554,7 @@ CubicSpline3D &CubicSpline3D::Empty(const SpaceTimePoint::TVector &start, Config
   // static Node b(-1, SpaceTimePoint(start + SpaceTimePoint::TVector::Ones(SpaceTimePoint::numStates()) * 0.01, Config::N), NodeType::NONE); // Small forward deviation to make the path valid
 
   // Create a path
-  std::vector<Node *> nodes;
+  std::vector<const Node *> nodes;
   nodes.push_back(&a);
   nodes.push_back(&mid);
   nodes.push_back(&b);
@@ -13,13 +13,22 @@ namespace GuidancePlanner
   bool Environment::InCollision(const SpaceTimePoint &point, double with_margin)
   {
 
-    for (auto &obstacle : dynamic_obstacles_)
+    for (auto &obstacle : *dynamic_obstacles_)
     {
+      if (obstacle.is_static_)
+        continue;
+
       // Round the time index to the nearest integer
       if (RosTools::distance(obstacle.positions_[std::round(point.Time())], point.Pos()) < obstacle.radius_ + with_margin) // Note that the obstacle positions at k = 0 is the initial state
         return true;
     }
 
+    for (auto &circle : static_circles_)
+    {
+      if (RosTools::distance(circle.position, point.Pos()) < circle.radius + with_margin)
+        return true;
+    }
+
     for (auto &halfspace : static_obstacles_)
     {
       if (halfspace.A_.transpose() * point.Pos() > halfspace.b_)
@@ -29,11 +38,64 @@ namespace GuidancePlanner
     return false;
   }
 
-  void Environment::LoadObstacles(const std::vector<Obstacle> &dynamic_obstacles, const std::vector<Halfspace> &static_obstacles)
+  void Environment::LoadObstacles(const ObstacleSnapshot &dynamic_obstacles, const std::vector<Halfspace> &static_obstacles)
   {
 
     dynamic_obstacles_ = dynamic_obstacles;
     static_obstacles_ = static_obstacles;
+
+    UpdateStaticCircles();
+  }
+
+  bool Environment::UpdateStaticCircles()
+  {
+    size_t num_static = 0;
+    bool changed = false;
+    for (auto &obstacle : *dynamic_obstacles_)
+    {
+      if (!obstacle.is_static_)
+        continue;
+
+      StaticCircle circle(obstacle.positions_[0], obstacle.radius_);
+      if (num_static >= static_circles_.size() || !(static_circles_[num_static] == circle))
+      {
+        changed = true;
+        break;
+      }
+      num_static++;
+    }
+
+    if (!changed && num_static == static_circles_.size())
+      return false;
+
+    PRM_LOG("Static obstacles changed, rebuilding their 2D geometry");
+    static_circles_.clear();
+    for (auto &obstacle : *dynamic_obstacles_)
+    {
+      if (obstacle.is_static_)
+        static_circles_.emplace_back(obstacle.positions_[0], obstacle.radius_);
+    }
+
+    return true;
+  }
+
+  bool Environment::IsVisibleStatic(const Eigen::Vector2d &point_one, const Eigen::Vector2d &point_two) const
+  {
+    // A static obstacle is a vertical line over the full horizon, hence the space-time distance is the 2D distance
+    Eigen::Vector2d line = point_two - point_one;
+    double line_squared = line.squaredNorm();
+
+    for (auto &circle : static_circles_)
+    {
+      double t = 0.;
+      if (line_squared > 0.)
+        t = std::max(0., std::min((circle.position - point_one).dot(line) / line_squared, 1.));
+
+      if ((point_one + t * line - circle.position).squaredNorm() < circle.radius * circle.radius)
+        return false;
+    }
+
+    return true;
   }
 
   bool Environment::IsVisible(const Node &a, const Node &b) { return IsVisible(a.point_, b.point_); }
@@ -53,12 +115,15 @@ namespace GuidancePlanner
     double A;
     double dist;
 
+    if (!IsVisibleStatic(point_one.Pos(), point_two.Pos())) // Static obstacles are checked once in 2D
+      return false;
+
     a = point_one.PosTime();
     b = (point_two - point_one).PosTime();
 
-    for (auto &obstacle : dynamic_obstacles_)
+    for (auto &obstacle : *dynamic_obstacles_)
     {
-      if (obstacle.positions_.size() < 2)
+      if (obstacle.is_static_ || obstacle.positions_.size() < 2)
         continue;
       for (int k = 0; k < Config::N; k++) // For constant velocity, only one line segment
       {
@@ -118,7 +183,7 @@ namespace GuidancePlanner
   {
 
     // Projecting in 2D from obstacles
-    for (auto &obstacle : dynamic_obstacles_)
+    for (auto &obstacle : *dynamic_obstacles_)
     {
       double dist = (obstacle.positions_[k] - point).norm();
       if (dist < obstacle.radius_ * (1. + with_margin))
@@ -157,7 +222,7 @@ namespace GuidancePlanner
     double A, B, C, D;
     double lambda;
 
-    for (auto &obstacle : dynamic_obstacles_)
+    for (auto &obstacle : *dynamic_obstacles_)
     {
       const Eigen::Vector2d &c = obstacle.positions_[k]; // Circle origin
 
@@ -311,6 +376,12 @@ namespace GuidancePlanner
         return true;
     }
 
+    for (auto &circle : static_circles_)
+    {
+      if (RosTools::distance(circle.position, point.Pos()) < circle.radius + with_margin)
+        return true;
+    }
+
     for (auto &halfspace : static_obstacles_)
     {
       if (halfspace.A_.transpose() * point.Pos() > halfspace.b_)
@@ -320,18 +391,21 @@ namespace GuidancePlanner
     return false;
   }
 
-  void GriddedEnvironment::LoadObstacles(const std::vector<Obstacle> &dynamic_obstacles, const std::vector<Halfspace> &static_obstacles)
+  void GriddedEnvironment::LoadObstacles(const ObstacleSnapshot &dynamic_obstacles, const std::vector<Halfspace> &static_obstacles)
   {
     Environment::LoadObstacles(dynamic_obstacles, static_obstacles);
 
-    if (dynamic_obstacles_.size() > 0)
-      grid_.SetDimensions(50, 50, dynamic_obstacles_[0].radius_);
+    if (dynamic_obstacles_->size() > 0)
+      grid_.SetDimensions(50, 50, (*dynamic_obstacles_)[0].radius_);
     else
       grid_.SetDimensions(50, 50, 0.5);
     grid_.Clear();
 
-    for (auto &obstacle : dynamic_obstacles_)
+    for (auto &obstacle : *dynamic_obstacles_)
     {
+      if (obstacle.is_static_) // Static obstacles are not gridded over time
+        continue;
+
       for (int k = 0; k < Config::N + 1; k++)
         grid_.InsertObstacle((int)k, SingleObstacle(obstacle.positions_[k], obstacle.radius_));
     }
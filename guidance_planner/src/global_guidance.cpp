@@ -12,6 +12,7 @@
 #include <ros_tools/profiling.h>
 #include <ros_tools/data_saver.h>
 #include <ros_tools/logging.h>
+#include <ros_tools/math.h>
 
 #include <omp.h>
 
@@ -82,6 +83,10 @@ namespace GuidancePlanner
 
     prm_.Init(config_.get());
 
+    guidance_benchmarker_ = BENCHMARKERS.registerBenchmarker("Guidance Planner");
+    prm_benchmarker_ = BENCHMARKERS.registerBenchmarker("PRM");
+    processing_benchmarker_ = BENCHMARKERS.registerBenchmarker("processing");
+
     // learning_guidance_.Init(nh_);
 
     start_velocity_ = Eigen::Vector2d(0., 0.);
@@ -93,11 +98,21 @@ namespace GuidancePlanner
 
   void GlobalGuidance::LoadObstacles(const std::vector<Obstacle> &obstacles, const std::vector<Halfspace> &static_obstacles)
   {
+    LoadObstacles(std::vector<Obstacle>(obstacles), static_obstacles);
+  }
+
+  void GlobalGuidance::LoadObstacles(std::vector<Obstacle> &&obstacles, const std::vector<Halfspace> &static_obstacles)
+  {
+    SwapObstacles(obstacles, static_obstacles);
+  }
 
-    obstacles_ = obstacles;
+  void GlobalGuidance::SwapObstacles(std::vector<Obstacle> &obstacles, const std::vector<Halfspace> &static_obstacles)
+  {
+    std::shared_ptr<std::vector<Obstacle>> *buffer = GetUnsharedBuffer(obstacle_buffers_, obstacles_);
+    (*buffer)->swap(obstacles);
 
     // Make sure the time horizon of the obstacles matches the setting
-    for (auto &obstacle : obstacles_)
+    for (auto &obstacle : **buffer)
     {
       if ((int)obstacle.positions_.size() < Config::N + 1)
       {
@@ -108,13 +123,35 @@ namespace GuidancePlanner
           obstacle.positions_.push_back(obstacle.positions_.back() + last_vel);
         }
       }
+
+      // Obstacles that do not move are handled in 2D by the environment and homology
+      if (!obstacle.is_static_)
+        obstacle.is_static_ = obstacle.HasStaticPrediction();
     }
 
+    // Not modified after this point (until the buffer is no longer shared)
+    obstacles_ = *buffer;
+
     static_obstacles_ = static_obstacles;
     // if (config_->use_learning)
     //   learning_guidance_.LoadObstacles(obstacles, static_obstacles);
   }
 
+  std::shared_ptr<std::vector<Obstacle>> *GlobalGuidance::GetUnsharedBuffer(std::shared_ptr<std::vector<Obstacle>> (&buffers)[2],
+                                                                              const ObstacleSnapshot &current)
+  {
+    // Fill a buffer that no component holds anymore (the snapshot of two cycles ago), otherwise allocate a new one
+    for (auto &candidate : buffers)
+    {
+      if (candidate && candidate.use_count() == 1)
+        return &candidate;
+    }
+
+    std::shared_ptr<std::vector<Obstacle>> *buffer = buffers[0].get() == current.get() ? &buffers[1] : &buffers[0];
+    *buffer = std::make_shared<std::vector<Obstacle>>();
+    return buffer;
+  }
+
   void GlobalGuidance::LoadStaticObstacles(const std::vector<Halfspace> &static_obstacles)
   {
     static_obstacles_ = static_obstacles;
@@ -134,6 +171,7 @@ namespace GuidancePlanner
     double s_best = spline_start + Config::DT * (double)Config::N * config_->reference_velocity_;
 
     prm_.SampleAlongReferencePath(reference_path, spline_start, s_best, road_width_left, road_width_right);
+    SetSamplingRegion(reference_path, spline_start, s_best, road_width_left, road_width_right);
   }
 
   void GlobalGuidance::LoadReferencePath(double spline_start, std::shared_ptr<RosTools::Spline2D> reference_path, double road_width)
@@ -172,20 +210,25 @@ namespace GuidancePlanner
     // Eigen::Vector2d orth = reference_path->getOrthogonal(s_start).normalized();
     double current_v_offset = 0.; // orth.transpose() * (reference_path->getPoint(s_start) - start_); // Moves the goals with the offset of the robot
 
+    // Compute the distances at which our goals are longitudinally and evaluate the path there at once
+    std::vector<double> goal_s(grid_long);
+    for (int i = 0; i < grid_long; i++)
+      goal_s[i] = grid_long > 1 ? s_start + (double)i * s_step : s_best;
+
+    std::vector<Eigen::Vector2d> line_points, path_velocities;
+    reference_path->getPoints(goal_s, line_points, &path_velocities);
+
     goals_.clear();
     // goal_costs_.clear(); // Better goals have a lower score
     for (int i = 0; i < grid_long; i++)
     {
-      // Compute the distance at which our goal is longitudinally
-      double s = grid_long > 1 ? s_start + (double)i * s_step : s_best;
-
       // Compute its cost (integer * 2), minimum at desired velocity
       double long_cost = std::abs((grid_long - 1) - i) * 2.;
 
       // Compute the normal vector to the reference path
-      Eigen::Vector2d line_point = reference_path->getPoint(s);
-      Eigen::Vector2d normal = reference_path->getVelocity(s).normalized();
-      double angle = reference_path->getPathAngle(s);
+      const Eigen::Vector2d &line_point = line_points[i];
+      Eigen::Vector2d normal = path_velocities[i].normalized();
+      double angle = std::atan2(path_velocities[i](1), path_velocities[i](0));
 
       normal = Eigen::Vector2d(-normal(1), normal(0));
 
@@ -211,6 +254,128 @@ namespace GuidancePlanner
     }
 
     prm_.SampleAlongReferencePath(reference_path, s_start, s_best, road_width_left, road_width_right);
+    SetSamplingRegion(reference_path, s_start, s_best, road_width_left, road_width_right);
+  }
+
+  void GlobalGuidance::SetSamplingRegion(const std::shared_ptr<RosTools::Spline2D> &reference_path, double s_start, double s_end,
+                                         double road_width_left, double road_width_right)
+  {
+    sampling_region_s_.resize(10);
+    for (size_t i = 0; i < sampling_region_s_.size(); i++)
+      sampling_region_s_[i] = s_start + (s_end - s_start) * i / (sampling_region_s_.size() - 1.);
+    reference_path->getPoints(sampling_region_s_, sampling_region_);
+
+    sampling_region_width_ = std::max(road_width_left, road_width_right);
+  }
+
+  void GlobalGuidance::CullObstacles()
+  {
+    size_t num_relevant = obstacles_->size();
+    if (config_->cull_obstacles_)
+    {
+      num_relevant = 0;
+      for (auto &obstacle : *obstacles_)
+        num_relevant += IsRelevant(obstacle) ? 1 : 0;
+    }
+
+    // Only build a separate snapshot if obstacles are culled. Its buffer is refilled by assignment, obstacles that are
+    // not needed this cycle are set aside such that their predictions keep their storage
+    if (num_relevant == obstacles_->size())
+    {
+      relevant_obstacles_ = obstacles_;
+    }
+    else
+    {
+      std::shared_ptr<std::vector<Obstacle>> *buffer = GetUnsharedBuffer(relevant_buffers_, relevant_obstacles_);
+      std::vector<Obstacle> &relevant = **buffer;
+      while (relevant.size() > num_relevant)
+      {
+        spare_obstacles_.push_back(std::move(relevant.back()));
+        relevant.pop_back();
+      }
+
+      size_t i = 0;
+      for (auto &obstacle : *obstacles_)
+      {
+        if (!IsRelevant(obstacle))
+          continue;
+
+        if (i < relevant.size())
+        {
+          relevant[i] = obstacle;
+        }
+        else if (!spare_obstacles_.empty())
+        {
+          relevant.push_back(std::move(spare_obstacles_.back()));
+          spare_obstacles_.pop_back();
+          relevant.back() = obstacle;
+        }
+        else
+        {
+          relevant.push_back(obstacle);
+        }
+        i++;
+      }
+      relevant_obstacles_ = *buffer;
+    }
+
+    cull_statistics_.loaded = obstacles_->size();
+    cull_statistics_.relevant = relevant_obstacles_->size();
+    cull_statistics_.culled = cull_statistics_.loaded - cull_statistics_.relevant;
+    PRM_LOG("Obstacle culling: " << cull_statistics_.relevant << " / " << cull_statistics_.loaded << " obstacles are relevant");
+  }
+
+  bool GlobalGuidance::IsRelevant(const Obstacle &obstacle) const
+  {
+    if (obstacle.positions_.empty())
+      return false;
+
+    // The prediction is swept between time steps, static obstacles only need their position
+    size_t last = obstacle.positions_.size() - 1;
+    size_t num_segments = obstacle.is_static_ ? 1 : std::max<size_t>(last, 1);
+
+    double range = obstacle.radius_ + config_->cull_margin_;
+    if (!sampling_region_.empty())
+    {
+      // Corridor around the reference path segment, starting from the robot position
+      range += sampling_region_width_;
+      for (size_t k = 0; k < num_segments; k++)
+      {
+        const Eigen::Vector2d &from = obstacle.positions_[k];
+        const Eigen::Vector2d &to = obstacle.positions_[std::min(k + 1, last)];
+
+        if (RosTools::segmentSegmentDistance(from, to, start_, sampling_region_[0]) < range)
+          return true;
+
+        for (size_t i = 1; i < sampling_region_.size(); i++)
+        {
+          if (RosTools::segmentSegmentDistance(from, to, sampling_region_[i - 1], sampling_region_[i]) < range)
+            return true;
+        }
+      }
+      return false;
+    }
+
+    // Box between the start and the goals (as sampled by the sampler)
+    Eigen::Vector2d min = start_, max = start_;
+    for (auto &goal : goals_)
+    {
+      min = min.cwiseMin(goal.pos.head<2>());
+      max = max.cwiseMax(goal.pos.head<2>());
+    }
+    min -= Eigen::Vector2d::Constant(0.5 * config_->sample_margin_ + range);
+    max += Eigen::Vector2d::Constant(0.5 * config_->sample_margin_ + range);
+
+    for (size_t k = 0; k < num_segments; k++)
+    {
+      const Eigen::Vector2d &from = obstacle.positions_[k];
+      const Eigen::Vector2d &to = obstacle.positions_[std::min(k + 1, last)];
+
+      // Conservative: the bounding box of the segment overlaps the region
+      if ((from.cwiseMin(to).array() <= max.array()).all() && (from.cwiseMax(to).array() >= min.array()).all())
+        return true;
+    }
+    return false;
   }
 
   void GlobalGuidance::SetGoals(const std::vector<Goal> &goals)
@@ -236,9 +401,9 @@ namespace GuidancePlanner
     {
       PROFILE_SCOPE("GlobalGuidance::Update");
       PRM_LOG("GlobalGuidance::Update")
-      auto &guidance_benchmarker = BENCHMARKERS.getBenchmarker("Guidance Planner");
-      auto &prm_benchmarker = BENCHMARKERS.getBenchmarker("PRM");
-      auto &processing_benchmarker = BENCHMARKERS.getBenchmarker("processing");
+      auto &guidance_benchmarker = BENCHMARKERS.getBenchmarker(guidance_benchmarker_);
+      auto &prm_benchmarker = BENCHMARKERS.getBenchmarker(prm_benchmarker_);
+      auto &processing_benchmarker = BENCHMARKERS.getBenchmarker(processing_benchmarker_);
 
       guidance_benchmarker.start();
 
@@ -253,13 +418,15 @@ namespace GuidancePlanner
       goals_set_ = false;
 
       /* Verify validity of input data */
-      for (auto &obstacle : obstacles_) // Dynamic obstacles
+      for (auto &obstacle : *obstacles_) // Dynamic obstacles
         ROSTOOLS_ASSERT((int)obstacle.positions_.size() >= Config::N + 1, "Obstacles should have their predictions populated from 0-N");
 
+      CullObstacles(); // Only obstacles near the sampling region affect the guidance
+
       PRM_LOG("======== Visibility-PRM ==========");
 
       prm_benchmarker.start();
-      prm_.LoadData(obstacles_, static_obstacles_, start_, orientation_, start_velocity_, goals_);
+      prm_.LoadData(relevant_obstacles_, static_obstacles_, start_, orientation_, start_velocity_, goals_);
       Graph &graph = prm_.Update(); // Construct a graph using visibility PRM
       prm_benchmarker.stop();
 
@@ -275,9 +442,10 @@ namespace GuidancePlanner
 #pragma omp parallel for num_threads(8)
         for (size_t g = 0; g < graph.goal_nodes_.size(); g++)
         {
-          std::vector<Node *> L = {graph.start_node_};
+          std::vector<int> L = {graph.start_node_};
+          std::vector<int> E;
 
-          graph_search_.Search(graph, config_->n_paths_, L, cur_paths[g], graph.goal_nodes_[g]); // Find paths via a graph-search
+          graph_search_.Search(graph, config_->n_paths_, L, E, cur_paths[g], graph.goal_nodes_[g]); // Find paths via a graph-search
         }
 
         // Join all paths
@@ -335,12 +503,16 @@ namespace GuidancePlanner
       {
         PROFILE_SCOPE("Cubic Splines");
 
+        splines_.resize(paths_.size());
+
+        // Splines are independent: fit them in parallel
+#pragma omp parallel for num_threads(8)
         for (size_t i = 0; i < paths_.size(); i++)
         {
           auto &path = paths_[i];
-          splines_.emplace_back(path, config_.get(), start_velocity_); // Fit Cubic-Splines for each path
+          splines_[i] = CubicSpline3D(path, config_.get(), start_velocity_); // Fit Cubic-Splines for each path
           if (config_->optimize_splines_)
-            splines_.back().Optimize(obstacles_);
+            splines_[i].Optimize(*relevant_obstacles_);
         }
       }
 
@@ -407,7 +579,7 @@ namespace GuidancePlanner
       LOG_WARN("Integration exception called");
       splines_.clear();
       paths_.clear();
-      BENCHMARKERS.getBenchmarker("Guidance Planner").stop();
+      BENCHMARKERS.getBenchmarker(guidance_benchmarker_).stop();
       return false;
     }
   }
@@ -653,7 +825,8 @@ namespace GuidancePlanner
     // Forget the graph
     prm_.Reset();
 
-    for (auto &obstacle : obstacles_) // Ensure that the obstacles have long enough predictions
+    std::vector<Obstacle> reset_obstacles = *obstacles_;
+    for (auto &obstacle : reset_obstacles) // Ensure that the obstacles have long enough predictions
     {
       obstacle.positions_.resize(Config::N + 1);
       for (int k = 0; k <= Config::N; k++)
@@ -661,6 +834,7 @@ namespace GuidancePlanner
 
       obstacle.radius_ = 0.;
     }
+    obstacles_ = std::make_shared<const std::vector<Obstacle>>(std::move(reset_obstacles));
   }
 
   GlobalGuidance::OutputTrajectory &GlobalGuidance::GetGuidanceTrajectory(int trajectory_id)
@@ -782,14 +956,32 @@ namespace GuidancePlanner
 
   void GlobalGuidance::saveData(RosTools::DataSaver &data_saver) // Export data for analysis
   {
-    data_saver.AddData("prm_runtime", BENCHMARKERS.getBenchmarker("PRM").getLast());
-    data_saver.AddData("processing_runtime", BENCHMARKERS.getBenchmarker("processing").getLast());
+    data_saver.AddData("prm_runtime", BENCHMARKERS.getBenchmarker(prm_benchmarker_).getLast());
+    data_saver.AddData("processing_runtime", BENCHMARKERS.getBenchmarker(processing_benchmarker_).getLast());
+    data_saver.AddData("relevant_obstacles", cull_statistics_.relevant);
+    data_saver.AddData("culled_obstacles", cull_statistics_.culled);
     prm_.saveData(data_saver);
   }
 
+  void GlobalGuidance::addColumns(RosTools::DataRecorder &recorder)
+  {
+    prm_runtime_column_ = recorder.addColumn("prm_runtime");
+    processing_runtime_column_ = recorder.addColumn("processing_runtime");
+    relevant_obstacles_column_ = recorder.addColumn("relevant_obstacles");
+    culled_obstacles_column_ = recorder.addColumn("culled_obstacles");
+  }
+
+  void GlobalGuidance::saveData(RosTools::DataRecorder &recorder)
+  {
+    recorder.append(prm_runtime_column_, BENCHMARKERS.getBenchmarker(prm_benchmarker_).getLast());
+    recorder.append(processing_runtime_column_, BENCHMARKERS.getBenchmarker(processing_benchmarker_).getLast());
+    recorder.append(relevant_obstacles_column_, cull_statistics_.relevant);
+    recorder.append(culled_obstacles_column_, cull_statistics_.culled);
+  }
+
   double GlobalGuidance::GetLastRuntime()
   {
-    return BENCHMARKERS.getBenchmarker("Guidance Planner").getLast();
+    return BENCHMARKERS.getBenchmarker(guidance_benchmarker_).getLast();
   }
 
 } // namespace GuidancePlanner
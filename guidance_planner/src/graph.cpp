@@ -1,5 +1,4 @@
 
-
 #include <guidance_planner/graph.h>
 
 #include <guidance_planner/types/types.h>
@@ -13,50 +12,107 @@ namespace GuidancePlanner
 
     void Graph::Initialize(const SpaceTimePoint::TVector &start, const Goal &goal)
     {
-        nodes_.emplace_back(-1, SpaceTimePoint(start, 0), NodeType::GUARD); // Add start
-        start_node_ = &nodes_.back();
+        Reserve(1);
+
+        start_node_ = AddNode(Node(-1, SpaceTimePoint(start, 0), NodeType::GUARD)); // Add start
 
         goal_nodes_.clear();
-        nodes_.emplace_back(-2, SpaceTimePoint(goal.pos, Config::N), NodeType::GUARD); // Add goal
-        goal_nodes_.push_back(&nodes_.back());
+        goal_nodes_.push_back(AddNode(Node(-2, SpaceTimePoint(goal.pos, Config::N), NodeType::GUARD))); // Add goal
     }
 
     void Graph::Initialize(const SpaceTimePoint::TVector &start, std::vector<Goal> &goals)
     {
-        nodes_.emplace_back(-1, SpaceTimePoint(start, 0), NodeType::GUARD); // Add start
-        start_node_ = &nodes_.back();
+        Reserve(goals.size());
+
+        start_node_ = AddNode(Node(-1, SpaceTimePoint(start, 0), NodeType::GUARD)); // Add start
 
         goal_nodes_.clear();
         for (auto &goal : goals) // Create multiple goals
         {
-            nodes_.emplace_back(-(int)goal_nodes_.size() - 2, SpaceTimePoint(goal.pos, Config::N), NodeType::GOAL); // Add goal
-            goal_nodes_.push_back(&nodes_.back());
-            goal.node = &nodes_.back();
+            int goal_handle = AddNode(Node(-(int)goal_nodes_.size() - 2, SpaceTimePoint(goal.pos, Config::N), NodeType::GOAL)); // Add goal
+            goal_nodes_.push_back(goal_handle);
+            goal.node = &nodes_[goal_handle];
         }
     }
 
-    Node *Graph::AddNode(const Node &node)
+    void Graph::Reserve(int num_goals)
+    {
+        // Each sample adds at most one node (a guard or a connector) and a connector adds two edges
+        nodes_.reserve(1 + num_goals + config_->n_samples_);
+        edges_.reserve(2 * config_->n_samples_);
+    }
+
+    int Graph::AddNode(const Node &node)
     {
+        ROSTOOLS_ASSERT(nodes_.size() < nodes_.capacity(), "Graph node storage exceeded, pointers to nodes would be invalidated");
 
         nodes_.emplace_back(node);
-        auto *result = &(nodes_.back());
 
-        return result;
+        int handle = nodes_.size() - 1;
+        if (node.type_ == NodeType::GUARD)
+            guards_.push_back(handle);
+
+        return handle;
+    }
+
+    int Graph::AddEdge(int a, int b)
+    {
+        ROSTOOLS_ASSERT(edges_.size() < edges_.capacity(), "Graph edge storage exceeded, pointers to edges would be invalidated");
+
+        // Edges are directed forward in time
+        const Node *first = &nodes_[a];
+        const Node *second = &nodes_[b];
+        if (second->point_.Time() < first->point_.Time())
+            std::swap(first, second);
+
+        edges_.emplace_back(first, second);
+        int edge = edges_.size() - 1;
+
+        nodes_[a].neighbours_.push_back(b);
+        nodes_[a].edges_.push_back(edge);
+
+        nodes_[b].neighbours_.push_back(a);
+        nodes_[b].edges_.push_back(edge);
+
+        return edge;
+    }
+
+    bool Graph::ReplaceNeighbour(int node, int neighbour_to_replace, int new_neighbour)
+    {
+        Node &cur_node = nodes_[node];
+        for (size_t i = 0; i < cur_node.neighbours_.size(); i++)
+        {
+            if (cur_node.neighbours_[i] != neighbour_to_replace)
+                continue;
+
+            int edge = AddEdge(new_neighbour, node);
+
+            // Replace the neighbour in place (AddEdge appended it to the end)
+            cur_node.neighbours_.pop_back();
+            cur_node.edges_.pop_back();
+            cur_node.neighbours_[i] = new_neighbour;
+            cur_node.edges_[i] = edge;
+
+            nodes_[neighbour_to_replace].replaced_ = true;
+            return true;
+        }
+
+        return false;
     }
 
-    std::vector<Node *> Graph::GetSharedNeighbours(const std::vector<Node *> &nodes)
+    std::vector<int> Graph::GetSharedNeighbours(const std::vector<int> &nodes) const
     {
         ROSTOOLS_ASSERT(nodes.size() == 2, "Expected 2 guards, but the number of nodes are not 2"); // Function only checks neighbours shared between 2 nodes
 
-        std::vector<Node *> shared_neighbours;
+        std::vector<int> shared_neighbours;
 
-        for (auto &neighbour : nodes[0]->neighbours_) // For neighbours of the first node
+        for (int neighbour : nodes_[nodes[0]].neighbours_) // For neighbours of the first node
         {
-            for (auto &other_neighbour : nodes[1]->neighbours_) // For neighbours of the second node
+            for (int other_neighbour : nodes_[nodes[1]].neighbours_) // For neighbours of the second node
             {
-                if (neighbour->id_ == other_neighbour->id_ ||
-                    (neighbour->type_ == NodeType::GOAL &&
-                     other_neighbour->type_ == NodeType::GOAL)) // If neighbours are the same, add them to the shared neighbours
+                if (neighbour == other_neighbour ||
+                    (nodes_[neighbour].type_ == NodeType::GOAL &&
+                     nodes_[other_neighbour].type_ == NodeType::GOAL)) // If neighbours are the same, add them to the shared neighbours
                     shared_neighbours.push_back(neighbour);
             }
         }
@@ -79,6 +135,8 @@ namespace GuidancePlanner
     void Graph::Clear()
     {
         nodes_.clear();
+        edges_.clear();
+        guards_.clear();
         current_id_ = 0;
     }
 
@@ -89,4 +147,4 @@ namespace GuidancePlanner
             std::cout << "Node: " << node << std::endl;
         }
     }
-} // namespace GuidancePlanner
\ No newline at end of file
+} // namespace GuidancePlanner
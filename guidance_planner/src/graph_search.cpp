@@ -7,61 +7,65 @@ using namespace GuidancePlanner;
 
 GraphSearch::GraphSearch() {}
 
-void GraphSearch::Search(const Graph &graph, unsigned int max_paths, std::vector<Node *> &L, std::vector<GeometricPath> &T, const Node *goal)
+void GraphSearch::Search(const Graph &graph, unsigned int max_paths, std::vector<int> &L, std::vector<int> &E, std::vector<GeometricPath> &T, int goal)
 {
   // Stop if the maximum number of paths was reached
   if (T.size() >= max_paths)
     return;
 
   // Get the last visited node
-  Node *l = L.back();
+  const Node &l = graph.GetNode(L.back());
 
   // Check for the goal
-  for (auto &neighbour : l->neighbours_)
+  for (size_t n = 0; n < l.neighbours_.size(); n++)
   {
-    if (neighbour->point_.Time() < l->point_.Time()) // Make edges directed forward in time
+    int neighbour = l.neighbours_[n];
+    if (graph.GetEdge(l.edges_[n]).getStart() != &l) // Make edges directed forward in time
       continue;
 
     if (HasBeenVisited(L, neighbour))
       continue;
 
     // If we have reached the goal
-    if (goal->id_ == neighbour->id_)
+    if (goal == neighbour)
     {
-      // Add this last node to the path
-      L.push_back(neighbour);
+      // Add this last edge to the path
+      E.push_back(l.edges_[n]);
 
       // @todo Check for topology equivalence here?
 
       // Add this path to the list
-      T.emplace_back(L); // Create a new path object
-      L.pop_back();
+      T.emplace_back(graph, E); // Create a new path object
+      E.pop_back();
       break;
     }
   }
 
   // Add nodes to L and recursive calls
-  for (auto &neighbour : l->neighbours_)
+  for (size_t n = 0; n < l.neighbours_.size(); n++)
   {
-    if (neighbour->point_.Time() < l->point_.Time()) // Make edges directed forward in time
+    int neighbour = l.neighbours_[n];
+    if (graph.GetEdge(l.edges_[n]).getStart() != &l) // Make edges directed forward in time
       continue;
 
-    if (HasBeenVisited(L, neighbour) || goal->id_ == neighbour->id_)
+    if (HasBeenVisited(L, neighbour) || goal == neighbour)
       continue;
 
     L.push_back(neighbour);
-    Search(graph, max_paths, L, T, goal); // Recursive search
+    E.push_back(l.edges_[n]);
+    Search(graph, max_paths, L, E, T, goal); // Recursive search
+    E.pop_back();
     L.pop_back();
   }
 }
 
-bool GraphSearch::HasBeenVisited(const std::vector<Node *> &L, const Node *node)
+bool GraphSearch::HasBeenVisited(const std::vector<int> &L, int node)
 {
-  for (auto &node_in_L : L)
+  for (int node_in_L : L)
   {
-    if (node_in_L->id_ == node->id_)
+    if (node_in_L == node)
       return true;
   }
 
   return false;
-}
\ No newline at end of file
+}
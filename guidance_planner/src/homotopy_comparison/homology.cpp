@@ -54,27 +54,17 @@ namespace GuidancePlanner
     // For each obstacle
     for (size_t obstacle_id = 0; obstacle_id < obstacles.size(); obstacle_id++)
     {
-      LoadObstacle(obstacle_id);
+      const Obstacle &obstacle = obstacles[obstacle_id];
+      if (!obstacle.is_static_)
+        LoadObstacle(obstacle_id);
 
       // Initialize the integration
       h = 0;
-      h += PathHValue(a, cached_a, obstacle_id); // Integrate over path A
+      h += PathHValue(a, cached_a, obstacle, obstacle_id); // Integrate over path A
 
-      // Connect end points of a and b
-      {
-        gsl_params_[0].start = a.GetEnd()->point_.PosTime();
-        gsl_params_[0].end = b.GetEnd()->point_.PosTime();
-
-        // double result = 0.;
-        // NumericalIntegration(result, &gsl_params_[0]);
-
-        double result, error;
-        gsl_integration_qag(&gsl_f_[0], 0, 1, GSL_ACCURACY, 0, GSL_POINTS, GSL_INTEG_GAUSS15, gsl_ws_[0], &result, &error);
+      h += LineHValue(a.GetEnd()->point_, b.GetEnd()->point_, obstacle); // Connect end points of a and b
 
-        h += result;
-      }
-
-      h -= PathHValue(b, cached_b, obstacle_id); // Integrate over path B
+      h -= PathHValue(b, cached_b, obstacle, obstacle_id); // Integrate over path B
 
       // If it is not zero, then these paths are homology distinct!
       if (std::abs(h) >= 1e-1)
@@ -105,25 +95,17 @@ namespace GuidancePlanner
     // For each obstacle
     for (size_t obstacle_id = 0; obstacle_id < obstacles.size(); obstacle_id++)
     {
-      LoadObstacle(obstacle_id);
+      const Obstacle &obstacle = obstacles[obstacle_id];
+      if (!obstacle.is_static_)
+        LoadObstacle(obstacle_id);
 
       // Initialize the integration
       h = 0;
-      h += PathHValue(a, cached_a, obstacle_id); // Integrate over path A
+      h += PathHValue(a, cached_a, obstacle, obstacle_id); // Integrate over path A
 
-      // Connect end points of a and b
-      {
-        gsl_params_[0].start = a.GetEnd()->point_.PosTime();
-        gsl_params_[0].end = b.GetEnd()->point_.PosTime();
+      h += LineHValue(a.GetEnd()->point_, b.GetEnd()->point_, obstacle); // Connect end points of a and b
 
-        double result, error;
-
-        gsl_integration_qag(&gsl_f_[0], 0, 1, GSL_ACCURACY, 0, GSL_POINTS, GSL_INTEG_GAUSS15, gsl_ws_[0], &result, &error);
-
-        h += result;
-      }
-
-      h -= PathHValue(b, cached_b, obstacle_id); // Integrate over path B
+      h -= PathHValue(b, cached_b, obstacle, obstacle_id); // Integrate over path B
       h_total += abs(h);
       // If is zero, keep checking the other obstacles
     }
@@ -285,7 +267,7 @@ namespace GuidancePlanner
     }
   }
 
-  double Homology::PathHValue(const GeometricPath &path, std::vector<double> &cached_h, const int obstacle_id)
+  double Homology::PathHValue(const GeometricPath &path, std::vector<double> &cached_h, const Obstacle &obstacle, const int obstacle_id)
   {
     if (obstacle_id < (int)cached_h.size())
       return cached_h[obstacle_id]; // Retrieve from cache
@@ -296,19 +278,12 @@ namespace GuidancePlanner
     // #pragma omp parallel for num_threads(8)
     for (size_t n = 1; n < integration_points.size(); n++) // From the start to the end of a
     {
-      double error;
-
       // #ifdef _OPENMP
       int thread_id = omp_get_thread_num();
       // #else
       // int thread_id = 0;
       // #endif
-      gsl_params_[thread_id].start = integration_points[n - 1].PosTime();
-      gsl_params_[thread_id].end = integration_points[n].PosTime();
-
-      // NumericalIntegration(results[n - 1], &gsl_params_[thread_id]);
-
-      gsl_integration_qag(&gsl_f_[thread_id], 0, 1, GSL_ACCURACY, 0, GSL_POINTS, GSL_INTEG_GAUSS15, gsl_ws_[thread_id], &results[n - 1], &error);
+      results[n - 1] = LineHValue(integration_points[n - 1], integration_points[n], obstacle, thread_id);
     }
 
     double h_value = 0;
@@ -319,6 +294,30 @@ namespace GuidancePlanner
     return h_value;
   }
 
+  double Homology::LineHValue(const SpaceTimePoint &start, const SpaceTimePoint &end, const Obstacle &obstacle, int thread_id)
+  {
+    if (obstacle.is_static_)
+      return StaticLineHValue(obstacle.positions_[0], start.Pos(), end.Pos());
+
+    gsl_params_[thread_id].start = start.PosTime();
+    gsl_params_[thread_id].end = end.PosTime();
+
+    // NumericalIntegration(result, &gsl_params_[thread_id]);
+
+    double result, error;
+    gsl_integration_qag(&gsl_f_[thread_id], 0, 1, GSL_ACCURACY, 0, GSL_POINTS, GSL_INTEG_GAUSS15, gsl_ws_[thread_id], &result, &error);
+    return result;
+  }
+
+  double Homology::StaticLineHValue(const Eigen::Vector2d &center, const Eigen::Vector2d &start, const Eigen::Vector2d &end)
+  {
+    // The obstacle loop runs vertically through the full horizon, such that over any closed path the H-value equals the
+    // winding number around the obstacle. A straight line contributes the (signed) angle it sweeps around the center.
+    Eigen::Vector2d from = start - center;
+    Eigen::Vector2d to = end - center;
+    return std::atan2(from(0) * to(1) - from(1) * to(0), from.dot(to)) / (2. * M_PI);
+  }
+
   inline void Homology::NumericalIntegration(double &result, void *params)
   {
     double num = 25.;
@@ -208,7 +208,7 @@ public:
             res.success = success;
             if (success)
             {
-                std::vector<GuidancePlanner::Node *> truth_vec_node;
+                std::vector<const GuidancePlanner::Node *> truth_vec_node;
                 for (size_t i_node = 0; i_node < req.truth.x.size(); i_node++)
                 {
                     SpaceTimePoint point(req.truth.x[i_node], req.truth.y[i_node], i_node);
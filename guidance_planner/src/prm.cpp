@@ -26,6 +26,8 @@ namespace GuidancePlanner
   {
     config_ = config;
 
+    homotopy_benchmarker_ = BENCHMARKERS.registerBenchmarker("homotopy_comparison");
+
     graph_.reset(new Graph(config));
 
     environment_ = std::make_shared<Environment>();
@@ -67,7 +69,7 @@ namespace GuidancePlanner
     done_ = false;
   }
 
-  void PRM::LoadData(const std::vector<Obstacle> &obstacles, const std::vector<Halfspace> &static_obstacles, const Eigen::Vector2d &start, const double orientation,
+  void PRM::LoadData(const ObstacleSnapshot &obstacles, const std::vector<Halfspace> &static_obstacles, const Eigen::Vector2d &start, const double orientation,
                      const Eigen::Vector2d &velocity, const std::vector<Goal> &goals)
   {
     {
@@ -143,17 +145,19 @@ namespace GuidancePlanner
     PRM_LOG("PRM::Update")
     done_ = false;
 
-    BENCHMARKERS.getBenchmarker("homotopy_comparison").reset();
+    BENCHMARKERS.reset(homotopy_benchmarker_);
 
     topology_comparison_->Clear();
     graph_->Clear();
     sampler_->Clear();
 
-    RosTools::Timer prm_timer(config_->timeout_ / 1000.);
+    RosTools::Timer prm_timer(config_->timeout_ / 1000., clock_);
     prm_timer.start();
 
     graph_->Initialize(start_, goals_);
 
+    std::vector<int> visible_guards;
+
     SampleNewPoints(); // Draw random samples
     PRM_LOG("New candidate nodes ready. Inserting them into the Visibility-PRM graph");
 
@@ -174,11 +178,11 @@ namespace GuidancePlanner
       bool sample_is_from_previous_iteration = i < (int)previous_nodes_.size();
 
       // Find the number of visible guards from this node
-      std::vector<Node *> visible_guards;
+      visible_guards.clear();
       FindVisibleGuards(sample.point, visible_guards);
 
       // Find out if at least one goal is visible, if it is, save it
-      Node *goal_node = nullptr;
+      int goal_node = -1;
       int goal_index = 0;
       for (size_t g = 0; g < graph_->goal_nodes_.size(); g++)
       {
@@ -190,7 +194,7 @@ namespace GuidancePlanner
         }
       }
 
-      bool goal_visible = goal_node != nullptr;
+      bool goal_visible = goal_node != -1;
 
       if (goal_visible)
       {
@@ -217,18 +221,19 @@ namespace GuidancePlanner
         Node new_node = sample_is_from_previous_iteration ? Node(graph_->GetNodeID(), previous_nodes_[i])
                                                           : Node(graph_->GetNodeID(), sample.point, NodeType::CONNECTOR);
 
-        Node *valid_goal = nullptr;
+        int valid_goal = -1;
         int valid_goal_index = 0;
-        for (size_t g = goal_index; g < graph_->goal_nodes_.size() && valid_goal == nullptr; g++)
+        for (size_t g = goal_index; g < graph_->goal_nodes_.size() && valid_goal == -1; g++)
         {
           if (g != goal_index && !IsGoalVisible(sample.point, g))
             continue;
 
-          valid_goal = CheckGoalConnection(new_node, visible_guards[0], graph_->goal_nodes_[g]);
+          if (CheckGoalConnection(new_node, visible_guards[0], graph_->goal_nodes_[g]))
+            valid_goal = graph_->goal_nodes_[g];
           valid_goal_index = g;
         }
 
-        if (valid_goal == nullptr) // Add a connector if there was a valid goal
+        if (valid_goal == -1) // Add a connector if there was a valid goal
           continue;
 
         visible_guards.push_back(valid_goal);
@@ -239,12 +244,11 @@ namespace GuidancePlanner
         if (valid_goal_index == graph_->goal_nodes_.size() - 1)
           continue;
 
-        if (Goal::FindGoalWithNode(goals_, graph_->goal_nodes_[valid_goal_index + 1]).cost == Goal::FindGoalWithNode(goals_, graph_->goal_nodes_[valid_goal_index]).cost)
+        if (Goal::FindGoalWithNode(goals_, &graph_->GetNode(graph_->goal_nodes_[valid_goal_index + 1])).cost ==
+            Goal::FindGoalWithNode(goals_, &graph_->GetNode(graph_->goal_nodes_[valid_goal_index])).cost)
         {
           // Swap the goals
-          auto *temp = graph_->goal_nodes_[valid_goal_index];
-          graph_->goal_nodes_[valid_goal_index] = graph_->goal_nodes_[valid_goal_index + 1];
-          graph_->goal_nodes_[valid_goal_index + 1] = temp;
+          std::swap(graph_->goal_nodes_[valid_goal_index], graph_->goal_nodes_[valid_goal_index + 1]);
         }
       }
     }
@@ -256,14 +260,11 @@ namespace GuidancePlanner
   }
 
   // IsGoalValid
-  Node *PRM::CheckGoalConnection(Node &new_node, Node *guard, Node *goal) const
+  bool PRM::CheckGoalConnection(Node &new_node, int guard, int goal) const
   {
-    GeometricPath new_path({guard, &new_node, goal}); // Construct the path for this goal
+    GeometricPath new_path({&graph_->GetNode(guard), &new_node, &graph_->GetNode(goal)}); // Construct the path for this goal
 
-    if (new_path.isValid(config_, start_velocity_, orientation_))
-      return goal;
-
-    return nullptr;
+    return new_path.isValid(config_, start_velocity_, orientation_);
   }
 
   void PRM::SampleNewPoints()
@@ -297,15 +298,16 @@ namespace GuidancePlanner
     }
   }
 
-  void PRM::AddSample(int i, SpaceTimePoint &sample, const std::vector<Node *> guards, bool sample_is_from_previous_iteration)
+  void PRM::AddSample(int i, SpaceTimePoint &sample, const std::vector<int> &guards, bool sample_is_from_previous_iteration)
   {
-    PRM_LOG("Guards: " << *guards[0] << " and " << *guards[1]);
+    const Node *guard_a = &graph_->GetNode(guards[0]);
+    const Node *guard_b = &graph_->GetNode(guards[1]);
+    PRM_LOG("Guards: " << *guard_a << " and " << *guard_b);
 
     // if (!ConnectionIsValid(guards[0], guards[1], sample)) // Check if the proposed connection is valid
-    Node temporary_node(-1e2, sample, NodeType::CONNECTOR);                     // temporary new node
-    int g0_index = guards[0]->point_.Time() < guards[1]->point_.Time() ? 0 : 1; // Which guard is first
-    int g1_index = g0_index == 0 ? 1 : 0;
-    GeometricPath temporary_path({guards[g0_index], &temporary_node, guards[g1_index]});
+    Node temporary_node(-1e2, sample, NodeType::CONNECTOR); // temporary new node
+    bool a_is_first = guard_a->point_.Time() < guard_b->point_.Time(); // Which guard is first
+    GeometricPath temporary_path({a_is_first ? guard_a : guard_b, &temporary_node, a_is_first ? guard_b : guard_a});
 
     if (!temporary_path.isValid(config_, start_velocity_, orientation_)) // Check if the proposed connection is valid
       return;
@@ -315,28 +317,28 @@ namespace GuidancePlanner
                         : Node(graph_->GetNodeID(), sample, NodeType::CONNECTOR);
     new_node.type_ = NodeType::CONNECTOR;
 
-    std::vector<Node *> shared_neighbours;
+    std::vector<int> shared_neighbours;
     shared_neighbours = graph_->GetSharedNeighbours(guards); // Get all nodes with the same neighbours. The goal guards count as one.
     PRM_LOG("Found " << shared_neighbours.size() << " shared neighbours");
 
     GeometricPath new_path, other_path;
     if (shared_neighbours.size() > 0)
-      new_path = GeometricPath({guards[0], &new_node, guards[1]});
+      new_path = GeometricPath({guard_a, &new_node, guard_b});
 
     bool path_is_distinct = true;
-    for (auto &neighbour : shared_neighbours)
+    for (int neighbour : shared_neighbours)
     {
-      ROSTOOLS_ASSERT(neighbour->type_ == NodeType::CONNECTOR, "Shared neighbours should not be guards");
-      other_path = GeometricPath({guards[0], neighbour, guards[1]});
+      ROSTOOLS_ASSERT(graph_->GetNode(neighbour).type_ == NodeType::CONNECTOR, "Shared neighbours should not be guards");
+      other_path = GeometricPath({guard_a, &graph_->GetNode(neighbour), guard_b});
 
       if (AreHomotopicEquivalent(new_path, other_path))
       {
-        PRM_LOG("Segment of the new connector is homotopically equivalent to that of " << *neighbour);
+        PRM_LOG("Segment of the new connector is homotopically equivalent to that of " << graph_->GetNode(neighbour));
         path_is_distinct = false;
 
         if (FirstPathIsBetter(new_path, other_path))
         {
-          PRM_LOG("Replacing existing node " << *neighbour << "with faster node " << new_node
+          PRM_LOG("Replacing existing node " << graph_->GetNode(neighbour) << "with faster node " << new_node
                                              << " (difference in length: " << other_path.Length3D() - new_path.Length3D() << " = "
                                              << other_path.Length3D() - new_path.Length3D() / other_path.Length3D() << "%)");
           ReplaceConnector(new_node, neighbour, guards);
@@ -382,7 +384,7 @@ namespace GuidancePlanner
 
   void PRM::PropagateNode(const Node &node, const GeometricPath *path)
   {
-    previous_nodes_.push_back(node); // Copy the given node to save it (by value, because the graph will be reset)
+    previous_nodes_.emplace_back(node.id_, node); // Copy the given node to save it (by value, because the graph will be reset)
 
     if (!config_->dynamically_propagate_nodes_) // Setting must be enabled in general
       return;
@@ -405,7 +407,7 @@ namespace GuidancePlanner
       {
 
         int first_node_id = 2; // Cannot be the start, cannot be the first connector
-        auto *next_node = path->GetConnections()[0]->getEnd();
+        auto *next_node = path->GetConnection(0).getEnd();
 
         // Sample halfway up to the next node (0.5(T2 + T1) / (T_end - T_start)) \in [0, 1]
         propagated_node.point_ = (*path)((0.5 * (next_node->point_.Time() + node.point_.Time())) /
@@ -421,8 +423,8 @@ namespace GuidancePlanner
 
   bool PRM::IsGoalVisible(SpaceTimePoint sample, int goal_index) const
   {
-    Node *goal_node = graph_->goal_nodes_[goal_index];
-    return environment_->IsVisible(sample, goal_node->point_);
+    const Node &goal_node = graph_->GetNode(graph_->goal_nodes_[goal_index]);
+    return environment_->IsVisible(sample, goal_node.point_);
   }
   // SpaceTimePoint PRM::SampleUniformly3DReferencePath()
   // {
@@ -439,43 +441,32 @@ namespace GuidancePlanner
   //   return SpaceTimePoint(point(0), point(1), random_generator_.Int(Config::N - 2) + 1);
   // }
 
-  void PRM::FindVisibleGuards(SpaceTimePoint sample, std::vector<Node *> &visible_guards)
+  void PRM::FindVisibleGuards(SpaceTimePoint sample, std::vector<int> &visible_guards)
   {
-    for (Node &node : graph_->nodes_)
+    for (int guard : graph_->GetGuards())
     {
-      if (node.type_ == NodeType::GUARD)
-      {
-        if (environment_->IsVisible(sample, node.point_))
-          visible_guards.push_back(&node);
-      }
+      if (environment_->IsVisible(sample, graph_->GetNode(guard).point_))
+        visible_guards.push_back(guard);
     }
   }
 
-  void PRM::ReplaceConnector(Node &new_node, Node *neighbour, const std::vector<Node *> &visible_guards)
+  void PRM::ReplaceConnector(Node &new_node, int neighbour, const std::vector<int> &visible_guards)
   {
     // Add the new node to the graph (note that we are keeping the old one around, but setting its "replaced" flag to true)
-    Node *new_node_ptr = graph_->AddNode(new_node);
-
-    // Set its neighbours
-    new_node_ptr->neighbours_.push_back(visible_guards[0]);
-    new_node_ptr->neighbours_.push_back(visible_guards[1]);
+    int new_node_handle = graph_->AddNode(new_node);
 
-    // replace the neighbours of the guards with the new node
-    visible_guards[0]->ReplaceNeighbour(neighbour, new_node_ptr);
-    visible_guards[1]->ReplaceNeighbour(neighbour, new_node_ptr);
+    // Replace the neighbours of the guards with the new node (this also connects the new node to the guards)
+    graph_->ReplaceNeighbour(visible_guards[0], neighbour, new_node_handle);
+    graph_->ReplaceNeighbour(visible_guards[1], neighbour, new_node_handle);
   }
 
-  void PRM::AddNewConnector(Node &new_node, const std::vector<Node *> &visible_guards)
+  void PRM::AddNewConnector(Node &new_node, const std::vector<int> &visible_guards)
   {
-    Node *new_node_ptr = graph_->AddNode(new_node); // We add the new node
-
-    // Set its neighbours
-    new_node_ptr->neighbours_.push_back(visible_guards[0]);
-    new_node_ptr->neighbours_.push_back(visible_guards[1]);
+    int new_node_handle = graph_->AddNode(new_node); // We add the new node
 
-    // Add the new node to the neighbours of the visible guards
-    visible_guards[0]->neighbours_.push_back(new_node_ptr);
-    visible_guards[1]->neighbours_.push_back(new_node_ptr);
+    // Connect it to the visible guards
+    graph_->AddEdge(new_node_handle, visible_guards[0]);
+    graph_->AddEdge(new_node_handle, visible_guards[1]);
   }
 
   void PRM::AddGuard(int i, SpaceTimePoint &sample)
@@ -492,9 +483,10 @@ namespace GuidancePlanner
 
   bool PRM::AreHomotopicEquivalent(const GeometricPath &a, const GeometricPath &b)
   {
-    BENCHMARKERS.getBenchmarker("homotopy_comparison").start();
+    RosTools::Benchmarker &benchmarker = BENCHMARKERS.getBenchmarker(homotopy_benchmarker_);
+    benchmarker.start();
     bool homology_result = topology_comparison_->AreEquivalent(a, b, *environment_);
-    BENCHMARKERS.getBenchmarker("homotopy_comparison").stop();
+    benchmarker.stop();
 
     return homology_result;
   }
@@ -561,7 +553,7 @@ namespace GuidancePlanner
 
   void PRM::saveData(RosTools::DataSaver &data_saver)
   {
-    data_saver.AddData("homotopy_comparison_runtime", BENCHMARKERS.getBenchmarker("homotopy_comparison").getTotalDuration());
+    data_saver.AddData("homotopy_comparison_runtime", BENCHMARKERS.getAggregate(homotopy_benchmarker_).getTotalDuration());
   }
 
 } // namespace GuidancePlanner
@@ -6,14 +6,45 @@
 
 namespace GuidancePlanner
 {
-    Connection::Connection(Node *a, Node *b)
+    Connection::Connection(const Node *a, const Node *b)
     {
         a_ = a;
         b_ = b;
+
+        if (Config::use_dubins_path_)
+        {
+            type_ = ConnectionType::DUBINS;
+            InitializeDubins();
+        }
+        else
+        {
+            type_ = ConnectionType::STRAIGHT;
+            length_ = (a_->point_.Pos() - b_->point_.Pos()).norm();
+            length_with_time_ = (a_->point_.MapToTime() - b_->point_.MapToTime()).norm();
+        }
     }
 
+    void Connection::Rebind(const Node *a, const Node *b)
+    {
+        a_ = a;
+        b_ = b;
+    }
+
+    SpaceTimePoint Connection::operator()(double s) const // [0-1] -> x
+    {
+        if (type_ == ConnectionType::DUBINS)
+            return SampleDubins(s);
+
+        ROSTOOLS_ASSERT(s >= 0. - 1e-3 && s <= 1. + 1e-3, "StraightConnection only accepts s in [0, 1]");
+
+        return RosTools::InterpolateLinearly(0., 1., s, a_->point_, b_->point_);
+    };
+
     bool Connection::isValid(Config *config, double orientation) const
     {
+        if (!valid_)
+            return false;
+
         // Check if the connection moves forward in the direction of the path
         if (config->enable_forward_filter_)
         {
@@ -55,47 +86,39 @@ namespace GuidancePlanner
 
     void Connection::getIntegrationNodes(bool is_first, std::vector<SpaceTimePoint> &nodes) const
     {
+        if (type_ == ConnectionType::DUBINS)
+        {
+            // Sample the curve (same resolution as used for its length with time)
+            int start = is_first ? 0 : 1;
+            int i = 0;
+            for (double s = 0.; s <= 1.0; s += 0.05, i++)
+            {
+                if (i >= start)
+                    nodes.push_back(SampleDubins(s));
+            }
+            return;
+        }
+
         if (is_first)
             nodes.push_back(a_->point_);
 
         nodes.push_back(b_->point_);
     }
 
-    // STRAIGHT //
-
-    StraightConnection::StraightConnection(Node *a, Node *b) : Connection(a, b) {}
-
-    SpaceTimePoint StraightConnection::operator()(double s) const // [0-1] -> x
-    {
-        ROSTOOLS_ASSERT(s >= 0. - 1e-3 && s <= 1. + 1e-3, "StraightConnection only accepts s in [0, 1]");
-
-        return RosTools::InterpolateLinearly(0., 1., s, a_->point_, b_->point_);
-    };
-
-    double StraightConnection::length() const
-    {
-        return (a_->point_.Pos() - b_->point_.Pos()).norm();
-    }
-
-    double StraightConnection::lengthWithTime() const
-    {
-        return (a_->point_.MapToTime() - b_->point_.MapToTime()).norm();
-    }
-
     // DUBINS //
 
-    DubinsConnection::DubinsConnection(Node *a, Node *b) : Connection(a, b)
+    void Connection::InitializeDubins()
     {
         double angle_a = 0.; // Could use the start orientation
         double angle_b = 0.;
         if (a_->point_.numStates() == 3)
         {
-            angle_a = a->point_.State()(2);
-            angle_b = b->point_.State()(2);
+            angle_a = a_->point_.State()(2);
+            angle_b = b_->point_.State()(2);
         }
 
-        double q0[] = {a->point_.Pos()(0), a->point_.Pos()(1), angle_a};
-        double q1[] = {b->point_.Pos()(0), b->point_.Pos()(1), angle_b};
+        double q0[] = {a_->point_.Pos()(0), a_->point_.Pos()(1), angle_a};
+        double q1[] = {b_->point_.Pos()(0), b_->point_.Pos()(1), angle_b};
         double turning_radius = Config::turning_radius_; // 1.0;
 
         int result = dubins_shortest_path(&path_, q0, q1, turning_radius);
@@ -110,23 +133,19 @@ namespace GuidancePlanner
 
         length_ = dubins_path_length(&path_);
 
+        SpaceTimePoint previous_sample;
         for (double s = 0.; s <= 1.0; s += 0.05)
         {
-            sampled_path_.push_back(this->operator()(s));
+            SpaceTimePoint sample = SampleDubins(s);
 
             if (s > 0)
-                length_with_time_ += (sampled_path_.back().MapToTime() - sampled_path_[sampled_path_.size() - 2].MapToTime()).norm();
-        }
-    }
+                length_with_time_ += (sample.MapToTime() - previous_sample.MapToTime()).norm();
 
-    void DubinsConnection::getIntegrationNodes(bool is_first, std::vector<SpaceTimePoint> &nodes) const
-    {
-        int start = is_first ? 0 : 1;
-        for (int i = start; i < sampled_path_.size(); i++)
-            nodes.push_back(sampled_path_[i]);
+            previous_sample = sample;
+        }
     }
 
-    SpaceTimePoint DubinsConnection::operator()(double s) const // [0-1] -> x
+    SpaceTimePoint Connection::SampleDubins(double s) const // [0-1] -> x
     {
         s *= length_;
 
@@ -153,22 +172,4 @@ namespace GuidancePlanner
         return result;
     }
 
-    bool DubinsConnection::isValid(Config *config, double orientation) const
-    {
-        if (!valid_)
-            return false;
-
-        return Connection::isValid(config, orientation);
-    }
-
-    double DubinsConnection::length() const
-    {
-        return length_;
-    }
-
-    double DubinsConnection::lengthWithTime() const
-    {
-        return length_with_time_;
-    }
-
-} // namespace GuidancePlanner
\ No newline at end of file
+} // namespace GuidancePlanner
@@ -16,21 +16,6 @@ namespace GuidancePlanner
         replaced_ = false;
     }
 
-    bool Node::ReplaceNeighbour(Node *node_to_replace, Node *new_node)
-    {
-        for (auto &neighbour : neighbours_)
-        {
-            if (neighbour->id_ == node_to_replace->id_)
-            {
-                neighbour = new_node;
-                node_to_replace->replaced_ = true;
-                return true;
-            }
-        }
-
-        return false;
-    }
-
     double Node::DistanceTo(const Node &other)
     {
         return (other.point_.MapToTime() - point_.MapToTime()).norm();
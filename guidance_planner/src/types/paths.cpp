@@ -1,5 +1,6 @@
 #include <guidance_planner/types/paths.h>
 
+#include <guidance_planner/graph.h>
 #include <guidance_planner/utils.h>
 
 #include <ros_tools/math.h>
@@ -8,26 +9,27 @@
 namespace GuidancePlanner
 {
     /** @brief Convert a vector of nodes to a path directly */
-    GeometricPath::GeometricPath(const std::vector<Node *> &nodes)
+    GeometricPath::GeometricPath(const std::vector<const Node *> &nodes)
     {
-        std::vector<Node *> sorted_nodes = nodes;
+        std::vector<const Node *> sorted_nodes = nodes;
 
         // Ensure that nodes are ordered with correct causality
         std::sort(sorted_nodes.begin(), sorted_nodes.end(), [](const Node *a, const Node *b)
                   { return a->point_.Time() < b->point_.Time(); });
 
+        connections_.reserve(sorted_nodes.size() - 1);
         for (size_t i = 1; i < sorted_nodes.size(); i++)
-        {
-            // Connect the nodes
-            if (Config::use_dubins_path_)
-                connections_.push_back(std::make_shared<DubinsConnection>(sorted_nodes[i - 1], sorted_nodes[i]));
-            else
-                connections_.push_back(std::make_shared<StraightConnection>(sorted_nodes[i - 1], sorted_nodes[i]));
-        }
+            connections_.emplace_back(sorted_nodes[i - 1], sorted_nodes[i]); // Connect the nodes
 
         ComputeDistanceVector();
     }
 
+    GeometricPath::GeometricPath(const Graph &graph, const std::vector<int> &edges)
+        : graph_edges_(&graph.GetEdges()), edges_(edges)
+    {
+        ComputeDistanceVector();
+    }
+
     /** @brief Evaluate this path at 0 <= s <= 1
      *  @return Interpolated point in discrete time space (i.e., k in [0, N]) */
     SpaceTimePoint GeometricPath::operator()(double s) const
@@ -39,13 +41,13 @@ namespace GuidancePlanner
 
         s *= aggregated_distances_.back(); // Map to [0, D]
 
-        for (size_t c = 0; c < connections_.size(); c++)
+        for (size_t c = 0; c < NumConnections(); c++)
         {
             if (s <= aggregated_distances_[c + 1])
             {
                 double local_s = s - aggregated_distances_[c];
-                local_s = local_s / connections_[c]->length();
-                return connections_[c]->operator()(local_s);
+                local_s = local_s / GetConnection(c).length();
+                return GetConnection(c)(local_s);
             }
         }
 
@@ -53,6 +55,20 @@ namespace GuidancePlanner
         return SpaceTimePoint();
     }
 
+    SpaceTimePoint GeometricPath::AtTime(double k, size_t &cursor) const
+    {
+        // Move forward to the first connection that ends after k
+        while (cursor + 1 < NumConnections() && GetConnection(cursor).getEnd()->point_.Time() < k)
+            cursor++;
+
+        const Connection &connection = GetConnection(cursor);
+        double t_start = connection.getStart()->point_.Time();
+        double t_end = connection.getEnd()->point_.Time();
+
+        double local_s = t_end > t_start ? std::min(std::max((k - t_start) / (t_end - t_start), 0.), 1.) : 1.;
+        return connection(local_s);
+    }
+
     bool GeometricPath::isValid(Config *config,
                                 const Eigen::Vector2d &start_velocity, double start_orientation)
     {
@@ -61,12 +77,12 @@ namespace GuidancePlanner
 
         validity_checked_ = true;
 
-        ROSTOOLS_ASSERT(connections_.size() >= 2, "Paths must have at least 2 connections");
+        ROSTOOLS_ASSERT(NumConnections() >= 2, "Paths must have at least 2 connections");
 
         // Check all connections
-        for (auto &connection : connections_)
+        for (size_t c = 0; c < NumConnections(); c++)
         {
-            if (!connection->isValid(config, start_orientation))
+            if (!GetConnection(c).isValid(config, start_orientation))
             {
                 valid_ = false;
                 return false;
@@ -91,15 +107,15 @@ namespace GuidancePlanner
 
             std::vector<double> x = {
                 GetStart()->point_.Pos()(0),
-                connections_[0]->getEnd()->point_.Pos()(0),
+                GetConnection(0).getEnd()->point_.Pos()(0),
                 GetEnd()->point_.Pos()(0)};
             std::vector<double> y = {
                 GetStart()->point_.Pos()(1),
-                connections_[0]->getEnd()->point_.Pos()(1),
+                GetConnection(0).getEnd()->point_.Pos()(1),
                 GetEnd()->point_.Pos()(1)};
             std::vector<double> t = {
                 GetStart()->point_.Time() * Config::DT,
-                connections_[0]->getEnd()->point_.Time() * Config::DT,
+                GetConnection(0).getEnd()->point_.Time() * Config::DT,
                 GetEnd()->point_.Time() * Config::DT};
 
             // Construct a spline (with initial velocity if starting at t = 0)
@@ -126,14 +142,15 @@ namespace GuidancePlanner
         return true;
     }
 
-    std::vector<Node *> GeometricPath::GetNodes() const
+    std::vector<const Node *> GeometricPath::GetNodes() const
     {
-        std::vector<Node *> nodes;
-        for (auto &connection : connections_)
+        std::vector<const Node *> nodes;
+        nodes.reserve(NumConnections() + 1);
+        for (size_t c = 0; c < NumConnections(); c++)
         {
-            nodes.push_back(connection->getStart());
+            nodes.push_back(GetConnection(c).getStart());
         }
-        nodes.push_back(connections_.back()->getEnd());
+        nodes.push_back(GetEnd());
 
         return nodes;
     }
@@ -141,9 +158,9 @@ namespace GuidancePlanner
     std::vector<SpaceTimePoint> GeometricPath::GetIntegrationNodes() const
     {
         std::vector<SpaceTimePoint> integration_nodes;
-        for (size_t c = 0; c < connections_.size(); c++)
+        for (size_t c = 0; c < NumConnections(); c++)
         {
-            connections_[c]->getIntegrationNodes(c == 0, integration_nodes);
+            GetConnection(c).getIntegrationNodes(c == 0, integration_nodes);
         }
         return integration_nodes;
     }
@@ -156,16 +173,17 @@ namespace GuidancePlanner
         int cur_k = 1;
         points.emplace_back(GetStart()->point_.Pos());
 
-        for (size_t i = 0; i < connections_.size(); i++)
+        for (size_t i = 0; i < NumConnections(); i++)
         {
-            while (cur_k < connections_[i]->getEnd()->point_.Time())
+            const Connection &connection = GetConnection(i);
+            while (cur_k < connection.getEnd()->point_.Time())
             {
                 points.emplace_back(RosTools::InterpolateLinearly(
-                    connections_[i]->getStart()->point_.Time(),
-                    connections_[i]->getEnd()->point_.Time(),
+                    connection.getStart()->point_.Time(),
+                    connection.getEnd()->point_.Time(),
                     cur_k,
-                    connections_[i]->getStart()->point_.Pos(),
-                    connections_[i]->getEnd()->point_.Pos()));
+                    connection.getStart()->point_.Pos(),
+                    connection.getEnd()->point_.Pos()));
 
                 cur_k++;
             }
@@ -183,8 +201,8 @@ namespace GuidancePlanner
     double GeometricPath::Length3D() const
     {
         double length = 0.;
-        for (auto &connection : connections_)
-            length += connection->lengthWithTime(); // Length including the time dimension
+        for (size_t c = 0; c < NumConnections(); c++)
+            length += GetConnection(c).lengthWithTime(); // Length including the time dimension
         return length;
     }
 
@@ -220,8 +238,8 @@ namespace GuidancePlanner
     {
         std::vector<Eigen::Vector3d> result;
 
-        for (auto &connection : connections_)
-            result.emplace_back(connection->getStart()->point_.PosTime());
+        for (size_t c = 0; c < NumConnections(); c++)
+            result.emplace_back(GetConnection(c).getStart()->point_.PosTime());
 
         result.emplace_back(GetEnd()->point_.PosTime());
         return result;
@@ -229,9 +247,9 @@ namespace GuidancePlanner
 
     bool GeometricPath::ContainsNode(const Node &node) const
     {
-        for (auto &connection : connections_)
+        for (size_t c = 0; c < NumConnections(); c++)
         {
-            if (connection->getStart()->id_ == node.id_)
+            if (GetConnection(c).getStart()->id_ == node.id_)
                 return true;
         }
         if (GetEnd()->id_ == node.id_)
@@ -240,44 +258,49 @@ namespace GuidancePlanner
         return false;
     }
 
-    void GeometricPath::Clear() { connections_.clear(); }
+    void GeometricPath::Clear()
+    {
+        graph_edges_ = nullptr;
+        edges_.clear();
+        connections_.clear();
+    }
 
     void GeometricPath::ComputeDistanceVector()
     {
         aggregated_distances_.clear();
-        aggregated_distances_.reserve(connections_.size() + 1); // Allocate space
+        aggregated_distances_.reserve(NumConnections() + 1); // Allocate space
 
         aggregated_distances_.push_back(0.);
 
         double cur_dist = 0.;
-        for (auto &connection : connections_)
+        for (size_t c = 0; c < NumConnections(); c++)
         {
-            cur_dist += connection->length();
+            cur_dist += GetConnection(c).length();
             aggregated_distances_.push_back(cur_dist);
         }
     }
 
-    Node *GeometricPath::GetStart() const { return connections_[0]->getStart(); }
-    Node *GeometricPath::GetEnd() const { return connections_.back()->getEnd(); }
+    const Node *GeometricPath::GetStart() const { return GetConnection(0).getStart(); }
+    const Node *GeometricPath::GetEnd() const { return GetConnection(NumConnections() - 1).getEnd(); }
 
     bool operator==(const GeometricPath &a, const GeometricPath &b)
     {
 
-        if (a.GetConnections().size() != b.GetConnections().size())
+        if (a.NumConnections() != b.NumConnections())
             return false;
 
-        for (size_t i = 0; i < a.GetConnections().size(); i++)
+        for (size_t i = 0; i < a.NumConnections(); i++)
         {
             // If we do not have two goals (they are always equal)
-            if (!(a.GetConnections()[i]->getStart()->type_ == NodeType::GOAL &&
-                  b.GetConnections()[i]->getStart()->type_ == NodeType::GOAL))
+            if (!(a.GetConnection(i).getStart()->type_ == NodeType::GOAL &&
+                  b.GetConnection(i).getStart()->type_ == NodeType::GOAL))
             {
-                if (a.GetConnections()[i]->getStart()->id_ != b.GetConnections()[i]->getStart()->id_) // Then if they do not have the same ID, these are not the same paths!
+                if (a.GetConnection(i).getStart()->id_ != b.GetConnection(i).getStart()->id_) // Then if they do not have the same ID, these are not the same paths!
                     return false;
 
-                if (i == a.GetConnections().size() - 1)
+                if (i == a.NumConnections() - 1)
                 {
-                    if (a.GetConnections()[i]->getEnd()->id_ != b.GetConnections()[i]->getEnd()->id_) // Then if they do not have the same ID, these are not the same paths!
+                    if (a.GetConnection(i).getEnd()->id_ != b.GetConnection(i).getEnd()->id_) // Then if they do not have the same ID, these are not the same paths!
                         return false;
                 }
             }
@@ -289,9 +312,9 @@ namespace GuidancePlanner
     std::ostream &operator<<(std::ostream &stream, const GeometricPath &path)
     {
         stream << "Path: [";
-        for (auto &connection : path.GetConnections())
+        for (size_t c = 0; c < path.NumConnections(); c++)
         {
-            stream << *connection->getStart() << ", ";
+            stream << *path.GetConnection(c).getStart() << ", ";
         }
         stream << *path.GetEnd() << ", ";
         stream << "\b\b]";
@@ -299,11 +322,15 @@ namespace GuidancePlanner
         return stream;
     }
 
-    StandaloneGeometricPath::StandaloneGeometricPath(const std::list<Node> &nodes)
+    StandaloneGeometricPath::StandaloneGeometricPath(const std::vector<Node> &nodes)
     {
         saved_nodes_ = nodes;
 
-        std::vector<Node *> node_ptrs;
+        // Order the nodes as they will be in the path, such that connection c connects saved nodes c and c + 1
+        std::stable_sort(saved_nodes_.begin(), saved_nodes_.end(), [](const Node &a, const Node &b)
+                         { return a.point_.Time() < b.point_.Time(); });
+
+        std::vector<const Node *> node_ptrs;
         for (auto &node : saved_nodes_)
             node_ptrs.push_back(&node);
 
@@ -312,23 +339,44 @@ namespace GuidancePlanner
 
     StandaloneGeometricPath::StandaloneGeometricPath(const GeometricPath &other)
     {
-        saved_nodes_.clear();
+        if (other.NumConnections() == 0)
+            return;
+
+        // Copy the nodes (without their graph connectivity) and the connections
+        saved_nodes_.reserve(other.NumConnections() + 1);
         for (auto &node : other.GetNodes())
-            saved_nodes_.emplace_back(*node);
+            saved_nodes_.emplace_back(node->id_, *node);
+
+        path.connections_.reserve(other.NumConnections());
+        for (size_t c = 0; c < other.NumConnections(); c++)
+            path.connections_.push_back(other.GetConnection(c));
+
+        path.aggregated_distances_ = other.aggregated_distances_;
 
-        path = GeometricPath(other.GetNodes());
+        BindToSavedNodes();
     }
 
-    // To cast to a GeometricPath
-    StandaloneGeometricPath::operator GeometricPath &()
+    StandaloneGeometricPath::StandaloneGeometricPath(const StandaloneGeometricPath &other)
+        : path(other.path), saved_nodes_(other.saved_nodes_)
     {
-        std::vector<Node *> node_ptrs;
-        for (auto &node : saved_nodes_)
-            node_ptrs.push_back(&node);
+        BindToSavedNodes();
+    }
 
-        path = GeometricPath(node_ptrs);
+    StandaloneGeometricPath &StandaloneGeometricPath::operator=(const StandaloneGeometricPath &other)
+    {
+        if (this != &other)
+        {
+            path = other.path;
+            saved_nodes_ = other.saved_nodes_;
+            BindToSavedNodes();
+        }
+        return *this;
+    }
 
-        return path;
+    void StandaloneGeometricPath::BindToSavedNodes()
+    {
+        for (size_t c = 0; c < path.connections_.size(); c++)
+            path.connections_[c].Rebind(&saved_nodes_[c], &saved_nodes_[c + 1]);
     }
 
     IDAssigner::IDAssigner(int num_objects)
@@ -51,11 +51,22 @@ namespace GuidancePlanner
         }
     }
 
-    Obstacle::Obstacle(int id, const std::vector<Eigen::Vector2d> &positions, double radius)
+    Obstacle::Obstacle(int id, std::vector<Eigen::Vector2d> positions, double radius, bool is_static)
     {
         id_ = id;
-        positions_ = positions;
+        positions_ = std::move(positions);
         radius_ = radius;
+        is_static_ = is_static;
+    }
+
+    bool Obstacle::HasStaticPrediction() const
+    {
+        for (auto &position : positions_)
+        {
+            if ((position - positions_[0]).squaredNorm() > 1e-12)
+                return false;
+        }
+        return true;
     }
 
     // Node::Node(int id, const SpaceTimePoint &point, const NodeType &node_type)
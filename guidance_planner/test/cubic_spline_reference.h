@@ -0,0 +1,133 @@
+#ifndef GUIDANCE_PLANNER_TEST_CUBIC_SPLINE_REFERENCE_H
+#define GUIDANCE_PLANNER_TEST_CUBIC_SPLINE_REFERENCE_H
+
+#include <guidance_planner/config.h>
+#include <guidance_planner/cubic_spline.h>
+#include <guidance_planner/types/types.h>
+
+#include <ros_tools/math.h>
+
+#include <Eigen/Dense>
+
+namespace GuidancePlanner
+{
+    /** @brief Access to the control points of a spline, to compare the optimization against the reference below */
+    struct CubicSpline3DAccess
+    {
+        static ControlPoints &controlPoints(CubicSpline3D &spline) { return spline.control_points_; }
+        static ControlPoints &initialControlPoints(CubicSpline3D &spline) { return spline.initial_control_points_; }
+        static Config *config(CubicSpline3D &spline) { return spline.config_; }
+        static Eigen::MatrixXd velocitySplinePoints(CubicSpline3D &spline) { return spline.ComputeVelocitySplinePoints(); }
+    };
+
+    /**
+     * @brief The dense optimization that CubicSpline3D::Optimize replaced: the QP is assembled into dense matrices and solved
+     * with a dense inverse, followed by the projection from the obstacles. Returns the optimized control points.
+     */
+    inline Eigen::MatrixXd ReferenceOptimize(CubicSpline3D spline, const std::vector<Obstacle> &obstacles)
+    {
+        ControlPoints &control_points = CubicSpline3DAccess::controlPoints(spline);
+        ControlPoints &initial_control_points = CubicSpline3DAccess::initialControlPoints(spline);
+        Config *config = CubicSpline3DAccess::config(spline);
+        const int num_points = control_points.NumPoints();
+
+        // CLOSE TO GEOMETRIC PATH //
+        Eigen::VectorXd f_g = Eigen::Map<Eigen::VectorXd>(initial_control_points.points_.data(),
+                                                          initial_control_points.points_.cols() * initial_control_points.points_.rows());
+        Eigen::MatrixXd H_g = config->geometric_weight_ * 2. * Eigen::MatrixXd::Identity(num_points * 2, num_points * 2);
+        f_g = config->geometric_weight_ * -2 * f_g;
+
+        // SMOOTHNESS (one padded point on each side) //
+        Eigen::MatrixXd H_s = Eigen::MatrixXd::Zero(2 * num_points, 2 * num_points);
+        Eigen::MatrixXd M1 = Eigen::MatrixXd::Zero(2, num_points * 2);
+        Eigen::MatrixXd M3 = Eigen::MatrixXd::Zero(2, num_points * 2);
+
+        const double values[3] = {6., -4., 1.};
+        const double f_values[2] = {-2., 1.};
+        for (int diag_id = 0; diag_id < num_points && diag_id < 3; diag_id++)
+        {
+            double val = values[diag_id];
+            for (int j = 0; j < H_s.rows() - diag_id * 2; j++)
+            {
+                if (diag_id == 0 && (j <= 1 || j >= H_s.rows() - 2))
+                    H_s(j, j) = val - 1;
+                else
+                    H_s(j + diag_id * 2, j) = val;
+
+                if (diag_id > 0)
+                    H_s(j, j + diag_id * 2) = val;
+            }
+
+            if (diag_id >= 2)
+                continue;
+
+            for (int j = 0; j < 2; j++)
+            {
+                M1(j, j + 2 * diag_id) = f_values[diag_id];
+                M3(j, M3.cols() - diag_id * 2 - 2 + j) = f_values[diag_id];
+            }
+        }
+
+        Eigen::VectorXd start, end;
+        control_points.GetStartVectorized(start);
+        control_points.GetEndVectorized(end);
+
+        Eigen::VectorXd f_s = M1.transpose() * start + M3.transpose() * end;
+        H_g += config->smoothness_weight_ * H_s;
+        f_g += config->smoothness_weight_ * f_s;
+
+        // OBSTACLES REPULSIVE //
+        for (int i = 0; i < num_points; i++)
+        {
+            for (auto &obstacle : obstacles)
+            {
+                Eigen::Vector2d obstacle_pos = obstacle.positions_[std::round(control_points.GetTime(i) / Config::DT)];
+                Eigen::Vector2d control_pos = control_points.GetPoint(i);
+
+                if (RosTools::distance(obstacle_pos, control_pos) > obstacle.radius_ * 1.5)
+                    continue;
+
+                Eigen::Vector2d A_i = -(obstacle_pos - control_pos).normalized();
+                Eigen::MatrixXd H_i = A_i * A_i.transpose() / 2.;
+                Eigen::VectorXd f_i = -(1 + obstacle.radius_) * A_i - 2 * H_i * obstacle_pos;
+
+                H_g.block(i * 2, i * 2, 2, 2) += config->collision_weight_ * H_i;
+                f_g.segment(i * 2, 2) += config->collision_weight_ * f_i;
+            }
+        }
+
+        // VELOCITY TRACKING //
+        Eigen::MatrixXd velocity_points = CubicSpline3DAccess::velocitySplinePoints(spline);
+        Eigen::VectorXd f_v = Eigen::Map<Eigen::VectorXd>(velocity_points.data(), velocity_points.size());
+        H_g += config->velocity_tracking_ * 2. * Eigen::MatrixXd::Identity(num_points * 2, num_points * 2);
+        f_g += config->velocity_tracking_ * -2 * f_v;
+
+        // SOLVE //
+        Eigen::VectorXd new_points = -H_g.inverse() * f_g;
+        for (int i = 0; i < num_points; i++)
+            control_points.SetPoint(i, new_points.segment(i * 2, 2));
+
+        // PROJECT POINTS OUTSIDE OF OBSTACLES //
+        if (config->project_from_obstacles_)
+        {
+            for (int i = 0; i < num_points; i++)
+            {
+                Eigen::Vector2d cur_point = control_points.GetPoint(i);
+                int k = std::round(control_points.GetTime(i) / Config::DT);
+                for (auto &obstacle : obstacles)
+                {
+                    Eigen::Vector2d diff = cur_point - obstacle.positions_[k];
+                    if (diff.norm() < obstacle.radius_)
+                    {
+                        cur_point = obstacle.positions_[k] + diff.normalized() * obstacle.radius_;
+                        control_points.SetPoint(i, cur_point);
+                    }
+                }
+            }
+        }
+
+        return control_points.points_;
+    }
+}
+
+#endif // GUIDANCE_PLANNER_TEST_CUBIC_SPLINE_REFERENCE_H
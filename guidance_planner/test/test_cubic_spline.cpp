@@ -0,0 +1,104 @@
+#include <gtest/gtest.h>
+
+#include "cubic_spline_reference.h"
+
+#include <guidance_planner/types/node.h>
+#include <guidance_planner/types/paths.h>
+
+#include <random>
+
+using namespace GuidancePlanner;
+
+/** @brief Loads config/params.yaml (relative to the working directory) once */
+static Config &TestConfig()
+{
+    static Config config;
+    return config;
+}
+
+/** @brief A geometric path through the given (x, y) guards, spread evenly over the horizon */
+struct TestPath
+{
+    std::vector<Node> nodes;
+    GeometricPath path;
+
+    TestPath(const std::vector<Eigen::Vector2d> &guards)
+    {
+        nodes.reserve(guards.size()); // The path points into the nodes
+        for (size_t i = 0; i < guards.size(); i++)
+        {
+            double k = Config::N * (double)i / (double)(guards.size() - 1);
+            nodes.emplace_back(i, SpaceTimePoint(guards[i](0), guards[i](1), k), NodeType::GUARD);
+        }
+
+        std::vector<const Node *> node_pointers;
+        for (auto &node : nodes)
+            node_pointers.push_back(&node);
+        path = GeometricPath(node_pointers);
+    }
+};
+
+/** @brief Moving obstacles placed on or close to the path, such that the collision cost is active */
+static std::vector<Obstacle> ObstaclesAlongPath(const GeometricPath &path, int count, std::mt19937 &rng)
+{
+    std::uniform_real_distribution<double> offset(-0.3, 0.3), velocity(-0.5, 0.5), radius(0.4, 1.);
+
+    std::vector<Obstacle> obstacles;
+    for (int i = 0; i < count; i++)
+    {
+        double k = Config::N * (i + 1.) / (count + 1.);
+        size_t cursor = 0;
+        Eigen::Vector2d position = path.AtTime(k, cursor).Pos() + Eigen::Vector2d(offset(rng), offset(rng));
+        Eigen::Vector2d obstacle_velocity(velocity(rng), velocity(rng));
+
+        // Start such that the obstacle is at `position` at time k
+        obstacles.emplace_back(i, position - obstacle_velocity * k * Config::DT, obstacle_velocity, Config::DT, Config::N, radius(rng));
+    }
+    return obstacles;
+}
+
+TEST(CubicSplineTest, OptimizeMatchesDenseReference)
+{
+    Config &config = TestConfig();
+    const double collision_weight = config.collision_weight_;
+    const bool project_from_obstacles = config.project_from_obstacles_;
+
+    const std::vector<std::vector<Eigen::Vector2d>> guards = {
+        {{0., 0.}, {10., 0.}},                                 // Straight
+        {{0., 0.}, {4., 2.}, {8., -1.}, {12., 0.}},            // Zig-zag
+        {{0., 0.}, {3., 3.}, {6., 3.5}, {9., 0.}, {10., -4.}}, // Turning
+    };
+
+    std::mt19937 rng(1);
+    for (auto &path_guards : guards)
+    {
+        TestPath path(path_guards);
+        for (int num_obstacles : {0, 1, 4, 12})
+        {
+            for (double weight : {collision_weight, 10. * collision_weight})
+            {
+                for (bool project : {false, true})
+                {
+                    config.collision_weight_ = weight;
+                    config.project_from_obstacles_ = project;
+
+                    std::vector<Obstacle> obstacles = ObstaclesAlongPath(path.path, num_obstacles, rng);
+
+                    CubicSpline3D spline(path.path, &config, Eigen::Vector2d(1., 0.));
+                    Eigen::MatrixXd expected = ReferenceOptimize(spline, obstacles);
+
+                    spline.Optimize(obstacles);
+                    const Eigen::MatrixXd &result = CubicSpline3DAccess::controlPoints(spline).points_;
+
+                    ASSERT_EQ(result.cols(), expected.cols());
+                    EXPECT_LT((result - expected).norm(), 1e-9 * std::max(1., expected.norm()))
+                        << "path with " << path_guards.size() << " guards, " << num_obstacles << " obstacles, collision weight "
+                        << weight << (project ? ", projected" : "");
+                }
+            }
+        }
+    }
+
+    config.collision_weight_ = collision_weight;
+    config.project_from_obstacles_ = project_from_obstacles;
+}
@@ -3,6 +3,7 @@
 
 #include <mpc_planner/planner.h>
 #include <mpc_planner/data_preparation.h>
+#include <mpc_planner/input_log.h>
 #include <mpc_planner_solver/state.h>
 #include <mpc_planner_solver/model_detector.h>
 #include <mpc_planner_types/realtime_data.h>
@@ -11,30 +12,39 @@
 
 #include <mpc_planner_types/data_types.h>
 
+#ifndef MPC_PLANNER_HEADLESS
 #define WITHOUT_NUMPY
 #include "matplotlibcpp.h"
+#endif
 #include "third_party/simple_json.hpp"
 
 #include <Eigen/Dense>
 
 #include <algorithm>
+#include <array>
+#include <atomic>
 #include <cmath>
 #include <chrono>
 #include <csignal>
 #include <filesystem>
+#include <fstream>
 #include <iomanip>
 #include <iostream>
 #include <limits>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <sstream>
 #include <string>
 #include <thread>
 #include <vector>
 
 #include <ros_tools/spline.h>
+#include <ros_tools/spline_window.h>
 
+#ifndef MPC_PLANNER_HEADLESS
 namespace plt = matplotlibcpp;
+#endif
 namespace fs = std::filesystem;
 using namespace MPCPlanner;
 
@@ -50,6 +60,7 @@ void handleSignal(int signal)
     g_running = 0;
 }
 
+#ifndef MPC_PLANNER_HEADLESS
 std::pair<std::vector<double>, std::vector<double>> makeCircle(double cx, double cy, double radius, int samples = 48)
 {
     std::vector<double> xs;
@@ -66,6 +77,7 @@ std::pair<std::vector<double>, std::vector<double>> makeCircle(double cx, double
 
     return {xs, ys};
 }
+#endif
 
 struct SimObstacle
 {
@@ -131,6 +143,7 @@ struct GuidancePath
     int color_index{-1};
 };
 
+#ifndef MPC_PLANNER_HEADLESS
 std::string colorFromIndex(int idx)
 {
     static const std::vector<std::string> palette = {
@@ -144,6 +157,101 @@ std::string colorFromIndex(int idx)
     return palette[static_cast<size_t>(idx) % palette.size()];
 }
 
+/** @brief Copy of everything the visualizer draws of one control cycle */
+struct VisualizationSnapshot
+{
+    struct Obstacle
+    {
+        int index;
+        bool is_static;
+        Eigen::Vector2d position;
+        double radius;
+        std::vector<Eigen::Vector2d> prediction; // First mode
+    };
+
+    double x{0.0}, y{0.0}, psi{0.0}, v{0.0};
+    std::vector<Disc> robot_area;
+    std::vector<double> reference_x, reference_y;
+    std::vector<Obstacle> obstacles;
+    bool goal_received{false};
+    Eigen::Vector2d goal{0.0, 0.0};
+
+    bool success{false};
+    double trajectory_dt{0.0};
+    std::vector<Eigen::Vector2d> trajectory;
+    std::vector<CandidateTrajectory> candidates;
+
+    std::vector<double> history_x, history_y, history_speed, history_time; // Only grows until the history is reset
+    int history_epoch{-1};                                                  // See AsyncVisualizer::resetLayout()
+    std::vector<GuidancePath> guidance_paths;
+    double sim_time{0.0};
+    int iteration{0};
+
+    void clearHistory()
+    {
+        history_x.clear();
+        history_y.clear();
+        history_speed.clear();
+        history_time.clear();
+    }
+
+    /** @brief Copy the cycle (reusing the capacity of the previous copy, only the new samples of the history are copied) */
+    void set(const State &state, const RealTimeData &data, const PlannerOutput &output,
+             const std::vector<CandidateTrajectory> &candidates_in,
+             const std::vector<double> &history_x_in, const std::vector<double> &history_y_in,
+             const std::vector<double> &history_speed_in, const std::vector<double> &history_time_in,
+             const std::vector<GuidancePath> &guidance_paths_in, double sim_time_in, int iteration_in)
+    {
+        x = state.get("x");
+        y = state.get("y");
+        psi = state.get("psi");
+        v = state.get("v");
+        robot_area = data.robot_area;
+        reference_x = data.reference_path.x;
+        reference_y = data.reference_path.y;
+
+        obstacles.resize(data.dynamic_obstacles.size());
+        for (size_t i = 0; i < data.dynamic_obstacles.size(); i++)
+        {
+            const auto &obstacle = data.dynamic_obstacles[i];
+            obstacles[i].index = obstacle.index;
+            obstacles[i].is_static = obstacle.type == ObstacleType::STATIC;
+            obstacles[i].position = obstacle.position;
+            obstacles[i].radius = obstacle.radius;
+            obstacles[i].prediction.clear();
+            if (!obstacle.prediction.modes.empty())
+            {
+                for (const auto &step : obstacle.prediction.modes.front())
+                    obstacles[i].prediction.push_back(step.position);
+            }
+        }
+        goal_received = data.goal_received;
+        goal = data.goal;
+
+        success = output.success;
+        trajectory_dt = output.trajectory.dt;
+        trajectory = output.trajectory.positions;
+        candidates = candidates_in;
+
+        appendHistory(history_x, history_x_in);
+        appendHistory(history_y, history_y_in);
+        appendHistory(history_speed, history_speed_in);
+        appendHistory(history_time, history_time_in);
+        guidance_paths = guidance_paths_in;
+        sim_time = sim_time_in;
+        iteration = iteration_in;
+    }
+
+private:
+    /** @brief Append the samples of the simulation history that this snapshot does not have yet */
+    static void appendHistory(std::vector<double> &history, const std::vector<double> &history_in)
+    {
+        if (history.size() > history_in.size())
+            history.clear(); // Reset since this snapshot was filled
+        history.insert(history.end(), history_in.begin() + history.size(), history_in.end());
+    }
+};
+
 class MatplotlibVisualizer
 {
 public:
@@ -381,25 +489,24 @@ if hasattr(plt, '_mpc_axes'):
         _reference_cache_ready = false;
     }
 
-    void update(const State &state,
-                const RealTimeData &data,
-                const PlannerOutput &output,
-                const std::vector<CandidateTrajectory> &candidates,
-                const std::vector<double> &history_x,
-                const std::vector<double> &history_y,
-                const std::vector<double> &history_speed,
-                const std::vector<double> &history_time,
-                const std::vector<GuidancePath> &guidance_paths,
-                double sim_time,
-                int iteration)
+    void update(const VisualizationSnapshot &frame)
     {
         if (!_initialized)
             initialize();
 
-        if (!_reference_cache_ready && !data.reference_path.x.empty())
+        const auto &candidates = frame.candidates;
+        const auto &history_x = frame.history_x;
+        const auto &history_y = frame.history_y;
+        const auto &history_speed = frame.history_speed;
+        const auto &history_time = frame.history_time;
+        const auto &guidance_paths = frame.guidance_paths;
+        const double sim_time = frame.sim_time;
+        const int iteration = frame.iteration;
+
+        if (!_reference_cache_ready && !frame.reference_x.empty())
         {
-            _ref_x = data.reference_path.x;
-            _ref_y = data.reference_path.y;
+            _ref_x = frame.reference_x;
+            _ref_y = frame.reference_y;
             _reference_cache_ready = true;
         }
 
@@ -465,14 +572,14 @@ if hasattr(plt, '_mpc_axes'):
             plt::plot(history_x, history_y, history_opts);
         }
 
-        if (output.success && !output.trajectory.positions.empty())
+        if (frame.success && !frame.trajectory.empty())
         {
             std::vector<double> traj_x;
             std::vector<double> traj_y;
-            traj_x.reserve(output.trajectory.positions.size());
-            traj_y.reserve(output.trajectory.positions.size());
+            traj_x.reserve(frame.trajectory.size());
+            traj_y.reserve(frame.trajectory.size());
 
-            for (const auto &p : output.trajectory.positions)
+            for (const auto &p : frame.trajectory)
             {
                 traj_x.push_back(p.x());
                 traj_y.push_back(p.y());
@@ -513,12 +620,12 @@ if hasattr(plt, '_mpc_axes'):
         for (size_t i = 0; i < history_x.size(); ++i)
             update_bounds(history_x[i], history_y[i]);
 
-        for (const auto &obs : data.dynamic_obstacles)
+        for (const auto &obs : frame.obstacles)
         {
             if (obs.index < 0)
                 continue; // Skip dummy obstacles added for padding
 
-            bool is_static_obstacle = (obs.type == ObstacleType::STATIC);
+            bool is_static_obstacle = obs.is_static;
             auto circle = makeCircle(obs.position.x(), obs.position.y(), obs.radius);
             std::map<std::string, std::string> circle_opts;
             circle_opts["color"] = is_static_obstacle ? "#ff8c00" : "#d62728";
@@ -533,17 +640,17 @@ if hasattr(plt, '_mpc_axes'):
             }
             plt::plot(circle.first, circle.second, circle_opts);
 
-            if (!is_static_obstacle && !obs.prediction.modes.empty() && !obs.prediction.modes.front().empty())
+            if (!is_static_obstacle && !obs.prediction.empty())
             {
                 std::vector<double> pred_x;
                 std::vector<double> pred_y;
-                pred_x.reserve(obs.prediction.modes.front().size());
-                pred_y.reserve(obs.prediction.modes.front().size());
+                pred_x.reserve(obs.prediction.size());
+                pred_y.reserve(obs.prediction.size());
 
-                for (const auto &step : obs.prediction.modes.front())
+                for (const auto &position : obs.prediction)
                 {
-                    pred_x.push_back(step.position.x());
-                    pred_y.push_back(step.position.y());
+                    pred_x.push_back(position.x());
+                    pred_y.push_back(position.y());
                 }
                 std::map<std::string, std::string> pred_opts;
                 pred_opts["color"] = "#d62728";
@@ -564,13 +671,13 @@ if hasattr(plt, '_mpc_axes'):
                 update_bounds(pt.x(), pt.y());
         }
 
-        const double state_x = state.get("x");
-        const double state_y = state.get("y");
-        const double psi = state.get("psi");
+        const double state_x = frame.x;
+        const double state_y = frame.y;
+        const double psi = frame.psi;
         const double cos_psi = std::cos(psi);
         const double sin_psi = std::sin(psi);
 
-        for (const auto &disc : data.robot_area)
+        for (const auto &disc : frame.robot_area)
         {
             const double cx = state_x + disc.offset * cos_psi;
             const double cy = state_y + disc.offset * sin_psi;
@@ -595,10 +702,10 @@ if hasattr(plt, '_mpc_axes'):
         plt::scatter(ego_x, ego_y, 160.0, ego_opts);
         update_bounds(ego_x.front(), ego_y.front());
 
-        if (data.goal_received)
+        if (frame.goal_received)
         {
-            std::vector<double> goal_x = {data.goal.x()};
-            std::vector<double> goal_y = {data.goal.y()};
+            std::vector<double> goal_x = {frame.goal.x()};
+            std::vector<double> goal_y = {frame.goal.y()};
             std::map<std::string, std::string> goal_opts;
             goal_opts["color"] = "gold";
             goal_opts["label"] = "Goal";
@@ -708,24 +815,24 @@ ax.legend(uniq_h, uniq_l, loc='upper right')
 
         _planned_speed_time.clear();
         _planned_speed_values.clear();
-        if (output.success && output.trajectory.dt > 1e-6 && !output.trajectory.positions.empty())
+        if (frame.success && frame.trajectory_dt > 1e-6 && !frame.trajectory.empty())
         {
-            const auto &positions = output.trajectory.positions;
+            const auto &positions = frame.trajectory;
             _planned_speed_time.reserve(positions.size());
             _planned_speed_values.reserve(positions.size());
 
             for (size_t i = 0; i < positions.size(); ++i)
             {
-                _planned_speed_time.push_back(sim_time + output.trajectory.dt * static_cast<double>(i));
+                _planned_speed_time.push_back(sim_time + frame.trajectory_dt * static_cast<double>(i));
                 if (i == 0)
                 {
-                    _planned_speed_values.push_back(state.get("v"));
+                    _planned_speed_values.push_back(frame.v);
                 }
                 else
                 {
                     const double dx = positions[i].x() - positions[i - 1].x();
                     const double dy = positions[i].y() - positions[i - 1].y();
-                    const double speed = std::sqrt(dx * dx + dy * dy) / output.trajectory.dt;
+                    const double speed = std::sqrt(dx * dx + dy * dy) / frame.trajectory_dt;
                     _planned_speed_values.push_back(speed);
                 }
             }
@@ -769,17 +876,6 @@ ax.legend(uniq_h, uniq_l, loc='upper right')
         plt::pause(0.001);
     }
 
-    void waitWhilePaused()
-    {
-        if (!_initialized)
-            return;
-
-        while (isPaused() && g_running)
-        {
-            plt::pause(0.05);
-        }
-    }
-
     bool isPaused() const
     {
         PyObject *plt_mod = PyImport_AddModule("matplotlib.pyplot");
@@ -883,12 +979,240 @@ private:
     double _fixed_max_y{5.0};
 };
 
+/**
+ * @brief Draws the matplotlib window on its own thread, such that drawing does not delay the control loop
+ *
+ * update() copies the cycle into a snapshot and publishes it as the latest frame. The three snapshots are swapped
+ * between the control loop and the visualizer thread, such that their memory is reused. The thread draws the latest
+ * frame at its own rate; frames that are published before it is ready are dropped, the control loop never waits.
+ * All Python calls are made from the visualizer thread, the buttons of the window are forwarded through atomics.
+ */
+class AsyncVisualizer
+{
+public:
+    AsyncVisualizer()
+        : _back(std::make_unique<VisualizationSnapshot>()),
+          _latest(std::make_unique<VisualizationSnapshot>()),
+          _front(std::make_unique<VisualizationSnapshot>())
+    {
+    }
+
+    ~AsyncVisualizer() { stop(); }
+
+    /** @param rate Maximum rate at which the window is redrawn [Hz] */
+    void initialize(const std::map<int, std::string> &button_labels = {}, double rate = 10.0)
+    {
+        if (_thread.joinable())
+            return;
+
+        _button_labels = button_labels;
+        _period = 1.0 / std::max(rate, 1e-3);
+        _stop = false;
+        _thread = std::thread(&AsyncVisualizer::visualizerLoop, this);
+    }
+
+    void stop()
+    {
+        if (!_thread.joinable())
+            return;
+
+        _stop = true;
+        _thread.join();
+        LOG_INFO("Visualizer: Drew " << _frames_drawn << " frames, dropped " << _frames_dropped << " frames");
+    }
+
+    /** @brief Called when the simulation resets, the snapshots then rebuild their history */
+    void resetLayout()
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _reset_layout = true;
+        _has_frame = false; // Do not draw a frame from before the reset
+        _history_epoch++;
+    }
+
+    void update(const State &state,
+                const RealTimeData &data,
+                const PlannerOutput &output,
+                const std::vector<CandidateTrajectory> &candidates,
+                const std::vector<double> &history_x,
+                const std::vector<double> &history_y,
+                const std::vector<double> &history_speed,
+                const std::vector<double> &history_time,
+                const std::vector<GuidancePath> &guidance_paths,
+                double sim_time,
+                int iteration)
+    {
+        // The history only grows between resets, each snapshot appends the samples since it was last filled
+        if (_back->history_epoch != _history_epoch)
+        {
+            _back->clearHistory();
+            _back->history_epoch = _history_epoch;
+        }
+        _back->set(state, data, output, candidates, history_x, history_y, history_speed, history_time,
+                   guidance_paths, sim_time, iteration);
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        std::swap(_back, _latest);
+        if (_has_frame)
+            _frames_dropped++; // The previous frame was not drawn
+        _has_frame = true;
+    }
+
+    void waitWhilePaused()
+    {
+        while (_paused.load() && g_running)
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    }
+
+    void setFixedBounds(double start_x, double start_y, double goal_x, double goal_y)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _bounds = {start_x, start_y, goal_x, goal_y};
+        _has_bounds = true;
+    }
+
+    bool checkScenarioSwitch(int &scenario_id)
+    {
+        int requested = _requested_scenario.exchange(-1);
+        if (requested < 0)
+            return false;
+
+        scenario_id = requested;
+        return true;
+    }
+
+private:
+    MatplotlibVisualizer _visualizer; // Only used by the visualizer thread
+    std::map<int, std::string> _button_labels;
+    double _period{0.1};
+
+    std::thread _thread;
+    std::atomic<bool> _stop{false};
+    std::atomic<bool> _paused{false};
+    std::atomic<int> _requested_scenario{-1};
+
+    std::mutex _mutex; // Protects the members below
+    std::unique_ptr<VisualizationSnapshot> _back;   // Filled by the control loop
+    std::unique_ptr<VisualizationSnapshot> _latest; // Latest published frame
+    bool _has_frame{false};
+    bool _reset_layout{false};
+    bool _has_bounds{false};
+    std::array<double, 4> _bounds{};
+    int _frames_dropped{0};
+
+    std::unique_ptr<VisualizationSnapshot> _front; // Drawn by the visualizer thread
+    int _frames_drawn{0};
+
+    int _history_epoch{0}; // Control loop only
+
+    void visualizerLoop()
+    {
+        _visualizer.initialize(_button_labels);
+
+        while (!_stop)
+        {
+            const auto frame_start = std::chrono::steady_clock::now();
+
+            bool draw = false, reset_layout = false, has_bounds = false;
+            std::array<double, 4> bounds;
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                std::swap(reset_layout, _reset_layout);
+                std::swap(has_bounds, _has_bounds);
+                bounds = _bounds;
+                if (_has_frame)
+                {
+                    std::swap(_latest, _front);
+                    _has_frame = false;
+                    draw = true;
+                }
+            }
+
+            if (reset_layout)
+                _visualizer.resetLayout();
+            if (has_bounds)
+                _visualizer.setFixedBounds(bounds[0], bounds[1], bounds[2], bounds[3]);
+            if (draw)
+            {
+                _visualizer.update(*_front);
+                _frames_drawn++;
+            }
+
+            // Forward the buttons to the control loop
+            _paused = _visualizer.isPaused();
+            int scenario_id;
+            if (_visualizer.checkScenarioSwitch(scenario_id))
+                _requested_scenario = scenario_id;
+
+            // Keep the window responsive until the next frame is due
+            const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - frame_start).count();
+            plt::pause(std::max(_period - elapsed, 0.001));
+        }
+
+        // Python was initialized on this thread and has to be finalized here as well
+        matplotlibcpp::detail::_interpreter::kill();
+    }
+};
+typedef AsyncVisualizer Visualizer;
+#else
+/** @brief Replaces the visualizer when running headless (batch evaluation without Python) */
+class HeadlessVisualizer
+{
+public:
+    void initialize(const std::map<int, std::string> &button_labels = {}, double rate = 10.0)
+    {
+        (void)button_labels;
+        (void)rate;
+    }
+    void resetLayout() {}
+    void update(const State &, const RealTimeData &, const PlannerOutput &, const std::vector<CandidateTrajectory> &,
+                const std::vector<double> &, const std::vector<double> &, const std::vector<double> &,
+                const std::vector<double> &, const std::vector<GuidancePath> &, double, int) {}
+    void waitWhilePaused() {}
+    void setFixedBounds(double, double, double, double) {}
+    bool checkScenarioSwitch(int &scenario_id)
+    {
+        (void)scenario_id;
+        return false;
+    }
+};
+typedef HeadlessVisualizer Visualizer;
+#endif
+
+/** @brief Outcome and latency statistics of one simulated scenario */
+struct ScenarioResult
+{
+    int cycles{0};
+    double sim_time{0.0};  // [s] Simulated (virtual) time
+    double wall_time{0.0}; // [s]
+
+    RosTools::Benchmarker solve{"solve"}; // solveMPC per cycle (deadline: the control period)
+    int failed_solves{0};
+    long long solver_iterations{0};
+    int max_solver_iterations{0};
+
+    int collision_cycles{0};
+    double max_intrusion{0.0};     // [m] Deepest overlap between the robot and an obstacle
+    double goal_reached_time{-1.0}; // [s] -1 if the goal was not reached
+};
+
 class JackalLikeSimulation
 {
 public:
-    explicit JackalLikeSimulation(const fs::path &config_dir)
+    /**
+     * @param virtual_clock Plan with simulated time (solver and guidance timeouts follow the simulation), nullptr: wall time
+     * @param recording_folder Record into this folder, overriding recording.enable and recording.folder of the settings (empty: as configured)
+     */
+    explicit JackalLikeSimulation(const fs::path &config_dir, std::shared_ptr<RosTools::VirtualClock> virtual_clock = nullptr,
+                                  const std::string &recording_folder = "")
+        : virtual_clock_(virtual_clock)
     {
         loadConfiguration(config_dir);
+        if (!recording_folder.empty())
+        {
+            CONFIG["recording"]["enable"] = true;
+            CONFIG["recording"]["folder"] = recording_folder;
+        }
 
         // 初始化模型检测器
         model_detector_ = std::make_unique<ModelDetector>();
@@ -900,7 +1224,7 @@ public:
         enable_output_ = CONFIG["enable_output"].as<bool>();
         deceleration_ = CONFIG["deceleration_at_infeasible"].as<double>();
 
-        planner_ = std::make_unique<Planner>();
+        planner_ = std::make_unique<Planner>(virtual_clock_);
         global_guidance_ = std::make_shared<GuidancePlanner::GlobalGuidance>();
         global_guidance_->SetPlanningFrequency(control_frequency_);
         global_guidance_->DoNotPropagateNodes();
@@ -1037,10 +1361,19 @@ public:
         history_speed_.push_back(state_.get("v"));
         history_time_.push_back(sim_time_);
 
-        visualizer_.initialize(scenario_button_labels_);
+        visualizer_.initialize(scenario_button_labels_, CONFIG["visualization"]["rate"].as<double>(10.0));
         visualizer_.resetLayout();
 
+        RosTools::PerfCounters::setEnabled(CONFIG["debug_hardware_counters"].as<bool>(false));
+#ifndef MPC_PLANNER_HEADLESS
         RosTools::Instrumentor::Get().BeginSession("mpc_planner_pure_cpp_demo");
+#endif
+        result_ = ScenarioResult();
+        result_.solve.setDeadline(dt_);
+        const auto run_start = std::chrono::steady_clock::now();
+
+        if (CONFIG["recording"]["log_inputs"].as<bool>(false))
+            input_log_.open(CONFIG["recording"]["folder"].as<std::string>() + "/" + CONFIG["recording"]["file"].as<std::string>() + ".mpclog");
 
         const int max_iterations = static_cast<int>(control_frequency_ * max_sim_time_);
         int iteration = 0;
@@ -1058,17 +1391,30 @@ public:
                 continue;
             }
 
+#ifndef MPC_PLANNER_HEADLESS
             const auto loop_start = std::chrono::steady_clock::now();
+#endif
 
 
-            data_.planning_start_time = std::chrono::system_clock::now();
+            if (virtual_clock_)
+                virtual_clock_->setTime(sim_time_);
+            data_.planning_start_time = planner_->getClock()->now();
 
             state_.set("spline", computeReferenceProgress());
 
             updateObstacles(dt_);
             updateGuidanceTrajectories();
 
-            auto output = planner_->solveMPC(state_, data_);
+            input_log_.recordInputs(sim_time_, state_, data_);
+            result_.solve.start();
+            const auto &output = planner_->solveMPC(state_, data_);
+            input_log_.recordOutput(output, result_.solve.stop());
+            planner_->saveData(state_, data_); // Recorded in the background when recording is enabled
+
+            result_.cycles++;
+            result_.failed_solves += output.success ? 0 : 1;
+            result_.solver_iterations += planner_->getSolverIterations();
+            result_.max_solver_iterations = std::max(result_.max_solver_iterations, planner_->getSolverIterations());
 
             double v_cmd{0.0};
             double w_cmd{0.0};
@@ -1098,16 +1444,23 @@ public:
             history_time_.push_back(sim_time_);
             data_.past_trajectory.add(state_.getPos());
 
+            data_.intrusion = computeIntrusion();
+            if (data_.intrusion > 0.0)
+                result_.collision_cycles++;
+            result_.max_intrusion = std::max(result_.max_intrusion, data_.intrusion);
+
             visualizer_.update(state_, data_, output, candidates, history_x_, history_y_, history_speed_, history_time_, guidance_paths_, sim_time_, iteration);
 
             if (objectiveReached())
             {
                 LOG_INFO("Objective reached, stopping simulation");
+                result_.goal_reached_time = sim_time_;
                 break;
             }
 
             ++iteration;
 
+#ifndef MPC_PLANNER_HEADLESS
             auto loop_end = std::chrono::steady_clock::now();
             const double loop_duration = std::chrono::duration<double>(loop_end - loop_start).count();
             const double sleep_time = dt_ - loop_duration;
@@ -1120,12 +1473,26 @@ public:
             {
                 LOG_WARN_THROTTLE(200, "Control loop overrun: " << loop_duration << " s (target " << dt_ << " s)");
             }
+#endif
         }
 
+        result_.sim_time = sim_time_;
+        result_.wall_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - run_start).count();
+
+        input_log_.close();
+#ifndef MPC_PLANNER_HEADLESS
         RosTools::Instrumentor::Get().EndSession();
+#endif
         LOG_INFO("Simulation finished after " << iteration << " iterations and " << sim_time_ << " seconds");
     }
 
+    const ScenarioResult &getResult() const { return result_; }
+
+    /** @brief Whether the scenario file was loaded (otherwise the default obstacles are used) */
+    bool hasScenario() const { return use_scenario_file_; }
+
+    double getControlPeriod() const { return dt_; }
+
 private:
     void loadConfiguration(const fs::path &config_dir)
     {
@@ -1199,7 +1566,6 @@ private:
         // 路径跟踪状态
         state_.set("spline", 0.0);
 
-        reference_progress_initialized_ = false;
         reference_segment_ = -1;
         reference_parameter_ = 0.0;
 
@@ -1278,8 +1644,10 @@ private:
             buildDefaultReferencePath();
         }
 
-        reference_spline_ = std::make_shared<RosTools::Spline2D>(data_.reference_path.x, data_.reference_path.y);
-        reference_progress_initialized_ = false;
+        reference_window_ = RosTools::Spline2DWindow(CONFIG["contouring"]["window_look_behind"].as<double>(),
+                                                     CONFIG["contouring"]["window_look_ahead"].as<double>());
+        reference_window_.setPath(data_.reference_path.x, data_.reference_path.y);
+        reference_spline_.reset();
         reference_segment_ = -1;
         reference_parameter_ = 0.0;
     }
@@ -1590,19 +1958,34 @@ private:
         const int steps = horizon_steps_;
         const double integrator_step = CONFIG["integrator_step"].as<double>();
 
+        // 每个周期从仿真障碍物重建 (复用上一周期的存储), 选择后的顺序与 sim_obstacles_ 不一致
+        auto &obstacles = data_.dynamic_obstacles;
+        if (obstacles.size() > sim_obstacles_.size())
+            obstacles.erase(obstacles.begin() + sim_obstacles_.size(), obstacles.end());
+
         for (size_t i = 0; i < sim_obstacles_.size(); ++i)
         {
             auto &sim_obs = sim_obstacles_[i];
             sim_obs.update(dt);
 
-            auto &dyn = data_.dynamic_obstacles[i];
+            if (i == obstacles.size())
+                obstacles.emplace_back(sim_obs.id, sim_obs.position, 0.0, sim_obs.radius);
+
+            auto &dyn = obstacles[i];
+            dyn.index = sim_obs.id;
             dyn.position = sim_obs.position;
-            dyn.prediction = getConstantVelocityPrediction(sim_obs.position,
-                                                           sim_obs.velocity,
-                                                           integrator_step,
-                                                           steps);
+            dyn.radius = sim_obs.radius;
+            dyn.type = sim_obs.is_static ? ObstacleType::STATIC : ObstacleType::DYNAMIC;
+            setConstantVelocityPrediction(dyn.prediction,
+                                          sim_obs.position,
+                                          sim_obs.velocity,
+                                          integrator_step,
+                                          steps);
         }
 
+        // 选择 (或补齐) 求解器支持的障碍物数量, 并展开保留障碍物的预测
+        ensureObstacleSize(obstacles, state_);
+
         planner_->onDataReceived(data_, "dynamic obstacles");
     }
 
@@ -1674,6 +2057,19 @@ private:
         state_.set("a", (v - prev_v) / dt);
     }
 
+    /** @brief Deepest overlap between a disc of the robot and an obstacle (negative: clearance) */
+    double computeIntrusion() const
+    {
+        double intrusion = -std::numeric_limits<double>::infinity();
+        for (const auto &disc : data_.robot_area)
+        {
+            const Eigen::Vector2d disc_position = disc.getPosition(state_.getPos(), state_.get("psi"));
+            for (const auto &obstacle : sim_obstacles_)
+                intrusion = std::max(intrusion, disc.radius + obstacle.radius - (disc_position - obstacle.position).norm());
+        }
+        return intrusion;
+    }
+
     bool objectiveReached() const
     {
         const Eigen::Vector2d diff = state_.getPos() - data_.goal;
@@ -1682,18 +2078,12 @@ private:
 
     double computeReferenceProgress()
     {
-        if (!reference_spline_)
+        if (reference_window_.empty())
             return 0.0;
 
-        if (!reference_progress_initialized_)
-        {
-            reference_spline_->initializeClosestPoint(state_.getPos(), reference_segment_, reference_parameter_);
-            reference_progress_initialized_ = true;
-        }
-        else
-        {
-            reference_spline_->findClosestPoint(state_.getPos(), reference_segment_, reference_parameter_);
-        }
+        // Only the window of the reference path around the robot is fitted
+        reference_window_.findClosestPoint(state_.getPos(), reference_segment_, reference_parameter_);
+        reference_spline_ = reference_window_.getSpline();
 
         return reference_parameter_;
     }
@@ -1701,8 +2091,11 @@ private:
     void updateGuidanceTrajectories()
     {
         guidance_paths_.clear();
+#ifdef MPC_PLANNER_HEADLESS
+        return; // These guidance trajectories are only visualized
+#endif
 
-        if (!global_guidance_ || !reference_spline_)
+        if (!global_guidance_ || reference_window_.empty())
             return;
 
         double spline_position = computeReferenceProgress();
@@ -1725,33 +2118,22 @@ private:
                     positions.push_back(step.position);
             }
 
-            obstacles.emplace_back(obs.index, positions, obs.radius + robot_radius);
+            obstacles.emplace_back(obs.index, std::move(positions), obs.radius + robot_radius, obs.type == ObstacleType::STATIC);
         }
 
-        global_guidance_->LoadObstacles(obstacles, {});
+        global_guidance_->LoadObstacles(std::move(obstacles), {});
         global_guidance_->SetStart(state_.getPos(), state_.get("psi"), state_.get("v"));
 
         double reference_velocity = std::max(0.5, state_.get("v"));
-        if (!data_.reference_path.x.empty())
+        if (!data_.reference_path.v.empty())
         {
-            double best_dist = std::numeric_limits<double>::infinity();
-            size_t best_idx = 0;
-            const double robot_x = state_.get("x");
-            const double robot_y = state_.get("y");
-
-            for (size_t i = 0; i < data_.reference_path.x.size(); ++i)
-            {
-                double dx = data_.reference_path.x[i] - robot_x;
-                double dy = data_.reference_path.y[i] - robot_y;
-                double dist = std::hypot(dx, dy);
-                if (dist < best_dist)
-                {
-                    best_dist = dist;
-                    best_idx = i;
-                }
-            }
+            // Velocity of the path point closest to the current progress
+            const auto &path_s = reference_window_.getPathDistances();
+            int index = reference_window_.findPathSegment(spline_position);
+            if (path_s[index + 1] - spline_position < spline_position - path_s[index])
+                index++;
 
-            reference_velocity = std::max(0.3, data_.reference_path.v[best_idx]);
+            reference_velocity = std::max(0.3, data_.reference_path.v[index]);
         }
         global_guidance_->SetReferenceVelocity(std::max(0.3, reference_velocity));
 
@@ -1809,9 +2191,10 @@ private:
     }
 
     std::unique_ptr<Planner> planner_;
+    InputLogWriter input_log_; // Planner inputs for offline replay
     State state_;
     RealTimeData data_;
-    MatplotlibVisualizer visualizer_;
+    Visualizer visualizer_;
     std::vector<SimObstacle> sim_obstacles_;
 
     std::vector<double> history_x_;
@@ -1821,8 +2204,8 @@ private:
     std::vector<GuidancePath> guidance_paths_;
 
     std::shared_ptr<GuidancePlanner::GlobalGuidance> global_guidance_;
-    std::shared_ptr<RosTools::Spline2D> reference_spline_;
-    bool reference_progress_initialized_{false};
+    RosTools::Spline2DWindow reference_window_;
+    std::shared_ptr<RosTools::Spline2D> reference_spline_; // The spline over the current window
     int reference_segment_{-1};
     double reference_parameter_{0.0};
 
@@ -1844,10 +2227,168 @@ private:
     simple_json::Value scenario_json_;  // 缓存解析后的场景数据
     std::map<int, std::string> scenario_button_map_;  // 场景按钮ID到场景文件的映射
     std::map<int, std::string> scenario_button_labels_;  // 场景按钮ID到显示标签的映射
+
+    ScenarioResult result_;
+    std::shared_ptr<RosTools::VirtualClock> virtual_clock_;
 };
 
+#ifdef MPC_PLANNER_HEADLESS
+std::string jsonEscape(const std::string &text)
+{
+    std::string escaped;
+    for (char c : text)
+    {
+        if (c == '"' || c == '\\')
+            escaped += '\\';
+        escaped += c;
+    }
+    return escaped;
+}
+
+/** @brief Latency statistics of a benchmarker as JSON object (times in ms) */
+std::string benchmarkerToJson(const RosTools::Benchmarker &benchmarker)
+{
+    const int runs = benchmarker.getNumRuns();
+    std::ostringstream json;
+    json << "{\"runs\": " << runs
+         << ", \"mean_ms\": " << (runs > 0 ? benchmarker.getTotalDuration() / runs * 1000.0 : 0.0)
+         << ", \"p50_ms\": " << benchmarker.getPercentile(50.0) * 1000.0
+         << ", \"p99_ms\": " << benchmarker.getPercentile(99.0) * 1000.0
+         << ", \"max_ms\": " << benchmarker.getHistogram().getMax() * 1000.0
+         << ", \"deadline_misses\": " << benchmarker.getDeadlineMisses() << "}";
+    return json.str();
+}
+#endif
+
 } // namespace
 
+#ifdef MPC_PLANNER_HEADLESS
+/**
+ * Headless batch evaluation: runs each scenario without visualization and without waiting for the control period, then
+ * writes a JSON report with the outcome and latency statistics per scenario.
+ *
+ * Usage: mpc_planner_batch [--config <dir>] [--report <json>] [--recording <folder>] [--virtual-time] <scenario.json|directory>...
+ *  --recording:    record the planner data into this folder (default: as configured in the settings)
+ *  --virtual-time: timeouts of the planner follow the simulated time, such that the results do not depend on the machine
+ */
+int main(int argc, char **argv)
+{
+    std::signal(SIGINT, handleSignal);
+    std::signal(SIGTERM, handleSignal);
+
+    fs::path config_path = "mpc_planner_jackalsimulator/config";
+    std::string report_file = "batch_report.json", recording_folder;
+    std::vector<std::string> scenario_files;
+    bool virtual_time = false;
+    for (int i = 1; i < argc; i++)
+    {
+        std::string argument = argv[i];
+        if (argument == "--virtual-time")
+        {
+            virtual_time = true;
+            continue;
+        }
+
+        if ((argument == "--config" || argument == "--report" || argument == "--recording") && i + 1 >= argc)
+        {
+            std::cerr << "Missing value for " << argument << "\n";
+            return 1;
+        }
+
+        if (argument == "--config")
+            config_path = argv[++i];
+        else if (argument == "--report")
+            report_file = argv[++i];
+        else if (argument == "--recording")
+            recording_folder = argv[++i];
+        else if (fs::is_directory(argument))
+        {
+            std::vector<std::string> directory_files;
+            for (const auto &entry : fs::directory_iterator(argument))
+            {
+                if (entry.path().extension() == ".json")
+                    directory_files.push_back(entry.path().string());
+            }
+            std::sort(directory_files.begin(), directory_files.end());
+            scenario_files.insert(scenario_files.end(), directory_files.begin(), directory_files.end());
+        }
+        else
+            scenario_files.push_back(argument);
+    }
+
+    if (scenario_files.empty())
+    {
+        std::cerr << "Usage: " << argv[0] << " [--config <dir>] [--report <json>] [--recording <folder>] [--virtual-time] <scenario.json|directory>...\n";
+        return 1;
+    }
+
+    bool all_completed = true;
+    std::ostringstream report;
+    report << std::setprecision(6) << "{\n  \"scenarios\": [";
+    for (size_t s = 0; s < scenario_files.size() && g_running; s++)
+    {
+        const std::string &scenario_file = scenario_files[s];
+        LOG_HEADER("Scenario " << scenario_file);
+
+        report << (s > 0 ? "," : "") << "\n    {\"scenario\": \"" << jsonEscape(scenario_file) << "\", ";
+        try
+        {
+            JackalLikeSimulation simulation(config_path, virtual_time ? std::make_shared<RosTools::VirtualClock>() : nullptr, recording_folder);
+            simulation.loadScenarioFile(scenario_file);
+            if (!simulation.hasScenario())
+                throw std::runtime_error("Could not load the scenario");
+
+            BENCHMARKERS.resetAll(); // Module timings per scenario
+            simulation.run();
+
+            const ScenarioResult &result = simulation.getResult();
+            report << "\"completed\": true"
+                   << ", \"cycles\": " << result.cycles
+                   << ", \"sim_time\": " << result.sim_time
+                   << ", \"wall_time\": " << result.wall_time
+                   << ", \"goal_reached\": " << (result.goal_reached_time >= 0.0 ? "true" : "false")
+                   << ", \"goal_reached_time\": " << result.goal_reached_time
+                   << ", \"failed_solves\": " << result.failed_solves
+                   << ", \"collision_cycles\": " << result.collision_cycles
+                   << ", \"max_intrusion\": " << result.max_intrusion
+                   << ", \"mean_solver_iterations\": " << (result.cycles > 0 ? (double)result.solver_iterations / result.cycles : 0.0)
+                   << ", \"max_solver_iterations\": " << result.max_solver_iterations
+                   << ",\n     \"solve\": " << benchmarkerToJson(result.solve)
+                   << ",\n     \"modules\": {";
+
+            for (int h = 0; h < BENCHMARKERS.getNumBenchmarkers(); h++)
+            {
+                report << (h > 0 ? ", " : "") << "\n       \"" << jsonEscape(BENCHMARKERS.getName(h)) << "\": "
+                       << benchmarkerToJson(BENCHMARKERS.getAggregate(h));
+            }
+            report << "}}";
+
+            LOG_VALUE("Cycles", result.cycles);
+            LOG_VALUE("Goal reached", (result.goal_reached_time >= 0.0));
+            LOG_VALUE("Collision cycles", result.collision_cycles);
+            LOG_VALUE("Solve p99 (ms)", result.solve.getPercentile(99.0) * 1000.0);
+        }
+        catch (const std::exception &e)
+        {
+            LOG_ERROR("Scenario " << scenario_file << " failed: " << e.what());
+            report << "\"completed\": false, \"error\": \"" << jsonEscape(e.what()) << "\"}";
+            all_completed = false;
+        }
+    }
+    report << "\n  ]\n}\n";
+
+    std::ofstream report_stream(report_file);
+    report_stream << report.str();
+    if (!report_stream.good())
+    {
+        std::cerr << "Could not write the report to " << report_file << "\n";
+        return 1;
+    }
+    LOG_INFO("Report written to " << report_file);
+
+    return all_completed ? 0 : 1;
+}
+#else
 int main(int argc, char **argv)
 {
     std::signal(SIGINT, handleSignal);
@@ -1930,3 +2471,4 @@ int main(int argc, char **argv)
         return 1;
     }
 }
+#endif
@@ -15,10 +15,19 @@ namespace MPCPlanner
 
   DynamicObstacle getDummyObstacle(const State &state);
 
+  /** @brief Analytic constant velocity prediction, reusing the storage of `prediction` (call expand() before indexing the modes) */
+  void setConstantVelocityPrediction(Prediction &prediction,
+                                     const Eigen::Vector2d &position,
+                                     const Eigen::Vector2d &velocity,
+                                     double dt, int steps);
+  /** @brief Analytic constant velocity prediction (call expand() before indexing the modes) */
   Prediction getConstantVelocityPrediction(const Eigen::Vector2d &position,
                                            const Eigen::Vector2d &velocity,
                                            double dt, int steps);
 
+  /** @brief Expand analytic predictions into their modes (done by ensureObstacleSize for the obstacles that are kept) */
+  void expandPredictions(std::vector<DynamicObstacle> &obstacles);
+
   void removeDistantObstacles(std::vector<DynamicObstacle> &obstacles, const State &state);
   void ensureObstacleSize(std::vector<DynamicObstacle> &obstacles, const State &state);
 
@@ -1,10 +1,12 @@
 #ifndef EXPERIMENT_UTIL_H
 #define EXPERIMENT_UTIL_H
 
+#include <ros_tools/data_recorder.h>
 #include <ros_tools/data_saver.h>
 
 #include <string>
 #include <memory>
+#include <vector>
 
 namespace RosTools
 {
@@ -32,9 +34,23 @@ namespace MPCPlanner
 
         RosTools::DataSaver &getDataSaver() const { return *_data_saver; };
 
+        /** @brief Binary recorder that replaces the DataSaver in non-ROS builds */
+        RosTools::DataRecorder &getDataRecorder() const { return *_data_recorder; };
+
     private:
         // Data is saved in this object
         std::shared_ptr<RosTools::DataSaver> _data_saver;
+        std::unique_ptr<RosTools::DataRecorder> _data_recorder;
+
+        // Columns of the recorder
+        struct ObstacleColumns
+        {
+            RosTools::ColumnHandle map, pose, orientation;
+        };
+        RosTools::ColumnHandle _vehicle_pose, _vehicle_orientation, _disc_pose, _disc_radius, _disc_obstacle;
+        RosTools::ColumnHandle _max_intrusion, _metric_collisions, _iteration, _reset, _metric_duration, _metric_completed;
+        std::vector<RosTools::ColumnHandle> _vehicle_plan;
+        std::vector<ObstacleColumns> _obstacle_columns; // Extended when more obstacles are received
 
         std::string _save_folder, _save_file;
 
@@ -0,0 +1,75 @@
+#ifndef MPC_PLANNER_INPUT_LOG_H
+#define MPC_PLANNER_INPUT_LOG_H
+
+#include <mpc_planner_types/data_types.h>
+
+#include <Eigen/Dense>
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+/**
+ * Binary log of the inputs of Planner::solveMPC (State and RealTimeData) and its output, one record per planning cycle,
+ * such that the planner can be replayed offline (see mpc_planner_replay).
+ *
+ * File format (little endian): the magic "MPCLOG01", followed by one record per cycle. The reference path and road
+ * boundaries are only stored in the cycles where they changed.
+ */
+
+namespace MPCPlanner
+{
+    struct State;
+    struct RealTimeData;
+    struct PlannerOutput;
+
+    /** @brief Everything about a logged cycle that is not part of the planner inputs */
+    struct InputLogCycle
+    {
+        double time{0.};                    // Simulation / robot time of the cycle [s]
+        bool reference_path_changed{false}; // The reference path and boundaries were (re)loaded in this cycle
+
+        // Output of the planner
+        bool success{false};
+        double planning_time{0.}; // [s]
+        std::vector<Eigen::Vector2d> trajectory;
+    };
+
+    class InputLogWriter
+    {
+    public:
+        bool open(const std::string &file_path);
+        void close();
+        bool isOpen() const { return _file.is_open(); }
+
+        /** @brief Record the inputs before calling solveMPC, followed by recordOutput() once it returns */
+        void recordInputs(double time, const State &state, const RealTimeData &data);
+        void recordOutput(const PlannerOutput &output, double planning_time);
+
+    private:
+        std::ofstream _file;
+        std::vector<char> _buffer; // The current record, written at once
+
+        ReferencePath _last_reference_path;
+        Boundary _last_left_bound, _last_right_bound;
+        bool _has_reference_path{false};
+    };
+
+    class InputLogReader
+    {
+    public:
+        bool open(const std::string &file_path);
+
+        /**
+         * @brief Read the next cycle into state and data (the reference path is kept from earlier cycles if it did not change)
+         * @return false at the end of the log (or when it is truncated)
+         */
+        bool read(InputLogCycle &cycle, State &state, RealTimeData &data);
+
+    private:
+        std::ifstream _file;
+        std::vector<double> _state_values;
+    };
+}
+
+#endif // MPC_PLANNER_INPUT_LOG_H
@@ -4,13 +4,15 @@
 #include <mpc_planner_types/data_types.h>
 #include <mpc_planner_types/module_data.h>
 
+#include <ros_tools/data_recorder.h>
+#include <ros_tools/profiling.h>
+
 #include <memory>
 #include <vector>
 
 namespace RosTools
 {
     class DataSaver;
-    class Timer;
 }
 
 namespace MPCPlanner
@@ -34,10 +36,12 @@ namespace MPCPlanner
     class Planner
     {
     public:
-        Planner();
+        /** @param clock Clock of the planning deadline and the timeouts of the solver and guidance planner (nullptr: the default clock) */
+        Planner(std::shared_ptr<RosTools::Clock> clock = nullptr);
 
     public:
-        PlannerOutput solveMPC(State &state, RealTimeData &data);
+        /** @brief Plan one cycle. The output is stored in the planner (no copy), it is valid until the next call */
+        const PlannerOutput &solveMPC(State &state, RealTimeData &data);
         double getSolution(int k, std::string &&var_name) const;
 
 
@@ -52,6 +56,12 @@ namespace MPCPlanner
 
         bool isObjectiveReached(const State &state, const RealTimeData &data) const;
 
+        /** @brief Iterations of the last solve (of the selected solver when planning in parallel) */
+        int getSolverIterations() const;
+
+        /** @brief Clock to set RealTimeData::planning_start_time with */
+        const std::shared_ptr<RosTools::Clock> &getClock() const;
+
         RosTools::DataSaver &getDataSaver() const;
 
     private:
@@ -67,6 +77,9 @@ namespace MPCPlanner
 
         std::unique_ptr<RosTools::Timer> _startup_timer;
 
+        RosTools::BenchmarkerHandle _planning_benchmarker, _optimization_benchmarker;
+        RosTools::ColumnHandle _runtime_control_loop_column, _runtime_optimization_column, _status_column;
+
         std::vector<std::shared_ptr<ControllerModule>> _modules;
     };
 
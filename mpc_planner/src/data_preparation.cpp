@@ -8,8 +8,11 @@
 
 #include <ros_tools/logging.h>
 #include <ros_tools/math.h>
+#include <ros_tools/obstacle_selection.h>
 
-#include <numeric>
+#include <algorithm>
+#include <cmath>
+#include <string>
 
 namespace MPCPlanner
 {
@@ -55,29 +58,39 @@ namespace MPCPlanner
                     0.);
         }
 
-        Prediction getConstantVelocityPrediction(const Eigen::Vector2d &position, const Eigen::Vector2d &velocity, double dt, int steps)
+        void setConstantVelocityPrediction(Prediction &prediction, const Eigen::Vector2d &position, const Eigen::Vector2d &velocity,
+                                           double dt, int steps)
         {
-                Prediction prediction;
-                double noise = 0.;
+                ConstantVelocityModel model;
+                model.position = position;
+                model.velocity = velocity;
+                model.dt = dt;
+                model.steps = steps;
+
                 if (CONFIG["probabilistic"]["enable"].as<bool>())
                 {
-                        prediction = Prediction(PredictionType::GAUSSIAN);
-                        noise = 0.3;
+                        model.noise = 0.3; // Uncertainty is propagated analytically
+                        prediction.setConstantVelocity(model, PredictionType::GAUSSIAN);
                 }
                 else
                 {
-                        prediction = Prediction(PredictionType::DETERMINISTIC);
+                        prediction.setConstantVelocity(model, PredictionType::DETERMINISTIC);
                 }
+        }
 
-                for (int i = 0; i < steps; i++)
-                        prediction.modes[0].push_back(PredictionStep(position + velocity * dt * i, 0., noise, noise));
-
-                if (CONFIG["probabilistic"]["enable"].as<bool>())
-                        propagatePredictionUncertainty(prediction);
-
+        Prediction getConstantVelocityPrediction(const Eigen::Vector2d &position, const Eigen::Vector2d &velocity, double dt, int steps)
+        {
+                Prediction prediction;
+                setConstantVelocityPrediction(prediction, position, velocity, dt, steps);
                 return prediction;
         }
 
+        void expandPredictions(std::vector<DynamicObstacle> &obstacles)
+        {
+                for (auto &obstacle : obstacles)
+                        obstacle.prediction.expand();
+        }
+
         void removeDistantObstacles(std::vector<DynamicObstacle> &obstacles, const State &state)
         {
                 std::vector<DynamicObstacle> nearby_obstacles;
@@ -96,98 +109,107 @@ namespace MPCPlanner
         {
                 size_t max_obstacles = CONFIG["max_obstacles"].as<int>();
 
-                // Create an index list
-                std::vector<int> indices;
-                indices.resize(obstacles.size());
-                std::iota(indices.begin(), indices.end(), 0);
-
-                // If more, we sort and retrieve the closest obstacles
+                // If more, we keep the most critical obstacles
                 if (obstacles.size() > max_obstacles)
                 {
-                        std::vector<double> distances;
-                        LOG_MARK("Received " << obstacles.size() << " > " << max_obstacles << " obstacles. Keeping the closest.");
+                        LOG_MARK("Received " << obstacles.size() << " > " << max_obstacles << " obstacles. Keeping the most critical.");
+
+                        int N = CONFIG["N"].as<int>();
+                        double dt = CONFIG["integrator_step"].as<double>();
+                        RosTools::RiskMetric metric = RosTools::riskMetricFromString(CONFIG["obstacle_ranking"].as<std::string>());
 
-                        Eigen::Vector2d obstacle_pos;
+                        // Predictions of all obstacles and the robot (constant velocity) over the horizon
+                        thread_local RosTools::ObstacleBlock block;
+                        block.resize(N, obstacles.size());
 
-                        distances.clear();
-                        for (auto &obstacle : obstacles)
+                        Eigen::Vector2d direction(std::cos(state.get("psi")), std::sin(state.get("psi")));
+                        Eigen::ArrayXd stage_times = dt * Eigen::ArrayXd::LinSpaced(N, 0., N - 1);
+                        Eigen::ArrayXd robot_x = state.get("x") + state.get("v") * direction(0) * stage_times;
+                        Eigen::ArrayXd robot_y = state.get("y") + state.get("v") * direction(1) * stage_times;
+
+                        for (size_t o = 0; o < obstacles.size(); o++)
                         {
-                                double dist;
-                                double min_dist = 1e5;
+                                const auto &obstacle = obstacles[o];
+                                block.radius(o) = obstacle.radius;
 
-                                Eigen::Vector2d direction(std::cos(state.get("psi")), std::sin(state.get("psi")));
-                                for (int k = 0; k < CONFIG["N"].as<int>(); k++)
+                                // Analytic predictions are evaluated directly, they are only expanded if the obstacle is kept
+                                bool has_prediction = !obstacle.prediction.empty();
+                                for (int k = 0; k < N; k++)
                                 {
-                                        // Linearly scaled
-                                        dist = (double)(k + 1) * 0.6 *
-                                               RosTools::distance(
-                                                   obstacle.prediction.modes[0][k].position,
-                                                   state.getPos() + state.get("v") * (double)k * direction);
-
-                                        if (dist < min_dist)
-                                                min_dist = dist;
+                                        // Hold the last predicted (or current) position if the prediction is shorter than the horizon
+                                        Eigen::Vector2d position = has_prediction ? obstacle.prediction.getPosition(k) : obstacle.position;
+                                        block.x(k, o) = position(0);
+                                        block.y(k, o) = position(1);
                                 }
-                                distances.push_back(min_dist);
                         }
 
-                        // Sort obstacles on distance
-                        std::sort(indices.begin(), indices.end(), [&](const int a, const int b)
-                                  { return (distances[a] < distances[b]); });
+                        // Rank each obstacle once, then select the most critical ones
+                        thread_local std::vector<RosTools::ObstacleRisk> risks;
+                        thread_local std::vector<int> selected;
+                        RosTools::computeObstacleRisks(block, robot_x, robot_y, CONFIG["robot_radius"].as<double>(), dt, metric, risks);
+                        RosTools::selectCriticalObstacles(risks, max_obstacles, selected);
 
-                        // Keep the closest obstacles
-                        std::vector<DynamicObstacle> processed_obstacles;
+                        // Swap with a buffer that is kept between calls, to reuse its storage
+                        thread_local std::vector<DynamicObstacle> processed_obstacles;
                         processed_obstacles.clear();
-
-                        for (size_t v = 0; v < max_obstacles; v++)
-                                processed_obstacles.push_back(obstacles[indices[v]]);
-
-                        for (size_t i = 0; i < processed_obstacles.size(); i++) // Sequential IDs
+                        for (size_t i = 0; i < selected.size(); i++)
                         {
-                                processed_obstacles[i].index = i;
+                                processed_obstacles.push_back(std::move(obstacles[selected[i]]));
+                                processed_obstacles.back().index = i; // Sequential IDs
                         }
 
-                        obstacles = processed_obstacles;
+                        obstacles.swap(processed_obstacles);
                 }
                 else if (obstacles.size() < max_obstacles)
                 {
                         LOG_MARK("Received " << obstacles.size() << " < " << max_obstacles << " obstacles. Adding dummies.");
 
+                        double dt = CONFIG["integrator_step"].as<double>();
+                        int N = CONFIG["N"].as<int>();
                         for (size_t cur_size = obstacles.size(); cur_size < max_obstacles; cur_size++)
                         {
                                 obstacles.push_back(getDummyObstacle(state));
 
                                 auto &obstacle = obstacles.back();
-                                obstacle.prediction = getConstantVelocityPrediction(obstacle.position,
-                                                                                    Eigen::Vector2d(0., 0.),
-                                                                                    CONFIG["integrator_step"].as<double>(),
-                                                                                    CONFIG["N"].as<int>());
+                                setConstantVelocityPrediction(obstacle.prediction, obstacle.position, Eigen::Vector2d(0., 0.), dt, N);
                         }
                 }
 
+                expandPredictions(obstacles);
+
                 LOG_MARK("Obstacle size (after processing) is: " << obstacles.size());
         }
 
-        void propagatePredictionUncertainty(Prediction &prediction)
+        static void propagatePredictionUncertainty(Prediction &prediction, double dt, int N)
         {
-                if (prediction.type != PredictionType::GAUSSIAN)
+                // Analytic predictions already hold the propagated uncertainty
+                if (prediction.type != PredictionType::GAUSSIAN || prediction.analytic)
                         return;
 
-                double dt = CONFIG["integrator_step"].as<double>();
-                double major = 0.;
-                double minor = 0.;
+                double major_squared = 0.;
+                double minor_squared = 0.;
 
-                for (int k = 0; k < CONFIG["N"].as<int>(); k++)
+                Mode &mode = prediction.modes[0];
+                int steps = std::min(N, (int)mode.size());
+                for (int k = 0; k < steps; k++)
                 {
-                        major = std::sqrt(std::pow(major, 2.0) + std::pow(prediction.modes[0][k].major_radius * dt, 2.));
-                        minor = std::sqrt(std::pow(minor, 2.0) + std::pow(prediction.modes[0][k].minor_radius * dt, 2.));
-                        prediction.modes[0][k].major_radius = major;
-                        prediction.modes[0][k].minor_radius = minor;
+                        major_squared += mode[k].major_radius * mode[k].major_radius * dt * dt;
+                        minor_squared += mode[k].minor_radius * mode[k].minor_radius * dt * dt;
+                        mode[k].major_radius = std::sqrt(major_squared);
+                        mode[k].minor_radius = std::sqrt(minor_squared);
                 }
         }
 
+        void propagatePredictionUncertainty(Prediction &prediction)
+        {
+                propagatePredictionUncertainty(prediction, CONFIG["integrator_step"].as<double>(), CONFIG["N"].as<int>());
+        }
+
         void propagatePredictionUncertainty(std::vector<DynamicObstacle> &obstacles)
         {
+                double dt = CONFIG["integrator_step"].as<double>();
+                int N = CONFIG["N"].as<int>();
                 for (auto &obstacle : obstacles)
-                        propagatePredictionUncertainty(obstacle.prediction);
+                        propagatePredictionUncertainty(obstacle.prediction, dt, N);
         }
 }
\ No newline at end of file
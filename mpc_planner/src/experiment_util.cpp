@@ -26,8 +26,28 @@ namespace MPCPlanner
         if (CONFIG["recording"]["enable"].as<bool>())
             LOG_VALUE("Planner Save File", _data_saver->getFilePath(_save_folder, _save_file, false));
 #else
-        // Data saving disabled in non-ROS mode
-        LOG_INFO("ExperimentUtil: Data saving disabled (non-ROS mode)");
+        // Non-ROS: record into preallocated columns that are written to a binary file in the background
+        _save_folder = CONFIG["recording"]["folder"].as<std::string>();
+        _save_file = CONFIG["recording"]["file"].as<std::string>();
+
+        _data_recorder = std::make_unique<RosTools::DataRecorder>();
+        _vehicle_pose = _data_recorder->addColumn("vehicle_pose", 2);
+        _vehicle_orientation = _data_recorder->addColumn("vehicle_orientation");
+        for (int k = 0; k < CONFIG["N"].as<int>(); k++)
+            _vehicle_plan.push_back(_data_recorder->addColumn("vehicle_plan_" + std::to_string(k), 2));
+
+        _disc_pose = _data_recorder->addColumn("disc_0_pose", 2);
+        _disc_radius = _data_recorder->addColumn("disc_0_radius");
+        _disc_obstacle = _data_recorder->addColumn("disc_0_obstacle");
+        _max_intrusion = _data_recorder->addColumn("max_intrusion");
+        _metric_collisions = _data_recorder->addColumn("metric_collisions");
+        _iteration = _data_recorder->addColumn("iteration");
+        _reset = _data_recorder->addColumn("reset");
+        _metric_duration = _data_recorder->addColumn("metric_duration");
+        _metric_completed = _data_recorder->addColumn("metric_completed");
+
+        if (CONFIG["recording"]["enable"].as<bool>())
+            _data_recorder->open(_save_folder + "/" + _save_file + ".mpcrec");
 #endif
     }
 
@@ -77,10 +97,46 @@ namespace MPCPlanner
         _data_saver->AddData("iteration", _control_iteration);
         _control_iteration++;
 #else
-        // Data saving disabled in non-ROS mode
-        (void)state;
-        (void)solver;
-        (void)data;
+        if (!_data_recorder->isOpen() || data.dynamic_obstacles.size() == 0)
+            return;
+
+        auto &recorder = *_data_recorder;
+        recorder.append(_vehicle_pose, state.getPos());
+        recorder.append(_vehicle_orientation, state.get("psi"));
+
+        for (size_t k = 0; k < _vehicle_plan.size(); k++)
+            recorder.append(_vehicle_plan[k], solver->getEgoPredictionPosition(k));
+
+        for (size_t v = 0; v < data.dynamic_obstacles.size(); v++)
+        {
+            auto &obstacle = data.dynamic_obstacles[v];
+
+            if (obstacle.index != -1)
+            {
+                while (_obstacle_columns.size() <= v) // Only when more obstacles are received than before
+                {
+                    std::string name = "obstacle_" + std::to_string(_obstacle_columns.size());
+                    _obstacle_columns.push_back({recorder.addColumn("obstacle_map_" + std::to_string(_obstacle_columns.size())),
+                                                 recorder.addColumn(name + "_pose", 2),
+                                                 recorder.addColumn(name + "_orientation")});
+                }
+
+                recorder.append(_obstacle_columns[v].map, obstacle.index);
+                recorder.append(_obstacle_columns[v].pose, obstacle.position);
+                recorder.append(_obstacle_columns[v].orientation, obstacle.angle);
+            }
+
+            recorder.append(_disc_pose, obstacle.position);
+            recorder.append(_disc_radius, obstacle.radius);
+            recorder.append(_disc_obstacle, v);
+        }
+        recorder.append(_max_intrusion, data.intrusion);
+        recorder.append(_metric_collisions, double(data.intrusion > 0.));
+
+        recorder.append(_iteration, _control_iteration);
+        _control_iteration++;
+
+        recorder.flush(); // Hand this cycle to the writer thread
 #endif
     }
 
@@ -88,6 +144,8 @@ namespace MPCPlanner
     {
 #ifdef MPC_PLANNER_ROS
         _data_saver->SaveData(_save_folder, _save_file);
+#else
+        _data_recorder->flush(); // The file is written continuously
 #endif
     }
 
@@ -125,15 +183,23 @@ namespace MPCPlanner
         }
         ROSTOOLS_ASSERT(_experiment_counter < num_experiments, "Stopping the planner.");
 #else
-        // Data saving disabled in non-ROS mode
-        (void)objective_reached;
+        if (!_data_recorder->isOpen())
+            return;
+
+        _data_recorder->append(_reset, _control_iteration);
+        _data_recorder->append(_metric_duration,
+                               (_control_iteration - _iteration_at_last_reset) * (1.0 / CONFIG["control_frequency"].as<double>()));
+        _data_recorder->append(_metric_completed, (double)objective_reached);
+        _iteration_at_last_reset = _control_iteration;
+
+        _experiment_counter++;
+        exportData();
+        LOG_INFO("Recorded experiment " << _experiment_counter);
 #endif
     }
 
     void ExperimentUtil::setStartExperiment()
     {
-#ifdef MPC_PLANNER_ROS
         _iteration_at_last_reset = _control_iteration;
-#endif
     }
 }
\ No newline at end of file
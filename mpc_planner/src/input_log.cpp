@@ -0,0 +1,354 @@
+#include "mpc_planner/input_log.h"
+
+#include <mpc_planner/planner.h>
+
+#include <mpc_planner_solver/state.h>
+#include <mpc_planner_types/realtime_data.h>
+
+#include <ros_tools/logging.h>
+
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+
+namespace MPCPlanner
+{
+    static const char MAGIC[8] = {'M', 'P', 'C', 'L', 'O', 'G', '0', '1'};
+
+    enum InputLogFlags : uint8_t
+    {
+        HAS_REFERENCE_PATH = 1,
+        GOAL_RECEIVED = 2
+    };
+
+    // Writing into the record buffer
+    template <typename T>
+    static void put(std::vector<char> &buffer, const T &value)
+    {
+        const char *bytes = reinterpret_cast<const char *>(&value);
+        buffer.insert(buffer.end(), bytes, bytes + sizeof(T));
+    }
+
+    static void put(std::vector<char> &buffer, const Eigen::Vector2d &value)
+    {
+        put(buffer, value(0));
+        put(buffer, value(1));
+    }
+
+    static void put(std::vector<char> &buffer, const std::vector<double> &values)
+    {
+        put(buffer, (uint32_t)values.size());
+        const char *bytes = reinterpret_cast<const char *>(values.data());
+        buffer.insert(buffer.end(), bytes, bytes + values.size() * sizeof(double));
+    }
+
+    static void put(std::vector<char> &buffer, const ReferencePath &path)
+    {
+        put(buffer, path.x);
+        put(buffer, path.y);
+        put(buffer, path.psi);
+        put(buffer, path.v);
+        put(buffer, path.s);
+    }
+
+    // Reading from the file
+    template <typename T>
+    static bool get(std::ifstream &file, T &value)
+    {
+        return (bool)file.read(reinterpret_cast<char *>(&value), sizeof(T));
+    }
+
+    static bool get(std::ifstream &file, Eigen::Vector2d &value)
+    {
+        return get(file, value(0)) && get(file, value(1));
+    }
+
+    static bool get(std::ifstream &file, std::vector<double> &values)
+    {
+        uint32_t size;
+        if (!get(file, size))
+            return false;
+
+        values.resize(size);
+        return (bool)file.read(reinterpret_cast<char *>(values.data()), size * sizeof(double));
+    }
+
+    static bool get(std::ifstream &file, ReferencePath &path)
+    {
+        return get(file, path.x) && get(file, path.y) && get(file, path.psi) && get(file, path.v) && get(file, path.s);
+    }
+
+    static bool equal(const ReferencePath &a, const ReferencePath &b)
+    {
+        return a.x == b.x && a.y == b.y && a.psi == b.psi && a.v == b.v && a.s == b.s;
+    }
+
+    bool InputLogWriter::open(const std::string &file_path)
+    {
+        close();
+
+        std::filesystem::path path(file_path);
+        std::error_code error;
+        if (path.has_parent_path())
+            std::filesystem::create_directories(path.parent_path(), error);
+
+        _file.open(file_path, std::ios::binary | std::ios::trunc);
+        if (!_file.good())
+        {
+            LOG_WARN("Input Log: Could not open " << file_path << ", not logging the planner inputs");
+            _file.close();
+            return false;
+        }
+
+        LOG_INFO("Input Log: Logging the planner inputs to " << file_path);
+        _file.write(MAGIC, sizeof(MAGIC));
+        _has_reference_path = false;
+        return true;
+    }
+
+    void InputLogWriter::close()
+    {
+        if (_file.is_open())
+            _file.close();
+    }
+
+    void InputLogWriter::recordInputs(double time, const State &state, const RealTimeData &data)
+    {
+        if (!isOpen())
+            return;
+
+        _buffer.clear(); // Keeps its capacity
+        put(_buffer, 'Y');
+        put(_buffer, time);
+        put(_buffer, state.getValues());
+
+        // The reference path is only stored when it changes
+        bool path_changed = !_has_reference_path || !equal(data.reference_path, _last_reference_path) ||
+                            !equal(data.left_bound, _last_left_bound) || !equal(data.right_bound, _last_right_bound);
+
+        uint8_t flags = (path_changed ? HAS_REFERENCE_PATH : 0) | (data.goal_received ? GOAL_RECEIVED : 0);
+        put(_buffer, flags);
+        if (path_changed)
+        {
+            put(_buffer, data.reference_path);
+            put(_buffer, data.left_bound);
+            put(_buffer, data.right_bound);
+
+            _last_reference_path = data.reference_path;
+            _last_left_bound = data.left_bound;
+            _last_right_bound = data.right_bound;
+            _has_reference_path = true;
+        }
+
+        put(_buffer, data.goal);
+        put(_buffer, data.intrusion);
+
+        put(_buffer, (uint32_t)data.robot_area.size());
+        for (auto &disc : data.robot_area)
+        {
+            put(_buffer, disc.offset);
+            put(_buffer, disc.radius);
+        }
+
+        put(_buffer, (uint32_t)data.past_trajectory.capacity());
+        put(_buffer, (uint32_t)data.past_trajectory.size());
+        for (int i = 0; i < data.past_trajectory.size(); i++)
+            put(_buffer, data.past_trajectory[i]);
+
+        put(_buffer, (uint32_t)data.dynamic_obstacles.size());
+        for (auto &obstacle : data.dynamic_obstacles)
+        {
+            put(_buffer, (int32_t)obstacle.index);
+            put(_buffer, obstacle.position);
+            put(_buffer, obstacle.angle);
+            put(_buffer, obstacle.radius);
+            put(_buffer, (uint8_t)obstacle.type);
+
+            const Prediction &prediction = obstacle.prediction;
+            put(_buffer, (uint8_t)prediction.type);
+            put(_buffer, (uint8_t)prediction.analytic);
+            if (prediction.analytic) // Only the model, the modes follow from it
+            {
+                const ConstantVelocityModel &model = prediction.constant_velocity;
+                put(_buffer, model.position);
+                put(_buffer, model.velocity);
+                put(_buffer, model.dt);
+                put(_buffer, (int32_t)model.steps);
+                put(_buffer, model.noise);
+                continue;
+            }
+
+            put(_buffer, (uint32_t)prediction.modes.size());
+            for (auto &mode : prediction.modes)
+            {
+                put(_buffer, (uint32_t)mode.size());
+                for (auto &step : mode)
+                {
+                    put(_buffer, step.position);
+                    put(_buffer, step.angle);
+                    put(_buffer, step.major_radius);
+                    put(_buffer, step.minor_radius);
+                }
+            }
+            put(_buffer, prediction.probabilities);
+        }
+    }
+
+    void InputLogWriter::recordOutput(const PlannerOutput &output, double planning_time)
+    {
+        if (!isOpen() || _buffer.empty())
+            return;
+
+        put(_buffer, (uint8_t)output.success);
+        put(_buffer, planning_time);
+        put(_buffer, (uint32_t)output.trajectory.positions.size());
+        for (auto &position : output.trajectory.positions)
+            put(_buffer, position);
+
+        _file.write(_buffer.data(), _buffer.size());
+        _buffer.clear();
+    }
+
+    bool InputLogReader::open(const std::string &file_path)
+    {
+        _file.open(file_path, std::ios::binary);
+
+        char magic[sizeof(MAGIC)];
+        if (!_file.read(magic, sizeof(magic)) || std::memcmp(magic, MAGIC, sizeof(MAGIC)) != 0)
+        {
+            LOG_WARN("Input Log: " << file_path << " is not an input log");
+            _file.close();
+            return false;
+        }
+        return true;
+    }
+
+    bool InputLogReader::read(InputLogCycle &cycle, State &state, RealTimeData &data)
+    {
+        char type;
+        if (!_file.is_open() || !_file.get(type) || type != 'Y')
+            return false;
+
+        uint8_t flags;
+        if (!get(_file, cycle.time) || !get(_file, _state_values) || !get(_file, flags))
+            return false;
+        state.setValues(_state_values);
+
+        cycle.reference_path_changed = flags & HAS_REFERENCE_PATH;
+        if (cycle.reference_path_changed &&
+            !(get(_file, data.reference_path) && get(_file, data.left_bound) && get(_file, data.right_bound)))
+            return false;
+
+        data.goal_received = flags & GOAL_RECEIVED;
+        if (!get(_file, data.goal) || !get(_file, data.intrusion))
+            return false;
+
+        uint32_t size, capacity;
+        if (!get(_file, size))
+            return false;
+        data.robot_area.clear();
+        for (uint32_t i = 0; i < size; i++)
+        {
+            double offset, radius;
+            if (!get(_file, offset) || !get(_file, radius))
+                return false;
+            data.robot_area.emplace_back(offset, radius);
+        }
+
+        if (!get(_file, capacity) || !get(_file, size))
+            return false;
+        if (data.past_trajectory.capacity() != (int)capacity)
+            data.past_trajectory = FixedSizeTrajectory(capacity);
+        data.past_trajectory.clear();
+        for (uint32_t i = 0; i < size; i++)
+        {
+            Eigen::Vector2d position;
+            if (!get(_file, position))
+                return false;
+            data.past_trajectory.add(position);
+        }
+
+        uint32_t num_obstacles;
+        if (!get(_file, num_obstacles))
+            return false;
+        for (uint32_t i = 0; i < num_obstacles; i++)
+        {
+            int32_t index;
+            Eigen::Vector2d position;
+            double angle, radius;
+            uint8_t obstacle_type, prediction_type, analytic;
+            if (!get(_file, index) || !get(_file, position) || !get(_file, angle) || !get(_file, radius) ||
+                !get(_file, obstacle_type) || !get(_file, prediction_type) || !get(_file, analytic))
+                return false;
+
+            // Reuse the obstacles (and their prediction storage) of the previous cycle
+            if (i < data.dynamic_obstacles.size())
+            {
+                auto &obstacle = data.dynamic_obstacles[i];
+                obstacle.index = index;
+                obstacle.position = position;
+                obstacle.angle = angle;
+                obstacle.radius = radius;
+                obstacle.type = (ObstacleType)obstacle_type;
+            }
+            else
+                data.dynamic_obstacles.emplace_back(index, position, angle, radius, (ObstacleType)obstacle_type);
+
+            Prediction &prediction = data.dynamic_obstacles[i].prediction;
+            if (analytic)
+            {
+                ConstantVelocityModel model;
+                int32_t steps;
+                if (!get(_file, model.position) || !get(_file, model.velocity) || !get(_file, model.dt) ||
+                    !get(_file, steps) || !get(_file, model.noise))
+                    return false;
+                model.steps = steps;
+                prediction.setConstantVelocity(model, (PredictionType)prediction_type);
+                continue;
+            }
+
+            prediction.type = (PredictionType)prediction_type;
+            prediction.analytic = false;
+            prediction.expanded = false;
+
+            uint32_t num_modes;
+            if (!get(_file, num_modes))
+                return false;
+            prediction.modes.resize(num_modes);
+            for (auto &mode : prediction.modes)
+            {
+                uint32_t num_steps;
+                if (!get(_file, num_steps))
+                    return false;
+
+                mode.clear();
+                for (uint32_t k = 0; k < num_steps; k++)
+                {
+                    Eigen::Vector2d step_position;
+                    double step_angle, major_radius, minor_radius;
+                    if (!get(_file, step_position) || !get(_file, step_angle) || !get(_file, major_radius) || !get(_file, minor_radius))
+                        return false;
+                    mode.emplace_back(step_position, step_angle, major_radius, minor_radius);
+                }
+            }
+            if (!get(_file, prediction.probabilities))
+                return false;
+        }
+        data.dynamic_obstacles.erase(data.dynamic_obstacles.begin() + num_obstacles, data.dynamic_obstacles.end());
+
+        uint8_t success;
+        uint32_t trajectory_size;
+        if (!get(_file, success) || !get(_file, cycle.planning_time) || !get(_file, trajectory_size))
+            return false;
+        cycle.success = success;
+
+        cycle.trajectory.resize(trajectory_size);
+        for (auto &position : cycle.trajectory)
+        {
+            if (!get(_file, position))
+                return false;
+        }
+
+        return true;
+    }
+}
@@ -22,27 +22,44 @@
 namespace MPCPlanner
 {
 
-    Planner::Planner()
+    Planner::Planner(std::shared_ptr<RosTools::Clock> clock)
     {
-        // Initialize the solver
+        // Initialize the solver (the modules take the clock from the solver)
         _solver = std::make_shared<Solver>();
         _solver->reset();
+        _solver->setClock(clock);
 
         initializeModules(_modules, _solver);
 
         _experiment_util = std::make_shared<ExperimentUtil>();
 
-        _startup_timer = std::make_unique<RosTools::Timer>(1.0); // Give some time to receive data
+        _startup_timer = std::make_unique<RosTools::Timer>(1.0, _solver->getClock()); // Give some time to receive data
+
+        _planning_benchmarker = BENCHMARKERS.registerBenchmarker("planning");
+        BENCHMARKERS.setDeadline(_planning_benchmarker, 1. / CONFIG["control_frequency"].as<double>()); // Count missed control cycles
+        _optimization_benchmarker = BENCHMARKERS.registerBenchmarker("optimization");
+
+#ifndef MPC_PLANNER_ROS
+        auto &recorder = _experiment_util->getDataRecorder();
+        _runtime_control_loop_column = recorder.addColumn("runtime_control_loop");
+        _runtime_optimization_column = recorder.addColumn("runtime_optimization");
+        _status_column = recorder.addColumn("status");
+        for (auto &module : _modules)
+            module->addColumns(recorder);
+#endif
     }
 
     // Given real-time data, solve the MPC problem
-    PlannerOutput Planner::solveMPC(State &state, RealTimeData &data)
+    const PlannerOutput &Planner::solveMPC(State &state, RealTimeData &data)
     {
         LOG_MARK("Planner::solveMPC");
         bool was_feasible = _output.success;
-        _output = PlannerOutput(_solver->dt, _solver->N);
+        // Reset the output and module data, keeping their storage for this cycle
+        _output.success = false;
+        _output.trajectory.dt = _solver->dt;
+        _output.trajectory.positions.clear();
 
-        _module_data = ModuleData(); // Reset module data
+        _module_data.reset();
 
         // Check if all modules have enough data
         _is_data_ready = true;
@@ -70,7 +87,7 @@ namespace MPCPlanner
         {
             PROFILE_SCOPE("Planning");
 
-            auto &planning_benchmarker = BENCHMARKERS.getBenchmarker("planning");
+            auto &planning_benchmarker = BENCHMARKERS.getBenchmarker(_planning_benchmarker);
             if (planning_benchmarker.isRunning())
                 planning_benchmarker.cancel();
 
@@ -116,14 +133,14 @@ namespace MPCPlanner
 
             _solver->loadWarmstart();
 
-            std::chrono::duration<double> used_time = std::chrono::system_clock::now() - data.planning_start_time;
-            _solver->_params.solver_timeout = 1. / CONFIG["control_frequency"].as<double>() - used_time.count() - 0.006;
+            double used_time = _solver->getClock()->secondsSince(data.planning_start_time);
+            _solver->_params.solver_timeout = 1. / CONFIG["control_frequency"].as<double>() - used_time - 0.006;
 
             // Solve MPC
             LOG_MARK("Solve optimization");
             {
                 PROFILE_SCOPE("Optimization");
-                BENCHMARKERS.getBenchmarker("optimization").start();
+                BENCHMARKERS.getBenchmarker(_optimization_benchmarker).start();
                 exit_flag = EXIT_CODE_NOT_OPTIMIZED_YET;
                 for (auto &module : _modules)
                 {
@@ -133,7 +150,7 @@ namespace MPCPlanner
                 }
                 if (exit_flag == EXIT_CODE_NOT_OPTIMIZED_YET)
                     exit_flag = _solver->solve();
-                BENCHMARKERS.getBenchmarker("optimization").stop();
+                BENCHMARKERS.getBenchmarker(_optimization_benchmarker).stop();
             }
 
             planning_benchmarker.stop();
@@ -164,6 +181,17 @@ namespace MPCPlanner
         return _solver->getOutput(k, std::forward<std::string>(var_name));
     }
 
+    int Planner::getSolverIterations() const
+    {
+#ifdef ACADOS_SOLVER
+        return _solver->_info.sqp_iter;
+#else
+        return _solver->_info.it;
+#endif
+    }
+
+    const std::shared_ptr<RosTools::Clock> &Planner::getClock() const { return _solver->getClock(); }
+
     RosTools::DataSaver &Planner::getDataSaver() const
     {
         return _experiment_util->getDataSaver();
@@ -210,22 +238,33 @@ namespace MPCPlanner
         if (!_is_data_ready)
             return;
 
-        auto &data_saver = _experiment_util->getDataSaver();
-
         // Save planning data
-        double planning_time = BENCHMARKERS.getBenchmarker("planning").getLast();
-        data_saver.AddData("runtime_control_loop", planning_time);
+        double planning_time = BENCHMARKERS.getBenchmarker(_planning_benchmarker).getLast();
         if (planning_time > 1. / CONFIG["control_frequency"].as<double>())
             LOG_WARN("Planning took too long: " << planning_time << " ms");
-        data_saver.AddData("runtime_optimization", BENCHMARKERS.getBenchmarker("optimization").getLast());
+        double optimization_time = BENCHMARKERS.getBenchmarker(_optimization_benchmarker).getLast();
+        double status = _output.success ? 2. : 3.; // 3 and 2 for backward compatilibity
 
-        if (!_output.success)
-            data_saver.AddData("status", 3.); // 3 and 2 for backward compatilibity
-        else
-            data_saver.AddData("status", 2.);
+#ifdef MPC_PLANNER_ROS
+        auto &data_saver = _experiment_util->getDataSaver();
+        data_saver.AddData("runtime_control_loop", planning_time);
+        data_saver.AddData("runtime_optimization", optimization_time);
+        data_saver.AddData("status", status);
 
         for (auto &module : _modules)
             module->saveData(data_saver);
+#else
+        auto &recorder = _experiment_util->getDataRecorder();
+        if (recorder.isOpen())
+        {
+            recorder.append(_runtime_control_loop_column, planning_time);
+            recorder.append(_runtime_optimization_column, optimization_time);
+            recorder.append(_status_column, status);
+
+            for (auto &module : _modules)
+                module->saveData(recorder);
+        }
+#endif
 
         _experiment_util->update(state, _solver, data);
     }
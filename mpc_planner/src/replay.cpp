@@ -0,0 +1,183 @@
+/**
+ * Replays a log of planner inputs (see input_log.h) through the Planner, cycle by cycle without waiting (the timeouts of
+ * the planner follow the logged time instead of the wall clock) and with fixed random seeds. Reports the planning time of each cycle and how
+ * the output differs from a baseline, to find and bisect performance regressions offline.
+ *
+ * Usage: mpc_planner_replay <input_log> [--config <dir>] [--baseline <log>] [--output <log>] [--report <csv>] [--seed <n>]
+ *  --baseline: log to compare against (default: the outputs recorded in the input log)
+ *  --output:   log the replayed cycles (inputs and new outputs), to be used as baseline later
+ *  --report:   per-cycle CSV report
+ */
+#include <mpc_planner/planner.h>
+#include <mpc_planner/input_log.h>
+#include <mpc_planner/data_preparation.h>
+#include <mpc_planner_solver/state.h>
+#include <mpc_planner_types/realtime_data.h>
+#include <mpc_planner_util/parameters.h>
+
+#include <ros_tools/latency_histogram.h>
+#include <ros_tools/logging.h>
+#include <ros_tools/profiling.h>
+#include <ros_tools/random_generator.h>
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+namespace fs = std::filesystem;
+using namespace MPCPlanner;
+
+static double maxDeviation(const std::vector<Eigen::Vector2d> &trajectory, const std::vector<Eigen::Vector2d> &baseline)
+{
+    if (trajectory.size() != baseline.size())
+        return std::numeric_limits<double>::infinity();
+
+    double deviation = 0.;
+    for (size_t k = 0; k < trajectory.size(); k++)
+        deviation = std::max(deviation, (trajectory[k] - baseline[k]).norm());
+    return deviation;
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 2)
+    {
+        std::cerr << "Usage: " << argv[0] << " <input_log> [--config <dir>] [--baseline <log>] [--output <log>] [--report <csv>] [--seed <n>]\n";
+        return 1;
+    }
+
+    std::string input_file = argv[1], baseline_file, output_file, report_file;
+    fs::path config_path = "mpc_planner_jackalsimulator/config";
+    int seed = 1;
+    for (int i = 2; i < argc; i += 2)
+    {
+        std::string option = argv[i];
+        if (i + 1 >= argc)
+        {
+            std::cerr << "Missing value for " << option << "\n";
+            return 1;
+        }
+
+        if (option == "--config")
+            config_path = argv[i + 1];
+        else if (option == "--baseline")
+            baseline_file = argv[i + 1];
+        else if (option == "--output")
+            output_file = argv[i + 1];
+        else if (option == "--report")
+            report_file = argv[i + 1];
+        else if (option == "--seed")
+            seed = std::stoi(argv[i + 1]);
+        else
+        {
+            std::cerr << "Unknown option: " << option << "\n";
+            return 1;
+        }
+    }
+
+    if (fs::is_directory(config_path))
+        config_path /= "settings.yaml";
+    if (!fs::exists(config_path))
+    {
+        std::cerr << "Config file not found: " << config_path << "\n";
+        return 1;
+    }
+    Configuration::getInstance().initialize(config_path.string());
+
+    // Deterministic: no random seeds, no waiting for the control period
+    RosTools::RandomGenerator::setDefaultSeed(seed);
+
+    InputLogReader reader, baseline_reader;
+    if (!reader.open(input_file) || (!baseline_file.empty() && !baseline_reader.open(baseline_file)))
+        return 1;
+
+    InputLogWriter writer;
+    if (!output_file.empty() && !writer.open(output_file))
+        return 1;
+
+    std::ofstream report;
+    if (!report_file.empty())
+    {
+        report.open(report_file);
+        report << "cycle,time,planning_time,baseline_planning_time,success,baseline_success,max_deviation\n";
+    }
+
+    // The timeouts of the planner follow the logged time instead of the speed of this machine
+    auto clock = std::make_shared<RosTools::VirtualClock>();
+    Planner planner(clock);
+    State state, baseline_state;
+    RealTimeData data, baseline_data;
+    InputLogCycle cycle, baseline;
+
+    RosTools::Benchmarker replay_benchmarker("replay");
+    replay_benchmarker.setDeadline(1. / CONFIG["control_frequency"].as<double>());
+    RosTools::LatencyHistogram baseline_histogram;
+
+    int num_cycles = 0, success_mismatches = 0, slowest_cycle = -1;
+    double max_deviation = 0., slowest_time = 0.;
+    while (reader.read(cycle, state, data))
+    {
+        if (!baseline_file.empty())
+        {
+            if (!baseline_reader.read(baseline, baseline_state, baseline_data))
+            {
+                LOG_WARN("The baseline ends after " << num_cycles << " cycles");
+                break;
+            }
+        }
+        else
+            baseline = cycle;
+
+        // Deliver the inputs as the robot did
+        if (cycle.reference_path_changed)
+            planner.onDataReceived(data, "reference_path");
+        expandPredictions(data.dynamic_obstacles);
+        planner.onDataReceived(data, "dynamic obstacles");
+
+        writer.recordInputs(cycle.time, state, data);
+
+        clock->setTime(cycle.time);
+        data.planning_start_time = clock->now();
+        replay_benchmarker.start();
+        const PlannerOutput &output = planner.solveMPC(state, data);
+        double planning_time = replay_benchmarker.stop();
+
+        writer.recordOutput(output, planning_time);
+
+        // Compare against the baseline
+        baseline_histogram.record(baseline.planning_time);
+        double deviation = (output.success && baseline.success) ? maxDeviation(output.trajectory.positions, baseline.trajectory) : 0.;
+        if (output.success != baseline.success)
+            success_mismatches++;
+        max_deviation = std::max(max_deviation, deviation);
+        if (planning_time > slowest_time)
+        {
+            slowest_time = planning_time;
+            slowest_cycle = num_cycles;
+        }
+
+        if (report.is_open())
+        {
+            report << num_cycles << "," << cycle.time << "," << planning_time << "," << baseline.planning_time << ","
+                   << output.success << "," << baseline.success << "," << deviation << "\n";
+        }
+        num_cycles++;
+    }
+
+    writer.close();
+
+    LOG_DIVIDER();
+    LOG_VALUE("Replayed cycles", num_cycles);
+    replay_benchmarker.print();
+    LOG_VALUE("Baseline p50 (ms)", baseline_histogram.getPercentile(50.) * 1000.);
+    LOG_VALUE("Baseline p99 (ms)", baseline_histogram.getPercentile(99.) * 1000.);
+    LOG_VALUE("Replay p99 / baseline p99", replay_benchmarker.getPercentile(99.) / std::max(baseline_histogram.getPercentile(99.), 1e-9));
+    LOG_VALUE("Slowest cycle", slowest_cycle);
+    LOG_VALUE("Success mismatches", success_mismatches);
+    LOG_VALUE("Max trajectory deviation (m)", max_deviation);
+
+    return 0;
+}
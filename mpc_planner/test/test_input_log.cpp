@@ -0,0 +1,238 @@
+/** Checks that the input log (see input_log.h) reads back exactly what was recorded, cycle by cycle */
+#include <gtest/gtest.h>
+
+#include <mpc_planner/input_log.h>
+#include <mpc_planner/planner.h>
+#include <mpc_planner_solver/state.h>
+#include <mpc_planner_types/realtime_data.h>
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+using namespace MPCPlanner;
+
+/** @brief The inputs and output of one logged cycle */
+struct LoggedCycle
+{
+    double time;
+    std::vector<double> state;
+    RealTimeData data;
+    PlannerOutput output;
+    double planning_time;
+    bool reference_path_changed;
+};
+
+static ReferencePath StraightPath(double y, int points)
+{
+    ReferencePath path;
+    path.clear();
+    for (int i = 0; i < points; i++)
+    {
+        path.x.push_back(0.5 * i);
+        path.y.push_back(y + 0.01 * i * i);
+        path.psi.push_back(0.02 * i);
+        path.v.push_back(1. + 0.1 * i);
+        path.s.push_back(0.5 * i);
+    }
+    return path;
+}
+
+/** @brief A deterministic Gaussian prediction with two modes, stored step by step */
+static Prediction ModesPrediction(double offset)
+{
+    Prediction prediction;
+    prediction.type = PredictionType::GAUSSIAN;
+    for (int m = 0; m < 2; m++)
+    {
+        prediction.modes.emplace_back();
+        for (int k = 0; k < 4; k++)
+            prediction.modes.back().emplace_back(Eigen::Vector2d(offset + k, m - 0.5 * k), 0.1 * k, 0.3 + 0.1 * k, 0.2 + 0.05 * k);
+    }
+    prediction.probabilities = {0.75, 0.25};
+    return prediction;
+}
+
+/** @brief Three cycles: the reference path is loaded, kept and then replaced, with analytic and stored predictions */
+static std::vector<LoggedCycle> TestCycles(int nx)
+{
+    std::vector<LoggedCycle> cycles(3);
+    for (int i = 0; i < (int)cycles.size(); i++)
+    {
+        LoggedCycle &cycle = cycles[i];
+        cycle.time = 0.1 * i;
+        cycle.state.resize(nx);
+        for (int j = 0; j < nx; j++)
+            cycle.state[j] = i + 0.125 * j;
+
+        RealTimeData &data = cycle.data;
+        data.robot_area = {Disc(-0.2, 0.35), Disc(0.2, 0.35)};
+        data.past_trajectory = FixedSizeTrajectory(4);
+        for (int k = 0; k < 3 + i; k++) // Wraps around in the last cycle
+            data.past_trajectory.add(Eigen::Vector2d(k, -k));
+
+        data.reference_path = StraightPath(i < 2 ? 0. : 1., i < 2 ? 20 : 25);
+        data.left_bound = StraightPath(i < 2 ? 2. : 3., 10);
+        data.right_bound = StraightPath(i < 2 ? -2. : -1., 10);
+        cycle.reference_path_changed = i != 1;
+
+        data.goal = Eigen::Vector2d(10., 1. + i);
+        data.goal_received = i > 0;
+        data.intrusion = 0.05 * i;
+
+        // One analytic prediction (only its model is logged) and one stored step by step
+        data.dynamic_obstacles.emplace_back(0, Eigen::Vector2d(3., 1.), 0.5, 0.4);
+        ConstantVelocityModel model;
+        model.position = Eigen::Vector2d(3., 1. + i);
+        model.velocity = Eigen::Vector2d(-0.5, 0.25);
+        model.dt = 0.2;
+        model.steps = 30;
+        model.noise = 0.1;
+        data.dynamic_obstacles.back().prediction.setConstantVelocity(model, PredictionType::GAUSSIAN);
+
+        data.dynamic_obstacles.emplace_back(1, Eigen::Vector2d(6., -1.), -0.3, 0.6, ObstacleType::STATIC);
+        data.dynamic_obstacles.back().prediction = ModesPrediction(6. + i);
+
+        if (i == 0) // Fewer obstacles in the later cycles
+            data.dynamic_obstacles.emplace_back(-1, Eigen::Vector2d(100., 100.), 0., 0.1);
+
+        cycle.output = PlannerOutput(0.2, 5);
+        cycle.output.success = i != 1;
+        for (int k = 0; k < (cycle.output.success ? 5 : 0); k++)
+            cycle.output.trajectory.add(Eigen::Vector2d(0.2 * k + i, 0.1 * k));
+        cycle.planning_time = 0.01 + 0.001 * i;
+    }
+    return cycles;
+}
+
+static void ExpectEqual(const ReferencePath &result, const ReferencePath &expected)
+{
+    EXPECT_EQ(result.x, expected.x);
+    EXPECT_EQ(result.y, expected.y);
+    EXPECT_EQ(result.psi, expected.psi);
+    EXPECT_EQ(result.v, expected.v);
+    EXPECT_EQ(result.s, expected.s);
+}
+
+static void ExpectEqual(const Prediction &result, const Prediction &expected)
+{
+    EXPECT_EQ(result.type, expected.type);
+    EXPECT_EQ(result.analytic, expected.analytic);
+    if (expected.analytic)
+    {
+        EXPECT_EQ(result.constant_velocity.position, expected.constant_velocity.position);
+        EXPECT_EQ(result.constant_velocity.velocity, expected.constant_velocity.velocity);
+        EXPECT_EQ(result.constant_velocity.dt, expected.constant_velocity.dt);
+        EXPECT_EQ(result.constant_velocity.steps, expected.constant_velocity.steps);
+        EXPECT_EQ(result.constant_velocity.noise, expected.constant_velocity.noise);
+        return;
+    }
+
+    ASSERT_EQ(result.modes.size(), expected.modes.size());
+    for (size_t m = 0; m < expected.modes.size(); m++)
+    {
+        ASSERT_EQ(result.modes[m].size(), expected.modes[m].size());
+        for (size_t k = 0; k < expected.modes[m].size(); k++)
+        {
+            EXPECT_EQ(result.modes[m][k].position, expected.modes[m][k].position);
+            EXPECT_EQ(result.modes[m][k].angle, expected.modes[m][k].angle);
+            EXPECT_EQ(result.modes[m][k].major_radius, expected.modes[m][k].major_radius);
+            EXPECT_EQ(result.modes[m][k].minor_radius, expected.modes[m][k].minor_radius);
+        }
+    }
+    EXPECT_EQ(result.probabilities, expected.probabilities);
+}
+
+static void ExpectEqual(const RealTimeData &result, const RealTimeData &expected)
+{
+    ASSERT_EQ(result.robot_area.size(), expected.robot_area.size());
+    for (size_t i = 0; i < expected.robot_area.size(); i++)
+    {
+        EXPECT_EQ(result.robot_area[i].offset, expected.robot_area[i].offset);
+        EXPECT_EQ(result.robot_area[i].radius, expected.robot_area[i].radius);
+    }
+
+    EXPECT_EQ(result.past_trajectory.capacity(), expected.past_trajectory.capacity());
+    EXPECT_EQ(result.past_trajectory.getPositions(), expected.past_trajectory.getPositions());
+
+    ExpectEqual(result.reference_path, expected.reference_path);
+    ExpectEqual(result.left_bound, expected.left_bound);
+    ExpectEqual(result.right_bound, expected.right_bound);
+
+    EXPECT_EQ(result.goal, expected.goal);
+    EXPECT_EQ(result.goal_received, expected.goal_received);
+    EXPECT_EQ(result.intrusion, expected.intrusion);
+
+    ASSERT_EQ(result.dynamic_obstacles.size(), expected.dynamic_obstacles.size());
+    for (size_t i = 0; i < expected.dynamic_obstacles.size(); i++)
+    {
+        const DynamicObstacle &obstacle = result.dynamic_obstacles[i];
+        const DynamicObstacle &expected_obstacle = expected.dynamic_obstacles[i];
+        EXPECT_EQ(obstacle.index, expected_obstacle.index);
+        EXPECT_EQ(obstacle.position, expected_obstacle.position);
+        EXPECT_EQ(obstacle.angle, expected_obstacle.angle);
+        EXPECT_EQ(obstacle.radius, expected_obstacle.radius);
+        EXPECT_EQ(obstacle.type, expected_obstacle.type);
+        ExpectEqual(obstacle.prediction, expected_obstacle.prediction);
+    }
+}
+
+TEST(InputLogTest, RoundTrip)
+{
+    std::string file = testing::TempDir() + "/round_trip.mpclog";
+
+    State state;
+    std::vector<LoggedCycle> cycles = TestCycles((int)state.getValues().size());
+    {
+        InputLogWriter writer;
+        ASSERT_TRUE(writer.open(file));
+        for (auto &cycle : cycles)
+        {
+            state.setValues(cycle.state);
+            writer.recordInputs(cycle.time, state, cycle.data);
+            writer.recordOutput(cycle.output, cycle.planning_time);
+        }
+        writer.close();
+    }
+
+    // Read into the same data each cycle, as in the replay: the reference path is kept when it did not change
+    InputLogReader reader;
+    ASSERT_TRUE(reader.open(file));
+
+    InputLogCycle logged;
+    State read_state;
+    RealTimeData read_data;
+    for (size_t i = 0; i < cycles.size(); i++)
+    {
+        SCOPED_TRACE("cycle " + std::to_string(i));
+        ASSERT_TRUE(reader.read(logged, read_state, read_data));
+
+        EXPECT_EQ(logged.time, cycles[i].time);
+        EXPECT_EQ(logged.reference_path_changed, cycles[i].reference_path_changed);
+        EXPECT_EQ(read_state.getValues(), cycles[i].state);
+        ExpectEqual(read_data, cycles[i].data);
+
+        EXPECT_EQ(logged.success, cycles[i].output.success);
+        EXPECT_EQ(logged.planning_time, cycles[i].planning_time);
+        EXPECT_EQ(logged.trajectory, cycles[i].output.trajectory.positions);
+    }
+    EXPECT_FALSE(reader.read(logged, read_state, read_data));
+
+    std::remove(file.c_str());
+}
+
+TEST(InputLogTest, RejectsOtherFiles)
+{
+    std::string file = testing::TempDir() + "/not_a_log.mpclog";
+    {
+        std::FILE *stream = std::fopen(file.c_str(), "w");
+        ASSERT_NE(stream, nullptr);
+        std::fputs("MPCREC01", stream);
+        std::fclose(stream);
+    }
+
+    InputLogReader reader;
+    EXPECT_FALSE(reader.open(file));
+
+    std::remove(file.c_str());
+}
@@ -0,0 +1,126 @@
+/** Checks that a planning cycle (Planner::solveMPC) does not allocate on the heap once the planner is warmed up */
+#include <gtest/gtest.h>
+
+#include <mpc_planner/planner.h>
+#include <mpc_planner/data_preparation.h>
+#include <mpc_planner_solver/state.h>
+#include <mpc_planner_types/realtime_data.h>
+#include <mpc_planner_util/parameters.h>
+
+#include <ros_tools/clock.h>
+
+#include "allocation_counter.h"
+
+#include <cmath>
+#include <memory>
+#include <string>
+
+using namespace MPCPlanner;
+
+/**
+ * @brief A straight road along the x-axis with obstacles crossing it, delivered to the planner as the simulator does. The
+ * obstacles far beside the road are culled by the guidance planner
+ */
+class PlannerAllocationTest : public testing::Test
+{
+protected:
+    static constexpr int NUM_OBSTACLES = 6;
+    static constexpr int NUM_FAR_OBSTACLES = 3;
+
+    void SetUp() override
+    {
+        // Relative to the working directory (the repository root)
+        Configuration::getInstance().initialize("mpc_planner_jackalsimulator/config/settings.yaml");
+        dt_ = 1. / CONFIG["control_frequency"].as<double>();
+
+        clock_ = std::make_shared<RosTools::VirtualClock>();
+        planner_ = std::make_unique<Planner>(clock_);
+
+        data_.robot_area = defineRobotArea(CONFIG["robot"]["length"].as<double>(),
+                                           CONFIG["robot"]["width"].as<double>(),
+                                           CONFIG["n_discs"].as<int>());
+        data_.past_trajectory = FixedSizeTrajectory(200);
+
+        for (int i = 0; i < 200; i++)
+        {
+            data_.reference_path.x.push_back(0.5 * i);
+            data_.reference_path.y.push_back(0.);
+            data_.reference_path.psi.push_back(0.);
+            data_.reference_path.v.push_back(1.);
+            data_.reference_path.s.push_back(0.5 * i);
+        }
+        data_.goal = Eigen::Vector2d(99.5, 0.);
+        data_.goal_received = true;
+        planner_->onDataReceived(data_, "reference_path");
+
+        state_.set("x", 0.);
+        state_.set("y", 0.);
+        state_.set("psi", 0.);
+        state_.set("v", 1.);
+        state_.set("spline", 0.);
+    }
+
+    /** @brief The inputs of one control cycle: new obstacle predictions as received by the planner */
+    void receiveObstacles(int i)
+    {
+        const double time = i * dt_;
+        const int N = CONFIG["N"].as<int>();
+        const double integrator_step = CONFIG["integrator_step"].as<double>();
+
+        data_.dynamic_obstacles.clear(); // Keeps the storage
+        for (int o = 0; o < NUM_OBSTACLES; o++)
+        {
+            Eigen::Vector2d position(5. + 4. * o, 3. * std::sin(0.5 * time + o));
+            Eigen::Vector2d velocity(0., 1.5 * std::cos(0.5 * time + o));
+            data_.dynamic_obstacles.emplace_back(o, position, 0., 0.4);
+            setConstantVelocityPrediction(data_.dynamic_obstacles.back().prediction, position, velocity, integrator_step, N);
+        }
+        for (int o = 0; o < NUM_FAR_OBSTACLES; o++)
+        {
+            Eigen::Vector2d position(10. * o + 0.5 * time, o % 2 == 0 ? 30. : -30.);
+            data_.dynamic_obstacles.emplace_back(NUM_OBSTACLES + o, position, 0., 0.4);
+            setConstantVelocityPrediction(data_.dynamic_obstacles.back().prediction, position, Eigen::Vector2d(0.5, 0.), integrator_step, N);
+        }
+        ensureObstacleSize(data_.dynamic_obstacles, state_);
+        planner_->onDataReceived(data_, "dynamic obstacles");
+    }
+
+    /** @brief Plan and follow the reference at constant speed */
+    void plan(int i)
+    {
+        const double time = i * dt_;
+        clock_->setTime(time);
+        data_.planning_start_time = clock_->now();
+        const PlannerOutput &output = planner_->solveMPC(state_, data_);
+        successes_ += output.success ? 1 : 0;
+
+        state_.set("x", state_.get("x") + state_.get("v") * dt_);
+        state_.set("spline", state_.get("x"));
+        data_.past_trajectory.add(state_.getPos());
+    }
+
+    double dt_;
+    std::shared_ptr<RosTools::VirtualClock> clock_;
+    std::unique_ptr<Planner> planner_;
+
+    State state_;
+    RealTimeData data_;
+    int successes_{0};
+};
+
+TEST_F(PlannerAllocationTest, SolveMPCDoesNotAllocate)
+{
+    // All threads are counted, also the OpenMP workers of the guidance planner and the parallel solvers. Only the
+    // planning cycles are measured, not the preparation of their inputs
+    std::string report;
+    int allocations = CountAllocations([&](int i)
+                                       {
+        {
+            UntrackedScope untracked;
+            receiveObstacles(i);
+        }
+        plan(i); },
+                                       20, 10, report);
+    EXPECT_EQ(allocations, 0) << report;
+    EXPECT_GT(successes_, 0);
+}
@@ -154,7 +154,7 @@ void JackalPlanner::loop(const ros::TimerEvent &event)
 {
     (void)event;
 
-    _data.planning_start_time = std::chrono::system_clock::now();
+    _data.planning_start_time = _planner->getClock()->now();
 
     LOG_DEBUG("============= Loop =============");
 
@@ -4,6 +4,7 @@
 #include <mpc_planner_modules/controller_module.h>
 
 #include <ros_tools/spline.h>
+#include <ros_tools/spline_window.h>
 
 namespace MPCPlanner
 {
@@ -26,6 +27,7 @@ namespace MPCPlanner
     void reset() override;
 
   protected:
+    RosTools::Spline2DWindow _path_window; // Only the part of the reference path around the robot is fitted
     std::shared_ptr<RosTools::Spline2D> _spline{nullptr};
     std::unique_ptr<RosTools::Spline2D> _bound_left{nullptr}, _bound_right{nullptr};
 
@@ -34,6 +36,12 @@ namespace MPCPlanner
 
     bool _add_road_constraints{false}, _two_way_road{false}, _dynamic_velocity_reference{false};
 
+    // Buffers for evaluating the path along the horizon
+    std::vector<double> _horizon_s;
+    std::vector<Eigen::Vector2d> _horizon_points, _horizon_velocities;
+
+    void onPathWindowMoved(const RealTimeData &data, ModuleData &module_data);
+
     void constructRoadConstraints(const RealTimeData &data, ModuleData &module_data);
     void constructRoadConstraintsFromCenterline(const RealTimeData &data, ModuleData &module_data);
     void constructRoadConstraintsFromBounds(const RealTimeData &data, ModuleData &module_data);
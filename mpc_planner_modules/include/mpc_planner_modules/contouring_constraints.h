@@ -8,6 +8,11 @@ namespace tk
   class spline;
 }
 
+namespace RosTools
+{
+  class Spline2D;
+}
+
 namespace MPCPlanner
 {
   class ContouringConstraints : public ControllerModule
@@ -28,7 +33,11 @@ namespace MPCPlanner
   private:
     int _num_segments;
 
+    /** @brief Fit the road widths between reference path points first and last */
+    void fitWidths(const RealTimeData &data, int first, int last);
+
     std::shared_ptr<tk::spline> _width_left{nullptr}, _width_right{nullptr};
+    std::shared_ptr<RosTools::Spline2D> _window_path{nullptr}; // The path window that the widths were fitted over
   };
 }
 #endif // __ELLIPSOID_CONSTRAINTS_H_
@@ -15,6 +15,7 @@
 namespace RosTools
 {
     class DataSaver;
+    class DataRecorder;
 }
 
 namespace MPCPlanner
@@ -119,6 +120,12 @@ namespace MPCPlanner
         /** @brief Export runtime data */
         virtual void saveData(RosTools::DataSaver &data_saver){(void)data_saver;};
 
+        /** @brief Register the columns that this module records (non-ROS), once */
+        virtual void addColumns(RosTools::DataRecorder &recorder){(void)recorder;};
+
+        /** @brief Record runtime data into the registered columns (non-ROS) */
+        virtual void saveData(RosTools::DataRecorder &recorder){(void)recorder;};
+
         /**
          * @brief Assign a name for this controller
          *
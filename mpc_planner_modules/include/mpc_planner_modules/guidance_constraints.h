@@ -21,6 +21,10 @@
 
 #include <mpc_planner_types/data_types.h>
 
+#include <guidance_planner/types/types.h>
+
+#include <ros_tools/data_recorder.h>
+
 #include <unordered_map>
 
 namespace GuidancePlanner
@@ -83,6 +87,8 @@ namespace MPCPlanner
 
         void reset() override;
         void saveData(RosTools::DataSaver &data_saver) override;
+        void addColumns(RosTools::DataRecorder &recorder) override;
+        void saveData(RosTools::DataRecorder &recorder) override;
         // void GetMethodName(std::string &name) override;
 
     private: // Private functions
@@ -124,7 +130,14 @@ namespace MPCPlanner
 
         RealTimeData empty_data_;
 
+        std::vector<GuidancePlanner::Halfspace> static_halfspaces_; // Reused between cycles
+        std::vector<GuidancePlanner::Obstacle> guidance_obstacles_; // Swapped with the storage of an earlier guidance snapshot
+
         int best_planner_index_ = -1;
+
+        // Recorded columns (non-ROS)
+        RosTools::ColumnHandle runtime_column_, lmpcc_objective_column_, original_planner_column_, best_planner_column_, gmpcc_objective_column_;
+        std::vector<RosTools::ColumnHandle> objective_columns_;
     };
 } // namespace MPCPlanner
 #endif // __GUIDANCE_CONSTRAINTS_H__
\ No newline at end of file
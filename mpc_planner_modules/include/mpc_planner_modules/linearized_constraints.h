@@ -3,7 +3,7 @@
 
 #include <mpc_planner_modules/controller_module.h>
 
-#include <ros_tools/projection.h>
+#include <ros_tools/linearization.h>
 
 namespace MPCPlanner
 {
@@ -23,7 +23,7 @@ namespace MPCPlanner
     void setTopologyConstraints();
 
   private:
-    std::vector<std::vector<Eigen::ArrayXd>> _a1, _a2, _b; // Constraints [disc x step]
+    std::vector<RosTools::HalfspaceBlock> _halfspaces; // Constraints [disc] x [step x constraint]
 
     double _dummy_a1{1.}, _dummy_a2{0.}, _dummy_b;
 
@@ -31,11 +31,10 @@ namespace MPCPlanner
     int _n_discs;
     int _n_other_halfspaces;
 
-    DouglasRachford dr_projection_;
+    RosTools::ObstacleBlock _obstacle_block; // Obstacle predictions [step x obstacle]
+    Eigen::ArrayXd _x, _y;                   // Disc positions [step]
 
     int _num_obstacles, _max_obstacles;
-
-    void projectToSafety(const std::vector<DynamicObstacle> &copied_obstacles, int k, Eigen::Vector2d &pos);
   };
 } // namespace MPCPlanner
 #endif // __LINEARIZED_CONSTRAINTS_H_
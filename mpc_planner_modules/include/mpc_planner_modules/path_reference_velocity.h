@@ -19,6 +19,11 @@ namespace tk
   class spline;
 }
 
+namespace RosTools
+{
+  class Spline2D;
+}
+
 namespace MPCPlanner
 {
   class PathReferenceVelocity : public ControllerModule
@@ -37,6 +42,7 @@ namespace MPCPlanner
 
   private:
     std::shared_ptr<tk::spline> _velocity_spline;
+    std::shared_ptr<RosTools::Spline2D> _window_path{nullptr}; // The path window that the velocity spline was fitted over
     int _n_segments;
   };
 }
@@ -24,22 +24,29 @@ namespace MPCPlanner
     _two_way_road = CONFIG["road"]["two_way"].as<bool>();
     _dynamic_velocity_reference = CONFIG["contouring"]["dynamic_velocity_reference"].as<bool>();
 
+    _path_window = RosTools::Spline2DWindow(CONFIG["contouring"]["window_look_behind"].as<double>(),
+                                            CONFIG["contouring"]["window_look_ahead"].as<double>(),
+                                            _n_segments);
+
     LOG_INITIALIZED();
   }
 
   void Contouring::update(State &state, const RealTimeData &data, ModuleData &module_data)
   {
-    (void)data;
     PROFILE_SCOPE("Contouring Update");
 
     LOG_DEBUG("contouring::update()");
 
-    // Update the closest point
+    // Update the closest point (the window moves along with the robot)
     double closest_s;
-    _spline->findClosestPoint(state.getPos(), _closest_segment, closest_s);
-
-    if (module_data.path.get() == nullptr && _spline.get() != nullptr)
+    if (_path_window.findClosestPoint(state.getPos(), _closest_segment, closest_s) || _spline == nullptr)
+      onPathWindowMoved(data, module_data);
+    else
+    {
+      // The module data is reset every cycle, the spline (and bounds) of the window are kept
       module_data.path = _spline;
+      module_data.path_start_index = _path_window.firstIndex();
+    }
 
     state.set("spline", closest_s); // We need to initialize the spline state here
 
@@ -49,6 +56,28 @@ namespace MPCPlanner
       constructRoadConstraints(data, module_data);
   }
 
+  void Contouring::onPathWindowMoved(const RealTimeData &data, ModuleData &module_data)
+  {
+    LOG_MARK("Reference path window moved to points [" << _path_window.firstIndex() << ", " << _path_window.lastIndex() << "]");
+
+    _spline = _path_window.getSpline();
+    module_data.path = _spline;
+    module_data.path_start_index = _path_window.firstIndex();
+
+    if (_add_road_constraints && (!data.left_bound.empty() && !data.right_bound.empty()))
+    {
+      // Fit the bounds over the same window
+      _bound_left = std::make_unique<RosTools::Spline2D>(
+          _path_window.getWindowValues(data.left_bound.x),
+          _path_window.getWindowValues(data.left_bound.y),
+          _spline->getTVector());
+      _bound_right = std::make_unique<RosTools::Spline2D>(
+          _path_window.getWindowValues(data.right_bound.x),
+          _path_window.getWindowValues(data.right_bound.y),
+          _spline->getTVector());
+    }
+  }
+
   void Contouring::setParameters(const RealTimeData &data, const ModuleData &module_data, int k)
   {
     (void)data;
@@ -131,27 +160,15 @@ namespace MPCPlanner
     {
       LOG_MARK("Received Reference Path");
 
-      // Construct a spline from the given points
-      if (data.reference_path.s.empty())
-        _spline = std::make_shared<RosTools::Spline2D>(data.reference_path.x, data.reference_path.y);
-      else
-        _spline = std::make_shared<RosTools::Spline2D>(data.reference_path.x, data.reference_path.y, data.reference_path.s);
+      // Store the path, the spline is fitted over a window around the robot in update()
+      _path_window.setPath(data.reference_path.x, data.reference_path.y, data.reference_path.s);
+      _spline.reset();
 
       if (_add_road_constraints && (!data.left_bound.empty() && !data.right_bound.empty()))
       {
-
-        // Add bounds
-        _bound_left = std::make_unique<RosTools::Spline2D>(
-            data.left_bound.x,
-            data.left_bound.y,
-            _spline->getTVector());
-        _bound_right = std::make_unique<RosTools::Spline2D>(
-            data.right_bound.x,
-            data.right_bound.y,
-            _spline->getTVector());
-
         // Update the road width
-        CONFIG["road"]["width"] = RosTools::distance(_bound_left->getPoint(0), _bound_right->getPoint(0));
+        CONFIG["road"]["width"] = RosTools::distance(Eigen::Vector2d(data.left_bound.x[0], data.left_bound.y[0]),
+                                                     Eigen::Vector2d(data.right_bound.x[0], data.right_bound.y[0]));
       }
 
       _closest_segment = -1;
@@ -170,11 +187,11 @@ namespace MPCPlanner
   {
     (void)data;
 
-    if (!_spline)
+    if (_path_window.empty())
       return false;
 
-    // Check if we reached the end of the spline
-    return RosTools::distance(state.getPos(), _spline->getPoint(_spline->parameterLength())) < 1.0;
+    // Check if we reached the end of the path
+    return RosTools::distance(state.getPos(), _path_window.getPathEnd()) < 1.0;
 
     // int index = _closest_segment + _n_segments - 1;
     // return index >= _spline->numSegments();
@@ -200,6 +217,12 @@ namespace MPCPlanner
         module_data.static_obstacles[k].reserve(2);
     }
 
+    // Evaluate the path along the whole horizon at once
+    _horizon_s.resize(_solver->N);
+    for (int k = 0; k < _solver->N; k++)
+      _horizon_s[k] = _solver->getEgoPrediction(k, "spline");
+    _spline->getPoints(_horizon_s, _horizon_points, &_horizon_velocities);
+
     // OLD VERSION:
     bool two_way = _two_way_road;
     double road_width_half = CONFIG["road"]["width"].as<double>() / 2.;
@@ -207,14 +230,12 @@ namespace MPCPlanner
     {
       module_data.static_obstacles[k].clear();
 
-      double cur_s = _solver->getEgoPrediction(k, "spline");
-
       // This is the final point and the normal vector of the path
-      Eigen::Vector2d path_point = _spline->getPoint(cur_s);
-      Eigen::Vector2d dpath = _spline->getOrthogonal(cur_s);
+      const Eigen::Vector2d &path_point = _horizon_points[k];
+      Eigen::Vector2d dpath = Eigen::Vector2d(_horizon_velocities[k](1), -_horizon_velocities[k](0)).normalized();
 
       // LEFT HALFSPACE
-      Eigen::Vector2d A = _spline->getOrthogonal(cur_s);
+      Eigen::Vector2d A = dpath;
       double width_times = two_way ? 3.0 : 1.0; // 3w for double lane
 
       // line is parallel to the spline
@@ -226,7 +247,7 @@ namespace MPCPlanner
       module_data.static_obstacles[k].emplace_back(A, b);
 
       // RIGHT HALFSPACE
-      A = _spline->getOrthogonal(cur_s); // Eigen::Vector2d(-path_dy, path_dx); // line is parallel to the spline
+      A = dpath; // Eigen::Vector2d(-path_dy, path_dx); // line is parallel to the spline
 
       Eigen::Vector2d boundary_right =
           path_point - dpath * (road_width_half - data.robot_area[0].radius);
@@ -246,19 +267,28 @@ namespace MPCPlanner
         module_data.static_obstacles[k].reserve(2);
     }
 
+    // Evaluate both bounds along the whole horizon at once
+    _horizon_s.resize(_solver->N);
+    for (int k = 0; k < _solver->N; k++)
+      _horizon_s[k] = _solver->getEgoPrediction(k, "spline");
+
+    _bound_left->getPoints(_horizon_s, _horizon_points, &_horizon_velocities);
     for (int k = 1; k < _solver->N; k++)
     {
       module_data.static_obstacles[k].clear();
-      double cur_s = _solver->getEgoPrediction(k, "spline");
 
       // Left
-      Eigen::Vector2d Al = _bound_left->getOrthogonal(cur_s);
-      double bl = Al.transpose() * (_bound_left->getPoint(cur_s) + Al * data.robot_area[0].radius);
+      Eigen::Vector2d Al = Eigen::Vector2d(_horizon_velocities[k](1), -_horizon_velocities[k](0)).normalized();
+      double bl = Al.transpose() * (_horizon_points[k] + Al * data.robot_area[0].radius);
       module_data.static_obstacles[k].emplace_back(-Al, -bl);
+    }
 
+    _bound_right->getPoints(_horizon_s, _horizon_points, &_horizon_velocities);
+    for (int k = 1; k < _solver->N; k++)
+    {
       // RIGHT HALFSPACE
-      Eigen::Vector2d Ar = _bound_right->getOrthogonal(cur_s);
-      double br = Ar.transpose() * (_bound_right->getPoint(cur_s) - Ar * data.robot_area[0].radius);
+      Eigen::Vector2d Ar = Eigen::Vector2d(_horizon_velocities[k](1), -_horizon_velocities[k](0)).normalized();
+      double br = Ar.transpose() * (_horizon_points[k] - Ar * data.robot_area[0].radius);
       module_data.static_obstacles[k].emplace_back(Ar, br);
     }
   }
@@ -490,6 +520,7 @@ namespace MPCPlanner
 
   void Contouring::reset()
   {
+    _path_window.clear();
     _spline.reset();
     _closest_segment = 0;
   }
@@ -22,7 +22,16 @@ namespace MPCPlanner
   void ContouringConstraints::update(State &state, const RealTimeData &data, ModuleData &module_data)
   {
     (void)state;
-    (void)data;
+
+    // Fit the widths over the same window of the reference path as the path spline (such that the segments match)
+    if (!data.left_bound.empty() && !data.right_bound.empty() && module_data.path != nullptr && module_data.path != _window_path)
+    {
+      _window_path = module_data.path;
+      fitWidths(data, module_data.path_start_index, module_data.path_start_index + module_data.path->numSegments());
+
+      module_data.path_width_left = _width_left;
+      module_data.path_width_right = _width_right;
+    }
 
     if (module_data.path_width_left == nullptr && _width_left != nullptr)
       module_data.path_width_left = _width_left;
@@ -37,36 +46,37 @@ namespace MPCPlanner
     {
       LOG_MARK("Reference Path Received");
 
-      if (!data.left_bound.empty() && !data.right_bound.empty())
-      {
-        LOG_MARK("Received Road Boundaries");
+      // The widths are fitted when the path window is available
+      _width_left.reset();
+      _width_right.reset();
+      _window_path.reset();
+    }
+  }
 
-        std::vector<double> widths_left, widths_right;
-        widths_right.resize(data.right_bound.x.size());
-        widths_left.resize(data.left_bound.x.size());
+  void ContouringConstraints::fitWidths(const RealTimeData &data, int first, int last)
+  {
+    LOG_MARK("Fitting Road Widths");
 
-        for (size_t i = 0; i < widths_left.size(); i++)
-        {
-          Eigen::Vector2d center(data.reference_path.x[i], data.reference_path.y[i]);
-          Eigen::Vector2d left(data.left_bound.x[i], data.left_bound.y[i]);
-          Eigen::Vector2d right(data.right_bound.x[i], data.right_bound.y[i]);
-          widths_left[i] = RosTools::distance(center, left);
-          widths_right[i] = RosTools::distance(center, right);
-        }
+    std::vector<double> widths_left, widths_right;
+    widths_right.resize(last - first + 1);
+    widths_left.resize(last - first + 1);
 
-        std::vector<double> s_vec;
+    for (int i = first; i <= last; i++)
+    {
+      Eigen::Vector2d center(data.reference_path.x[i], data.reference_path.y[i]);
+      Eigen::Vector2d left(data.left_bound.x[i], data.left_bound.y[i]);
+      Eigen::Vector2d right(data.right_bound.x[i], data.right_bound.y[i]);
+      widths_left[i - first] = RosTools::distance(center, left);
+      widths_right[i - first] = RosTools::distance(center, right);
+    }
 
-        _width_left = std::make_shared<tk::spline>();
-        _width_left->set_points(data.reference_path.s, widths_left);
-        // _width_left->set_points(spline.getTVector(), widths_left);
+    std::vector<double> s_vec(data.reference_path.s.begin() + first, data.reference_path.s.begin() + last + 1);
 
-        _width_right = std::make_shared<tk::spline>();
-        _width_right->set_points(data.reference_path.s, widths_right);
+    _width_left = std::make_shared<tk::spline>();
+    _width_left->set_points(s_vec, widths_left);
 
-        // _width_right->set_points(spline.getTVector(), widths_right);
-        // CONFIG["road"]["width"] = _width_right->operator()(0.) - _width_left->operator()(0.);
-      }
-    }
+    _width_right = std::make_shared<tk::spline>();
+    _width_right->set_points(s_vec, widths_right);
   }
 
   void ContouringConstraints::setParameters(const RealTimeData &data, const ModuleData &module_data, int k)
@@ -150,7 +160,7 @@ namespace MPCPlanner
 
     Eigen::Vector2d prev_right, prev_left;
 
-    for (double cur_s = 0.; cur_s < _width_right->m_x_.back(); cur_s += 0.5)
+    for (double cur_s = _width_right->m_x_.front(); cur_s < _width_right->m_x_.back(); cur_s += 0.5)
     {
       double right = _width_right->operator()(cur_s);
       double left = _width_left->operator()(cur_s);
@@ -158,7 +168,7 @@ namespace MPCPlanner
       Eigen::Vector2d path_point = module_data.path->getPoint(cur_s);
       Eigen::Vector2d dpath = module_data.path->getOrthogonal(cur_s);
 
-      if (cur_s > 0)
+      if (cur_s > _width_right->m_x_.front())
       {
         line.addLine(prev_left, path_point - dpath * left);
         line.addLine(prev_right, path_point + dpath * right);
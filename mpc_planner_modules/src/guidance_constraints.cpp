@@ -35,6 +35,7 @@ namespace MPCPlanner
         GuidancePlanner::Config::debug_visuals_ = CONFIG["debug_visuals"].as<bool>();
 
         global_guidance_->SetPlanningFrequency(CONFIG["control_frequency"].as<double>());
+        global_guidance_->SetClock(_solver->getClock());
 
         _use_tmpcpp = CONFIG["t-mpc"]["use_t-mpc++"].as<bool>();
         _enable_constraints = CONFIG["t-mpc"]["enable_constraints"].as<bool>();
@@ -76,12 +77,12 @@ namespace MPCPlanner
         // Convert static obstacles
         if (!module_data.static_obstacles.empty())
         {
-            std::vector<GuidancePlanner::Halfspace> halfspaces;
+            static_halfspaces_.clear();
             for (size_t i = 0; i < module_data.static_obstacles[0].size(); i++)
             {
-                halfspaces.emplace_back(module_data.static_obstacles[0][i].A, module_data.static_obstacles[0][i].b);
+                static_halfspaces_.emplace_back(module_data.static_obstacles[0][i].A, module_data.static_obstacles[0][i].b);
             }
-            global_guidance_->LoadStaticObstacles(halfspaces); // Load static obstacles represented by halfspaces
+            global_guidance_->LoadStaticObstacles(static_halfspaces_); // Load static obstacles represented by halfspaces
         }
 
         if (_use_tmpcpp && global_guidance_->GetConfig()->n_paths_ == 0) // No global guidance
@@ -110,8 +111,7 @@ namespace MPCPlanner
         mapGuidanceTrajectoriesToPlanners();
 
         // LOG_VALUE("Number of Guidance Trajectories", global_guidance_->NumberOfGuidanceTrajectories());
-        empty_data_ = data;
-        empty_data_.dynamic_obstacles.clear();
+        empty_data_.assignWithoutObstacles(data);
     }
 
     void GuidanceConstraints::setGoals(State &state, const ModuleData &module_data)
@@ -147,6 +147,16 @@ namespace MPCPlanner
 
         double long_best = s_long.back();
 
+        // Evaluate the path and its width at all longitudinal goals at once
+        std::vector<Eigen::Vector2d> line_points, path_velocities;
+        module_data.path->getPoints(s_long, line_points, &path_velocities);
+
+        std::vector<int> width_segments; // Both widths are fitted over the same points
+        std::vector<double> widths_left, widths_right;
+        module_data.path_width_left->find_segments(s_long, width_segments);
+        module_data.path_width_left->evaluate(s_long, width_segments, widths_left);
+        module_data.path_width_right->evaluate(s_long, width_segments, widths_right);
+
         std::vector<GuidancePlanner::Goal> goals;
         for (int i = 0; i < n_long; i++)
         {
@@ -156,13 +166,13 @@ namespace MPCPlanner
             double long_cost = std::abs(s - long_best);
 
             // Compute the normal vector to the reference path
-            Eigen::Vector2d line_point = module_data.path->getPoint(s);
-            Eigen::Vector2d normal = module_data.path->getOrthogonal(s);
-            double angle = module_data.path->getPathAngle(s);
+            const Eigen::Vector2d &line_point = line_points[i];
+            Eigen::Vector2d normal = Eigen::Vector2d(path_velocities[i](1), -path_velocities[i](0)).normalized();
+            double angle = std::atan2(path_velocities[i](1), path_velocities[i](0));
 
             // Place goals orthogonally to the path
-            std::vector<double> dist_lat = RosTools::linspace(-module_data.path_width_left->operator()(s) + robot_radius,
-                                                              module_data.path_width_right->operator()(s) - robot_radius,
+            std::vector<double> dist_lat = RosTools::linspace(-widths_left[i] + robot_radius,
+                                                              widths_right[i] - robot_radius,
                                                               n_lat);
             // Put the middle goal on the reference path
             dist_lat[middle_lat] = 0.0;
@@ -331,8 +341,8 @@ namespace MPCPlanner
             }
 
             // Set timeout (Planning time - used time - time necessary afterwards)
-            std::chrono::duration<double> used_time = std::chrono::system_clock::now() - data.planning_start_time;
-            planner.local_solver->_params.solver_timeout = _planning_time - used_time.count() - 0.006;
+            double used_time = _solver->getClock()->secondsSince(data.planning_start_time);
+            planner.local_solver->_params.solver_timeout = _planning_time - used_time - 0.006;
 
             // SOLVE OPTIMIZATION
             // if (enable_guidance_warmstart_)
@@ -535,20 +545,34 @@ namespace MPCPlanner
                 planner.safety_constraints->onDataReceived(data, std::forward<std::string>(data_name));
             }
 
-            std::vector<GuidancePlanner::Obstacle> obstacles;
+            // Converted once per cycle, the guidance planner then shares them as an immutable snapshot (no further copies).
+            // The conversion refills the storage of an earlier snapshot, such that it does not allocate in steady state
+            size_t num_obstacles = 0;
             for (auto &obstacle : data.dynamic_obstacles)
             {
+                if (obstacle.index < 0)
+                    continue; // Dummy obstacles (padding from ensureObstacleSize) never affect the guidance
+
+                if (num_obstacles == guidance_obstacles_.size())
+                    guidance_obstacles_.emplace_back(obstacle.index, std::vector<Eigen::Vector2d>(), 0.);
+
+                auto &guidance_obstacle = guidance_obstacles_[num_obstacles++];
+                guidance_obstacle.id_ = obstacle.index;
+                guidance_obstacle.radius_ = obstacle.radius + data.robot_area[0].radius;
+                guidance_obstacle.is_static_ = obstacle.type == ObstacleType::STATIC;
 
-                std::vector<Eigen::Vector2d> positions;
+                auto &positions = guidance_obstacle.positions_;
+                positions.clear();
                 positions.push_back(obstacle.position); /** @note Strange that we need k = 0 here */
 
                 for (size_t k = 0; k < obstacle.prediction.modes[0].size(); k++) // std::max(obstacle.prediction.modes[0].size(), (size_t)GuidancePlanner::Config::N); k++)
                 {
                     positions.push_back(obstacle.prediction.modes[0][k].position);
                 }
-                obstacles.emplace_back(obstacle.index, positions, obstacle.radius + data.robot_area[0].radius);
             }
-            global_guidance_->LoadObstacles(obstacles, {});
+            guidance_obstacles_.erase(guidance_obstacles_.begin() + num_obstacles, guidance_obstacles_.end());
+
+            global_guidance_->SwapObstacles(guidance_obstacles_, {});
         }
     }
 
@@ -595,6 +619,43 @@ namespace MPCPlanner
 
         global_guidance_->saveData(data_saver); // Save data from the guidance planner
     }
+
+    void GuidanceConstraints::addColumns(RosTools::DataRecorder &recorder)
+    {
+        runtime_column_ = recorder.addColumn("runtime_guidance");
+        for (size_t i = 0; i < planners_.size(); i++)
+            objective_columns_.push_back(recorder.addColumn("objective_" + std::to_string(i)));
+
+        lmpcc_objective_column_ = recorder.addColumn("lmpcc_objective");
+        original_planner_column_ = recorder.addColumn("original_planner_id");
+        best_planner_column_ = recorder.addColumn("best_planner_idx");
+        gmpcc_objective_column_ = recorder.addColumn("gmpcc_objective");
+
+        global_guidance_->addColumns(recorder);
+    }
+
+    void GuidanceConstraints::saveData(RosTools::DataRecorder &recorder)
+    {
+        recorder.append(runtime_column_, global_guidance_->GetLastRuntime());
+        for (size_t i = 0; i < planners_.size(); i++)
+        {
+            auto &planner = planners_[i];
+            double objective = planner.result.success ? planner.result.objective : -1.;
+            recorder.append(objective_columns_[i], objective);
+
+            if (planner.is_original_planner)
+            {
+                recorder.append(lmpcc_objective_column_, objective);
+                recorder.append(original_planner_column_, planner.id);
+            }
+        }
+
+        recorder.append(best_planner_column_, best_planner_index_);
+        double best_objective = best_planner_index_ != -1 ? planners_[best_planner_index_].local_solver->_info.pobj : -1.;
+        recorder.append(gmpcc_objective_column_, best_objective);
+
+        global_guidance_->saveData(recorder);
+    }
 } // namespace MPCPlanner
 
 namespace MPCPlanner
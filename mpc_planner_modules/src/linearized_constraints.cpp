@@ -20,21 +20,9 @@ namespace MPCPlanner
     _n_other_halfspaces = CONFIG["linearized_constraints"]["add_halfspaces"].as<int>();
     _max_obstacles = CONFIG["max_obstacles"].as<int>();
     int n_constraints = _max_obstacles + _n_other_halfspaces;
-    _a1.resize(CONFIG["n_discs"].as<int>());
-    _a2.resize(CONFIG["n_discs"].as<int>());
-    _b.resize(CONFIG["n_discs"].as<int>());
-    for (int d = 0; d < CONFIG["n_discs"].as<int>(); d++)
-    {
-      _a1[d].resize(CONFIG["N"].as<int>());
-      _a2[d].resize(CONFIG["N"].as<int>());
-      _b[d].resize(CONFIG["N"].as<int>());
-      for (int k = 0; k < CONFIG["N"].as<int>(); k++)
-      {
-        _a1[d][k] = Eigen::ArrayXd(n_constraints);
-        _a2[d][k] = Eigen::ArrayXd(n_constraints);
-        _b[d][k] = Eigen::ArrayXd(n_constraints);
-      }
-    }
+    _halfspaces.resize(CONFIG["n_discs"].as<int>());
+    for (auto &halfspaces : _halfspaces)
+      halfspaces.resize(CONFIG["N"].as<int>(), n_constraints);
 
     _num_obstacles = 0;
     LOG_INITIALIZED();
@@ -53,100 +41,73 @@ namespace MPCPlanner
 
     _dummy_b = state.get("x") + 100.;
 
-    // Thread safe
-    std::vector<DynamicObstacle> copied_obstacles = data.dynamic_obstacles;
-    _num_obstacles = copied_obstacles.size();
+    const double robot_radius = CONFIG["robot_radius"].as<double>();
+    const auto &obstacles = data.dynamic_obstacles;
+    _num_obstacles = obstacles.size();
 
-    // For all stages
-    for (int k = 1; k < _solver->N; k++)
+    // Copy the predictions into one block (stage k uses prediction k - 1, k = 0 is the initial state)
+    _obstacle_block.resize(_solver->N, _num_obstacles);
+    for (int obs_id = 0; obs_id < _num_obstacles; obs_id++)
     {
-      for (int d = 0; d < _n_discs; d++)
+      const auto &obstacle = obstacles[obs_id];
+      _obstacle_block.radius(obs_id) = _use_guidance ? 1e-3 : obstacle.radius;
+      _obstacle_block.x(0, obs_id) = obstacle.position(0);
+      _obstacle_block.y(0, obs_id) = obstacle.position(1);
+
+      for (int k = 1; k < _solver->N; k++)
+      {
+        const Eigen::Vector2d &obstacle_pos = obstacle.prediction.modes[0][k - 1].position;
+        _obstacle_block.x(k, obs_id) = obstacle_pos(0);
+        _obstacle_block.y(k, obs_id) = obstacle_pos(1);
+      }
+    }
+
+    _x.resize(_solver->N);
+    _y.resize(_solver->N);
+    for (int d = 0; d < _n_discs; d++)
+    {
+      // For all stages
+      for (int k = 0; k < _solver->N; k++)
       {
         Eigen::Vector2d pos(_solver->getEgoPrediction(k, "x"), _solver->getEgoPrediction(k, "y")); // k = 0 is initial state
 
         if (!_use_guidance) // Use discs and their positions
-        {
-          auto &disc = data.robot_area[d];
-
-          Eigen::Vector2d disc_pos = disc.getPosition(pos, _solver->getEgoPrediction(k, "psi"));
-          projectToSafety(copied_obstacles, k, disc_pos); // Ensure that the vehicle position is collision-free
-
-          /** @todo Set projected disc position */
-
-          pos = disc_pos;
-        }
-        else // Use the robot position
-        {
-          projectToSafety(copied_obstacles, k, pos); // Ensure that the vehicle position is collision-free
-          /** @todo Set projected disc position */
-        }
+          pos = data.robot_area[d].getPosition(pos, _solver->getEgoPrediction(k, "psi"));
+        // Otherwise use the robot position
 
-        // For all obstacles
-        for (size_t obs_id = 0; obs_id < copied_obstacles.size(); obs_id++)
-        {
-          const auto &copied_obstacle = copied_obstacles[obs_id];
-          const Eigen::Vector2d &obstacle_pos = copied_obstacle.prediction.modes[0][k - 1].position;
-
-          double diff_x = obstacle_pos(0) - pos(0);
-          double diff_y = obstacle_pos(1) - pos(1);
-
-          double dist = (obstacle_pos - pos).norm();
+        _x(k) = pos(0);
+        _y(k) = pos(1);
+      }
 
-          // Compute the components of A for this obstacle (normalized normal vector)
-          _a1[d][k](obs_id) = diff_x / dist;
-          _a2[d][k](obs_id) = diff_y / dist;
+      // Ensure that the vehicle positions are collision-free, then linearize all obstacles for all stages
+      /** @todo Set projected disc position */
+      RosTools::projectToSafety(_obstacle_block, robot_radius, 3, _x, _y);
+      RosTools::linearizeObstacles(_obstacle_block, robot_radius, _x, _y, _halfspaces[d]);
 
-          // Compute b (evaluate point on the collision circle)
-          double radius = _use_guidance ? 1e-3 : copied_obstacle.radius;
+      if (module_data.static_obstacles.empty())
+        continue;
 
-          _b[d][k](obs_id) = _a1[d][k](obs_id) * obstacle_pos(0) +
-                             _a2[d][k](obs_id) * obstacle_pos(1) -
-                             (radius + CONFIG["robot_radius"].as<double>());
-        }
-
-        if (!module_data.static_obstacles.empty() && (int)module_data.static_obstacles[k].size() < _n_other_halfspaces)
+      for (int k = 1; k < _solver->N; k++)
+      {
+        if ((int)module_data.static_obstacles[k].size() < _n_other_halfspaces)
         {
           LOG_WARN(_n_other_halfspaces << " halfspaces expected, but "
                                        << (int)module_data.static_obstacles[k].size() << " are present");
         }
 
-        if (!module_data.static_obstacles.empty())
+        int num_halfspaces = std::min((int)module_data.static_obstacles[k].size(), _n_other_halfspaces);
+        for (int h = 0; h < num_halfspaces; h++)
         {
-
-          int num_halfspaces = std::min((int)module_data.static_obstacles[k].size(), _n_other_halfspaces);
-          for (int h = 0; h < num_halfspaces; h++)
-          {
-            int obs_id = copied_obstacles.size() + h;
-            _a1[d][k](obs_id) = module_data.static_obstacles[k][h].A(0);
-            _a2[d][k](obs_id) = module_data.static_obstacles[k][h].A(1);
-            _b[d][k](obs_id) = module_data.static_obstacles[k][h].b;
-          }
+          int obs_id = _num_obstacles + h;
+          _halfspaces[d].a1(k, obs_id) = module_data.static_obstacles[k][h].A(0);
+          _halfspaces[d].a2(k, obs_id) = module_data.static_obstacles[k][h].A(1);
+          _halfspaces[d].b(k, obs_id) = module_data.static_obstacles[k][h].b;
         }
       }
     }
     LOG_MARK("LinearizedConstraints::update done");
   }
 
-  void LinearizedConstraints::projectToSafety(const std::vector<DynamicObstacle> &copied_obstacles, int k, Eigen::Vector2d &pos)
-  {
-    if (copied_obstacles.empty()) // There is no anchor
-      return;
-
-    // Project to a collision free position if necessary, considering all the obstacles
-    for (int iterate = 0; iterate < 3; iterate++) // At most 3 iterations
-    {
-      for (auto &obstacle : copied_obstacles)
-      {
-        double radius = _use_guidance ? 1e-3 : obstacle.radius;
-
-        dr_projection_.douglasRachfordProjection(pos, obstacle.prediction.modes[0][k - 1].position,
-                                                 copied_obstacles[0].prediction.modes[0][k - 1].position,
-                                                 radius + CONFIG["robot_radius"].as<double>(),
-                                                 pos);
-      }
-    }
-  }
-
   void LinearizedConstraints::setParameters(const RealTimeData &data, const ModuleData &module_data, int k)
   {
     (void)module_data;
@@ -172,9 +133,9 @@ namespace MPCPlanner
 
       for (size_t i = 0; i < data.dynamic_obstacles.size() + _n_other_halfspaces; i++)
       {
-        setSolverParameterLinConstraintA1(k, _solver->_params, _a1[d][k](i), constraint_counter);
-        setSolverParameterLinConstraintA2(k, _solver->_params, _a2[d][k](i), constraint_counter);
-        setSolverParameterLinConstraintB(k, _solver->_params, _b[d][k](i), constraint_counter);
+        setSolverParameterLinConstraintA1(k, _solver->_params, _halfspaces[d].a1(k, i), constraint_counter);
+        setSolverParameterLinConstraintA2(k, _solver->_params, _halfspaces[d].a2(k, i), constraint_counter);
+        setSolverParameterLinConstraintB(k, _solver->_params, _halfspaces[d].b(k, i), constraint_counter);
         constraint_counter++;
       }
 
@@ -227,7 +188,7 @@ namespace MPCPlanner
     {
       for (size_t i = 0; i < data.dynamic_obstacles.size(); i++)
       {
-        visualizeLinearConstraint(_a1[0][k](i), _a2[0][k](i), _b[0][k](i), k, _solver->N, _name,
+        visualizeLinearConstraint(_halfspaces[0].a1(k, i), _halfspaces[0].a2(k, i), _halfspaces[0].b(k, i), k, _solver->N, _name,
                                   k == _solver->N - 1 && i == data.dynamic_obstacles.size() - 1); // Publish at the end
       }
     }
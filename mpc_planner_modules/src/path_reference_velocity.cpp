@@ -19,7 +19,20 @@ namespace MPCPlanner
   void PathReferenceVelocity::update(State &state, const RealTimeData &data, ModuleData &module_data)
   {
     (void)state;
-    (void)data;
+
+    // Fit the velocity over the same window of the reference path as the path spline (such that the segments match)
+    if (data.reference_path.hasVelocity() && module_data.path != nullptr && module_data.path != _window_path)
+    {
+      _window_path = module_data.path;
+
+      int first = module_data.path_start_index;
+      int last = first + module_data.path->numSegments();
+
+      _velocity_spline = std::make_shared<tk::spline>();
+      _velocity_spline->set_points(std::vector<double>(data.reference_path.s.begin() + first, data.reference_path.s.begin() + last + 1),
+                                   std::vector<double>(data.reference_path.v.begin() + first, data.reference_path.v.begin() + last + 1));
+      module_data.path_velocity = _velocity_spline;
+    }
 
     if (module_data.path_velocity == nullptr && _velocity_spline != nullptr)
       module_data.path_velocity = _velocity_spline;
@@ -31,11 +44,9 @@ namespace MPCPlanner
     {
       LOG_MARK("Received Reference Path");
 
-      if (data.reference_path.hasVelocity())
-      {
-        _velocity_spline = std::make_shared<tk::spline>();
-        _velocity_spline->set_points(data.reference_path.s, data.reference_path.v);
-      }
+      // The velocity spline is fitted when the path window is available
+      _velocity_spline.reset();
+      _window_path.reset();
     }
   }
 
@@ -56,7 +67,7 @@ namespace MPCPlanner
     // Set the parameters for velocity tracking
     // setSolverParameterVelocity(k, _solver->_params, velocity_weight);
 
-    if (data.reference_path.hasVelocity()) // Use a spline-based velocity reference
+    if (data.reference_path.hasVelocity() && _velocity_spline != nullptr) // Use a spline-based velocity reference
     {
       LOG_MARK("Using spline-based reference velocity");
       for (int i = 0; i < _n_segments; i++)
@@ -97,8 +108,7 @@ namespace MPCPlanner
 
   void PathReferenceVelocity::visualize(const RealTimeData &data, const ModuleData &module_data)
   {
-    (void)module_data;
-    if (data.reference_path.empty() || data.reference_path.s.empty())
+    if (data.reference_path.empty() || data.reference_path.s.empty() || module_data.path == nullptr || _velocity_spline == nullptr)
       return;
 
     if (!CONFIG["debug_visuals"].as<bool>())
@@ -111,16 +121,16 @@ namespace MPCPlanner
     auto &line = publisher.getNewLine();
 
     line.setScale(0.25, 0.25, 0.1);
-    auto spline_xy = std::make_unique<RosTools::Spline2D>(data.reference_path.x, data.reference_path.y, data.reference_path.s);
+    const auto &spline_xy = module_data.path;
 
     Eigen::Vector2d prev;
     double prev_v = 0.;
-    for (double s = 0.; s < _velocity_spline->m_x_.back(); s += 1.0)
+    for (double s = _velocity_spline->m_x_.front(); s < _velocity_spline->m_x_.back(); s += 1.0)
     {
       Eigen::Vector2d cur = spline_xy->getPoint(s);
       double v = _velocity_spline->operator()(s);
 
-      if (s > 0.)
+      if (s > _velocity_spline->m_x_.front())
       {
         line.setColor(0, (v + prev_v) / (2. * 3. * 2.), 0.);
         line.addLine(prev, cur);
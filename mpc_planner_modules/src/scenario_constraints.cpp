@@ -68,8 +68,8 @@ namespace MPCPlanner
     for (auto &solver : _scenario_solvers)
     {
       // Set the planning timeout
-      std::chrono::duration<double> used_time = std::chrono::system_clock::now() - data.planning_start_time;
-      solver->solver->_params.solver_timeout = _planning_time - used_time.count() - 0.008;
+      double used_time = _solver->getClock()->secondsSince(data.planning_start_time);
+      solver->solver->_params.solver_timeout = _planning_time - used_time - 0.008;
 
       // Copy solver parameters and initial guess
       *solver->solver = *_solver; // Copy the main solver
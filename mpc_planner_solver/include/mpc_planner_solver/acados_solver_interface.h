@@ -15,8 +15,11 @@
 
 #include <mpc_planner_util/load_yaml.hpp>
 
+#include <ros_tools/clock.h>
 #include <ros_tools/logging.h>
 
+#include <memory>
+
 #define NX SOLVER_NX
 #define NZ SOLVER_NZ
 #define NU SOLVER_NU
@@ -158,6 +161,8 @@ namespace MPCPlanner
 
         int _exit_code_one_iter{-1};
 
+        std::shared_ptr<RosTools::Clock> _clock;
+
     public:
         int _solver_id;
 
@@ -183,6 +188,10 @@ namespace MPCPlanner
         /** @brief Copy data from another solver. Does not copy solver generic parameters like the horizon N*/
         Solver &operator=(const Solver &rhs);
 
+        /** @brief Clock of the planning deadline and the solver timeout (copied along with the solver data) */
+        void setClock(std::shared_ptr<RosTools::Clock> clock);
+        const std::shared_ptr<RosTools::Clock> &getClock() const { return _clock; }
+
         void reset();
 
         int solve();
@@ -8,6 +8,8 @@
 
 #include <mpc_planner_util/load_yaml.hpp>
 
+#include <ros_tools/clock.h>
+
 #include <memory>
 
 #include <Solver.h>
@@ -42,6 +44,8 @@ namespace MPCPlanner
 		char *_solver_memory;
 		Solver_mem *_solver_memory_handle;
 
+		std::shared_ptr<RosTools::Clock> _clock;
+
 	public:
 		int _solver_id;
 
@@ -67,6 +71,10 @@ namespace MPCPlanner
 		/** @brief Copy data from another solver. Does not copy solver generic parameters like the horizon N*/
 		Solver &operator=(const Solver &rhs);
 
+		/** @brief Clock of the planning deadline (copied along with the solver data) */
+		void setClock(std::shared_ptr<RosTools::Clock> clock);
+		const std::shared_ptr<RosTools::Clock> &getClock() const { return _clock; }
+
 		char *getSolverMemory() const;
 		void copySolverMemory(const Solver &other);
 
@@ -22,6 +22,10 @@ namespace MPCPlanner
         void set(std::string &&var_name, double value);
         void print() const;
 
+        /** @brief All state variables in solver order, e.g., to log and restore the state */
+        const std::vector<double> &getValues() const { return _state; }
+        void setValues(const std::vector<double> &values) { _state = values; }
+
     private:
         std::vector<double> _state;
         YAML::Node _config, _model_map;
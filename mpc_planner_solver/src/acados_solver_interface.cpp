@@ -9,6 +9,7 @@ namespace MPCPlanner
     Solver::Solver(int solver_id)
     {
         _solver_id = solver_id;
+        _clock = RosTools::Clock::getDefault();
 
         loadConfigYaml(SYSTEM_CONFIG_PATH(__FILE__, "solver_settings"), _config);
         loadConfigYaml(SYSTEM_CONFIG_PATH(__FILE__, "parameter_map"), _parameter_map);
@@ -67,6 +68,7 @@ namespace MPCPlanner
     Solver &Solver::operator=(const Solver &rhs)
     {
         _params = rhs._params;
+        _clock = rhs._clock;
         ocp_nlp_solver_reset_qp_memory(_nlp_solver, _nlp_in, _nlp_out);
 
         // _output = rhs._output;
@@ -76,6 +78,11 @@ namespace MPCPlanner
         return *this;
     }
 
+    void Solver::setClock(std::shared_ptr<RosTools::Clock> clock)
+    {
+        _clock = clock ? clock : RosTools::Clock::getDefault();
+    }
+
     void Solver::reset()
     {
         _params = AcadosParameters();
@@ -87,8 +94,8 @@ namespace MPCPlanner
     {
         int status = 1;
 
-        RosTools::Benchmarker iteration_timer("iteration");
-        RosTools::Timer timeout_timer(_params.solver_timeout);
+        RosTools::Timer iteration_timer; // Default clock: iterations take wall time, also in a replay
+        RosTools::Timer timeout_timer(_params.solver_timeout, _clock);
         timeout_timer.start();
 
         // _params.printParameters(_parameter_map);
@@ -105,7 +112,7 @@ namespace MPCPlanner
             if (status != ACADOS_SUCCESS && _info.qp_status != 0)
                 break;
 
-            iteration_time += iteration_timer.stop();
+            iteration_time += iteration_timer.currentDuration();
             double avg_iteration_time = iteration_time / ((double)(iteration + 1));
 
             // Stop iterating if we ran out of time
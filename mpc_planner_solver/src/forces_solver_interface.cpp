@@ -16,6 +16,7 @@ namespace MPCPlanner
 	Solver::Solver(int solver_id)
 	{
 		_solver_id = solver_id;
+		_clock = RosTools::Clock::getDefault();
 		_solver_memory = (char *)malloc(Solver_get_mem_size());
 		_solver_memory_handle = Solver_external_mem(_solver_memory, _solver_id, Solver_get_mem_size());
 		loadConfigYaml(SYSTEM_CONFIG_PATH(__FILE__, "solver_settings"), _config);
@@ -50,10 +51,16 @@ namespace MPCPlanner
 	Solver &Solver::operator=(const Solver &rhs)
 	{
 		_params = rhs._params;
+		_clock = rhs._clock;
 
 		return *this;
 	}
 
+	void Solver::setClock(std::shared_ptr<RosTools::Clock> clock)
+	{
+		_clock = clock ? clock : RosTools::Clock::getDefault();
+	}
+
 	char *Solver::getSolverMemory() const { return _solver_memory; }
 
 	void Solver::copySolverMemory(const Solver &other)
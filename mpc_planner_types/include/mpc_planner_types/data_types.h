@@ -55,6 +55,16 @@ namespace MPCPlanner
 
     typedef std::vector<PredictionStep> Mode;
 
+    /** @brief Constant velocity motion from which the prediction at each step follows in closed form */
+    struct ConstantVelocityModel
+    {
+        Eigen::Vector2d position; // At k = 0
+        Eigen::Vector2d velocity;
+        double dt{0.};
+        int steps{0};
+        double noise{0.}; // Radius growth per second, propagated uncertainty at step k is noise * dt * sqrt(k + 1)
+    };
+
     struct Prediction
     {
 
@@ -63,9 +73,28 @@ namespace MPCPlanner
         std::vector<Mode> modes;
         std::vector<double> probabilities;
 
+        // Analytic constant velocity prediction, only expanded into `modes` when requested
+        bool analytic{false};
+        bool expanded{false};
+        ConstantVelocityModel constant_velocity;
+
         Prediction();
         Prediction(PredictionType type);
 
+        /** @brief Make this an analytic prediction, keeping the storage of the modes for the next expansion */
+        void setConstantVelocity(const ConstantVelocityModel &model, PredictionType type);
+
+        /** @brief Fill modes[0] from the analytic model (reuses its capacity, no-op for non-analytic predictions) */
+        void expand();
+
+        /** @brief Number of predicted steps (without expanding) */
+        int numSteps() const;
+
+        /** @brief Position / uncertainty at step k of the first mode (without expanding), the last step is held beyond the end */
+        Eigen::Vector2d getPosition(int k) const;
+        double getMajorRadius(int k) const;
+        double getMinorRadius(int k) const;
+
         bool empty() const;
     };
 
@@ -134,17 +163,34 @@ namespace MPCPlanner
         bool success{false};
     };
 
+    /** @brief Bounded history of positions, stored in a ring buffer (adding a position is O(1)) */
     struct FixedSizeTrajectory
     {
     private:
-        int _size;
+        std::vector<Eigen::Vector2d> _positions; // Ring buffer of fixed capacity
+        int _start{0};                           // Index of the oldest position
+        int _count{0};
 
     public:
-        std::vector<Eigen::Vector2d> positions;
-
         FixedSizeTrajectory(int size = 50);
 
         void add(const Eigen::Vector2d &p);
+        void clear();
+
+        int size() const { return _count; }
+        bool empty() const { return _count == 0; }
+        int capacity() const { return (int)_positions.size(); }
+
+        /** @brief Position i, oldest first */
+        const Eigen::Vector2d &operator[](int i) const { return _positions[(_start + i) % capacity()]; }
+        const Eigen::Vector2d &back() const { return (*this)[_count - 1]; }
+
+        /** @brief The history as two contiguous blocks, oldest first: [first, first + first_size) then [second, second + second_size) */
+        void getBlocks(const Eigen::Vector2d *&first, int &first_size, const Eigen::Vector2d *&second, int &second_size) const;
+
+        /** @brief Linearized copy of the history, oldest first */
+        void getPositions(std::vector<Eigen::Vector2d> &positions_out) const;
+        std::vector<Eigen::Vector2d> getPositions() const;
     };
 }
 
@@ -28,7 +28,8 @@ namespace MPCPlanner
         std::shared_ptr<tk::spline> path_width_right{nullptr};
         std::shared_ptr<tk::spline> path_velocity{nullptr};
 
-        int current_path_segment{-1};
+        int current_path_segment{-1}; // Segment of path (not of the full reference path)
+        int path_start_index{0};      // path covers a window of the reference path, starting at this point
 
         void reset();
     };
@@ -3,7 +3,7 @@
 
 #include <mpc_planner_types/data_types.h>
 
-#include <chrono>
+#include <ros_tools/clock.h>
 
 #ifdef MPC_PLANNER_ROS
 namespace costmap_2d
@@ -15,14 +15,13 @@ namespace costmap_2d
 namespace MPCPlanner
 {
 
-    struct RealTimeData
+    /** @brief All real-time data except for the dynamic obstacles (copied as a whole by RealTimeData::assignWithoutObstacles) */
+    struct RealTimeDataWithoutObstacles
     {
 
         std::vector<Disc> robot_area;
         FixedSizeTrajectory past_trajectory;
 
-        std::vector<DynamicObstacle> dynamic_obstacles;
-
 #ifdef MPC_PLANNER_ROS
         costmap_2d::Costmap2D *costmap{nullptr}; // Costmap for static obstacles (ROS version)
 #else
@@ -38,10 +37,23 @@ namespace MPCPlanner
         // Feedback data
         double intrusion;
 
-        std::chrono::system_clock::time_point planning_start_time;
+        RosTools::Clock::TimePoint planning_start_time; // Set with the clock of the planner (Planner::getClock())
+    };
+
+    struct RealTimeData : public RealTimeDataWithoutObstacles
+    {
+
+        std::vector<DynamicObstacle> dynamic_obstacles;
 
         RealTimeData() = default;
 
+        /** @brief Copy all data except for the dynamic obstacles (reuses the storage of this object) */
+        void assignWithoutObstacles(const RealTimeData &other)
+        {
+            static_cast<RealTimeDataWithoutObstacles &>(*this) = other;
+            dynamic_obstacles.clear();
+        }
+
         void reset()
         {
             // Copy data that should remain at reset
@@ -1,5 +1,8 @@
 #include "mpc_planner_types/data_types.h"
 
+#include <algorithm>
+#include <cmath>
+
 /** Basic high-level data types for motion planning */
 
 namespace MPCPlanner
@@ -45,9 +48,69 @@ namespace MPCPlanner
         }
     }
 
+    void Prediction::setConstantVelocity(const ConstantVelocityModel &model, PredictionType type)
+    {
+        this->type = type;
+        constant_velocity = model;
+        analytic = true;
+        expanded = false;
+
+        modes.resize(1);
+        modes[0].clear();
+        probabilities.assign(1, 1.);
+    }
+
+    void Prediction::expand()
+    {
+        if (!analytic || expanded)
+            return;
+
+        Mode &mode = modes[0];
+        mode.reserve(constant_velocity.steps);
+        for (int k = 0; k < constant_velocity.steps; k++)
+            mode.emplace_back(getPosition(k), 0., getMajorRadius(k), getMinorRadius(k));
+
+        expanded = true;
+    }
+
+    int Prediction::numSteps() const
+    {
+        if (analytic)
+            return constant_velocity.steps;
+
+        return modes.empty() ? 0 : (int)modes[0].size();
+    }
+
+    Eigen::Vector2d Prediction::getPosition(int k) const
+    {
+        k = std::min(k, numSteps() - 1);
+        if (analytic)
+            return constant_velocity.position + constant_velocity.velocity * (constant_velocity.dt * k);
+
+        return modes[0][k].position;
+    }
+
+    double Prediction::getMajorRadius(int k) const
+    {
+        k = std::min(k, numSteps() - 1);
+        if (analytic)
+            return constant_velocity.noise * constant_velocity.dt * std::sqrt((double)(k + 1));
+
+        return modes[0][k].major_radius;
+    }
+
+    double Prediction::getMinorRadius(int k) const
+    {
+        k = std::min(k, numSteps() - 1);
+        if (analytic)
+            return constant_velocity.noise * constant_velocity.dt * std::sqrt((double)(k + 1));
+
+        return modes[0][k].minor_radius;
+    }
+
     bool Prediction::empty() const
     {
-        return modes.empty() || (modes.size() > 0 && modes[0].empty());
+        return numSteps() == 0;
     }
 
     DynamicObstacle::DynamicObstacle(int _index, const Eigen::Vector2d &_position, double _angle, double _radius, ObstacleType _type)
@@ -95,35 +158,59 @@ namespace MPCPlanner
     }
 
     FixedSizeTrajectory::FixedSizeTrajectory(int size)
-        : _size(size)
+        : _positions(std::max(size, 1))
     {
-        positions.reserve(size);
     }
 
     void FixedSizeTrajectory::add(const Eigen::Vector2d &p)
     {
-        if (positions.empty())
-        {
-            positions.push_back(p);
-            return;
-        }
-
         // On jump, erase the trajectory
-        if (std::sqrt((p - positions.back()).transpose() * (p - positions.back())) > 5.0)
-        {
-            positions.clear();
-            positions.push_back(p);
-            return;
-        }
+        if (!empty() && (p - back()).norm() > 5.0)
+            clear();
 
-        if ((int)positions.size() < _size)
+        if (_count < capacity())
         {
-            positions.push_back(p);
+            _positions[(_start + _count) % capacity()] = p;
+            _count++;
         }
         else
         {
-            positions.erase(positions.begin());
-            positions.push_back(p);
+            // Overwrite the oldest position
+            _positions[_start] = p;
+            _start = (_start + 1) % capacity();
         }
     }
+
+    void FixedSizeTrajectory::clear()
+    {
+        _start = 0;
+        _count = 0;
+    }
+
+    void FixedSizeTrajectory::getBlocks(const Eigen::Vector2d *&first, int &first_size,
+                                        const Eigen::Vector2d *&second, int &second_size) const
+    {
+        first = _positions.data() + _start;
+        first_size = std::min(_count, capacity() - _start);
+
+        second = _positions.data();
+        second_size = _count - first_size;
+    }
+
+    void FixedSizeTrajectory::getPositions(std::vector<Eigen::Vector2d> &positions_out) const
+    {
+        const Eigen::Vector2d *first, *second;
+        int first_size, second_size;
+        getBlocks(first, first_size, second, second_size);
+
+        positions_out.assign(first, first + first_size);
+        positions_out.insert(positions_out.end(), second, second + second_size);
+    }
+
+    std::vector<Eigen::Vector2d> FixedSizeTrajectory::getPositions() const
+    {
+        std::vector<Eigen::Vector2d> positions;
+        getPositions(positions);
+        return positions;
+    }
 }
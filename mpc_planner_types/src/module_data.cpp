@@ -4,10 +4,12 @@ namespace MPCPlanner
 {
         void ModuleData::reset()
         {
+                static_obstacles.clear();
                 path.reset();
                 path_width_left.reset();
                 path_width_right.reset();
                 path_velocity.reset();
                 current_path_segment = -1;
+                path_start_index = 0;
         }
 }
\ No newline at end of file
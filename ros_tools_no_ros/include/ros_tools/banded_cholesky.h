@@ -0,0 +1,48 @@
+#ifndef ros_tools_BANDED_CHOLESKY_H
+#define ros_tools_BANDED_CHOLESKY_H
+
+#include <Eigen/Dense>
+
+namespace RosTools
+{
+    /**
+     * @brief Symmetric positive definite banded linear system A x = b, solved with a banded Cholesky factorization
+     *
+     * Only the lower band of A is stored (column j holds A(j, j), A(j + 1, j), ..., A(j + bandwidth, j)), such that factorizing
+     * and solving cost O(n * bandwidth^2) instead of O(n^3). Storage is only reallocated when the system grows, so that one
+     * instance can be reused as a workspace for many systems of similar size.
+     */
+    class BandedCholesky
+    {
+    public:
+        BandedCholesky(int size = 0, int bandwidth = 0);
+
+        /** @brief Resize to a size x size system with the given (half) bandwidth and set all entries to zero */
+        void Reset(int size, int bandwidth);
+
+        int size() const { return n_; }
+        int bandwidth() const { return p_; }
+
+        /** @brief Access entry A(row, col) of the lower band (row >= col, row - col <= bandwidth) */
+        double &operator()(int row, int col) { return band_(row - col, col); }
+        double operator()(int row, int col) const { return band_(row - col, col); }
+
+        /** @brief Factorize A = L L^T in place. Returns false if A is not positive definite */
+        bool Factorize();
+
+        /** @brief Solve A x = b using the factorization (call Factorize() first). x and b may be the same vector */
+        void Solve(const Eigen::VectorXd &b, Eigen::VectorXd &x) const;
+
+        /** @brief The full symmetric matrix (before factorization), for debugging and testing */
+        Eigen::MatrixXd ToDense() const;
+
+    private:
+        int n_{0};
+        int p_{0};
+        bool factorized_{false};
+
+        Eigen::MatrixXd band_; // (bandwidth + 1) x n, band_(d, j) = A(j + d, j)
+    };
+}
+
+#endif // ros_tools_BANDED_CHOLESKY_H
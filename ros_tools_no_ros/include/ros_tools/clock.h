@@ -0,0 +1,59 @@
+#ifndef ros_tools_CLOCK_H
+#define ros_tools_CLOCK_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+
+namespace RosTools
+{
+    /**
+     * @brief Source of time for planning deadlines, solver timeouts, timers and benchmarkers
+     *
+     * Time points share the representation of std::chrono::steady_clock, such that clocks can be swapped without changing
+     * the types that store time points.
+     */
+    class Clock
+    {
+    public:
+        typedef std::chrono::steady_clock::time_point TimePoint;
+        typedef std::chrono::steady_clock::duration Duration;
+
+        virtual ~Clock() = default;
+
+        virtual TimePoint now() const = 0;
+
+        /** @brief Seconds elapsed since the given time point */
+        double secondsSince(const TimePoint &start) const { return std::chrono::duration<double>(now() - start).count(); }
+
+        /** @brief The clock used by everything that is not given a clock (a SteadyClock unless replaced) */
+        static const std::shared_ptr<Clock> &getDefault();
+
+        /** @brief Replace the default clock (nullptr restores the SteadyClock), before anything is timed */
+        static void setDefault(std::shared_ptr<Clock> clock);
+    };
+
+    /** @brief Monotonic wall time (not affected by changes of the system time) */
+    class SteadyClock : public Clock
+    {
+    public:
+        TimePoint now() const override { return std::chrono::steady_clock::now(); }
+    };
+
+    /** @brief Time that only moves when it is advanced, for deterministic simulation and tests */
+    class VirtualClock : public Clock
+    {
+    public:
+        TimePoint now() const override { return TimePoint(std::chrono::nanoseconds(_nanoseconds.load(std::memory_order_acquire))); }
+
+        /** @brief Set the time (s) since the epoch of the clock */
+        void setTime(double seconds);
+        void advance(double seconds);
+
+    private:
+        std::atomic<int64_t> _nanoseconds{0};
+    };
+}
+
+#endif // ros_tools_CLOCK_H
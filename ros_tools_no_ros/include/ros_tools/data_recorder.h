@@ -0,0 +1,117 @@
+//
+// Columnar binary recorder for per-cycle data, cheap enough to keep enabled while planning
+//
+// Usage: register the columns once with addColumn() and keep the handles, then append() values each cycle.
+// Appended values are kept in preallocated per-column buffers. flush() hands them to a background thread that writes
+// them to the file, without blocking the caller. close() writes the remaining data.
+
+// Example:
+/*
+DataRecorder recorder;
+ColumnHandle runtime = recorder.addColumn("runtime");
+ColumnHandle pose = recorder.addColumn("pose", 2);
+recorder.open("data/experiment.mpcrec");
+recorder.append(runtime, 0.01);
+recorder.append(pose, Eigen::Vector2d(1., 2.));
+recorder.flush();
+recorder.close();
+*/
+// DataRecorder::load() reads a recording back into the same structure as DataSaver::LoadAllData()
+
+// File format (little endian): the magic "MPCREC01", followed by records that start with one byte
+//  'C' column definition: uint32 id, uint32 width, uint32 name length, name
+//  'D' data:              uint32 id, uint32 number of values, the values (double)
+//  'E' end of the recording
+
+#ifndef ros_tools_DATA_RECORDER_H
+#define ros_tools_DATA_RECORDER_H
+
+#include <Eigen/Dense>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace RosTools
+{
+    typedef int ColumnHandle;
+
+    class DataRecorder
+    {
+    public:
+        /** @param reserve Number of values preallocated per column and buffer */
+        DataRecorder(int reserve = 1024);
+        ~DataRecorder();
+
+        DataRecorder(const DataRecorder &) = delete;
+        DataRecorder &operator=(const DataRecorder &) = delete;
+
+        /** @brief Register a column of scalars (width 1) or points (width 2), the name is only used when writing */
+        ColumnHandle addColumn(const std::string &name, int width = 1);
+        int numColumns() const { return (int)_columns.size(); }
+
+        void append(ColumnHandle handle, double value)
+        {
+            Column &column = *_columns[handle];
+            column.active.push_back(value);
+        }
+
+        void append(ColumnHandle handle, const Eigen::Vector2d &value)
+        {
+            Column &column = *_columns[handle];
+            column.active.push_back(value(0));
+            column.active.push_back(value(1));
+        }
+
+        /** @brief Open the file (creating its folder) and start the writer thread */
+        bool open(const std::string &file_path);
+        bool isOpen() const { return _file.is_open(); }
+
+        /** @brief Hand the appended values to the writer thread (keeps them if it is still writing the previous batch) */
+        void flush();
+
+        /** @brief Block until the writer thread has written the values handed over by flush() */
+        void waitUntilWritten();
+
+        /** @brief Write all remaining values, stop the writer thread and close the file */
+        void close();
+
+        /** @brief Load a recording, per column name (scalars and points) */
+        static bool load(const std::string &file_path, std::map<std::string, std::vector<double>> &result_scalar,
+                         std::map<std::string, std::vector<Eigen::Vector2d>> &result_vector);
+
+    private:
+        struct Column
+        {
+            std::string name;
+            uint32_t id, width;
+            bool defined{false}; // Definition written (writer thread only)
+
+            std::vector<double> active;  // Appended to by the caller
+            std::vector<double> pending; // Written by the writer thread
+        };
+
+        std::vector<std::unique_ptr<Column>> _columns;
+        int _reserve;
+
+        std::ofstream _file;
+        std::thread _writer;
+        std::mutex _mutex;
+        std::condition_variable _cv;
+        std::atomic<bool> _batch_ready{false};
+        bool _stop{false};
+        std::vector<Column *> _batch; // Columns with pending values (owned by the writer while _batch_ready)
+
+        void writerLoop();
+        void writeBatch();
+    };
+}
+
+#endif // ros_tools_DATA_RECORDER_H
@@ -0,0 +1,56 @@
+#ifndef ros_tools_LATENCY_HISTOGRAM_H
+#define ros_tools_LATENCY_HISTOGRAM_H
+
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+namespace RosTools
+{
+    /**
+     * @brief Fixed-memory log-linear (HDR-style) histogram of durations
+     *
+     * Durations are stored in nanoseconds. Below 128 ns each bucket is exact, above that every power of two is split into
+     * 64 linear buckets, such that values are resolved within 1/64 (~1.6%) up to 2^41 ns (~36.6 minutes). Recording is O(1).
+     * The buckets (~18 KB) are allocated on the first record, such that an unused histogram is cheap to construct.
+     */
+    class LatencyHistogram
+    {
+    public:
+        LatencyHistogram();
+
+        /** @brief Record a duration in seconds */
+        void record(double duration);
+        void reset();
+
+        /** @brief Add the samples of another histogram (e.g., of another thread or run) */
+        void merge(const LatencyHistogram &other);
+
+        uint64_t getCount() const { return _count; }
+
+        /** @brief Duration (s) below which the given percentage [0, 100] of the samples lie (bucket resolution) */
+        double getPercentile(double percentile) const;
+
+        /** @brief Exact maximum duration (s) */
+        double getMax() const;
+
+        /** @brief Number of samples above the given duration (s), at bucket resolution */
+        uint64_t getCountAbove(double duration) const;
+
+        /** @brief Write the maximum and the non-empty buckets as "<bucket index> <count>" lines, terminated by "end" */
+        void write(std::ostream &stream) const;
+
+        /** @brief Merge a histogram written with write(), returns false if the input is malformed */
+        bool read(std::istream &stream);
+
+    private:
+        static int bucketIndex(uint64_t value);
+        static uint64_t bucketUpperValue(int index);
+
+        std::vector<uint64_t> _buckets; // Empty until the first sample
+        uint64_t _count{0};
+        uint64_t _max{0};
+    };
+}
+
+#endif // ros_tools_LATENCY_HISTOGRAM_H
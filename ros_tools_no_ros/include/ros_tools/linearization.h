@@ -0,0 +1,55 @@
+#ifndef ros_tools_LINEARIZATION_H
+#define ros_tools_LINEARIZATION_H
+
+#include <Eigen/Dense>
+
+namespace RosTools
+{
+    /**
+     * @brief Circular obstacles over a horizon in structure-of-arrays layout
+     *
+     * Entry (k, o) holds the position of obstacle o at stage k. Each column is contiguous over the stages, such that the
+     * kernels below handle all stages of one obstacle in a single vectorized pass.
+     */
+    struct ObstacleBlock
+    {
+        Eigen::ArrayXXd x, y;  // [stage x obstacle]
+        Eigen::ArrayXd radius; // [obstacle]
+
+        /** @brief Resize the block (only reallocates if the dimensions changed) */
+        void resize(int num_stages, int num_obstacles);
+
+        int numStages() const { return x.rows(); }
+        int numObstacles() const { return x.cols(); }
+    };
+
+    /** @brief Linear constraints a1 * x + a2 * y <= b, where entry (k, i) is constraint i at stage k */
+    struct HalfspaceBlock
+    {
+        Eigen::ArrayXXd a1, a2, b; // [stage x constraint]
+
+        void resize(int num_stages, int num_constraints);
+    };
+
+    /**
+     * @brief Project the positions at all stages out of the obstacles with Douglas-Rachford iterations
+     *
+     * Within one stage, the obstacles are handled one after the other (anchored at the first obstacle), as in
+     * DouglasRachford::douglasRachfordProjection. The stages are independent and are processed together.
+     *
+     * @param obstacles The obstacles over the horizon
+     * @param extra_radius Radius added to each obstacle (e.g., the robot radius)
+     * @param iterations Number of passes over all obstacles
+     * @param x, y Positions for each stage, projected in place
+     */
+    void projectToSafety(const ObstacleBlock &obstacles, double extra_radius, int iterations, Eigen::ArrayXd &x, Eigen::ArrayXd &y);
+
+    /**
+     * @brief Linearize all obstacles at the given positions. The halfspace of obstacle o is tangent to its circle (enlarged by
+     * extra_radius) and is written to column o of halfspaces, for all stages at once.
+     */
+    void linearizeObstacles(const ObstacleBlock &obstacles, double extra_radius, const Eigen::ArrayXd &x, const Eigen::ArrayXd &y,
+                            HalfspaceBlock &halfspaces);
+}
+
+#endif // ros_tools_LINEARIZATION_H
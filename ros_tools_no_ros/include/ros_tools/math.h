@@ -9,6 +9,12 @@ namespace RosTools
 {
     double distance(const Eigen::Vector2d &a, const Eigen::Vector2d &b);
 
+    /** @brief Distance between a point and the line segment from a to b */
+    double pointSegmentDistance(const Eigen::Vector2d &point, const Eigen::Vector2d &a, const Eigen::Vector2d &b);
+
+    /** @brief Distance between the line segments a0-a1 and b0-b1 (zero if they intersect) */
+    double segmentSegmentDistance(const Eigen::Vector2d &a0, const Eigen::Vector2d &a1, const Eigen::Vector2d &b0, const Eigen::Vector2d &b1);
+
     double ExponentialQuantile(double lambda, double p);
 
     std::vector<double> linspace(double start, double end, int num);
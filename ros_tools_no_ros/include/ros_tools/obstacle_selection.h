@@ -0,0 +1,59 @@
+#ifndef ros_tools_OBSTACLE_SELECTION_H
+#define ros_tools_OBSTACLE_SELECTION_H
+
+#include <ros_tools/linearization.h>
+
+#include <Eigen/Dense>
+
+#include <string>
+#include <vector>
+
+namespace RosTools
+{
+    /** @brief How obstacles are ranked when only the most critical ones can be considered */
+    enum class RiskMetric
+    {
+        WEIGHTED_DISTANCE = 0, // Minimum distance over the horizon, weighted with the stage (later stages matter less)
+        MIN_DISTANCE,          // Minimum clearance over the horizon
+        TIME_TO_COLLISION      // First time the obstacle comes within collision distance (ties: minimum clearance)
+    };
+
+    /** @brief Parse "weighted_distance", "min_distance" or "time_to_collision" (throws std::invalid_argument otherwise) */
+    RiskMetric riskMetricFromString(const std::string &name);
+
+    /** @brief Risk of one obstacle, a lower value is more critical */
+    struct ObstacleRisk
+    {
+        double value;     // The ranking metric
+        double clearance; // Minimum clearance over the horizon (breaks ties, e.g., between obstacles that never collide)
+        int index;
+
+        bool operator<(const ObstacleRisk &other) const
+        {
+            if (value != other.value)
+                return value < other.value;
+            if (clearance != other.clearance)
+                return clearance < other.clearance;
+            return index < other.index;
+        }
+    };
+
+    /**
+     * @brief Compute the risk of each obstacle with respect to the (predicted) robot positions, once per obstacle
+     * @param robot_x, robot_y Robot positions at each stage of the obstacle block
+     * @param robot_radius Added to the obstacle radius to obtain the collision distance
+     * @param dt Time between stages
+     */
+    void computeObstacleRisks(const ObstacleBlock &obstacles, const Eigen::ArrayXd &robot_x, const Eigen::ArrayXd &robot_y,
+                              double robot_radius, double dt, RiskMetric metric, std::vector<ObstacleRisk> &risks);
+
+    /**
+     * @brief Select the (at most) max_obstacles most critical obstacles, most critical first
+     *
+     * Uses a partial selection (std::nth_element) followed by sorting only the selected obstacles: O(n + k log k) rather
+     * than O(n log n) for n obstacles. risks is reordered in place.
+     */
+    void selectCriticalObstacles(std::vector<ObstacleRisk> &risks, int max_obstacles, std::vector<int> &selected_out);
+}
+
+#endif // ros_tools_OBSTACLE_SELECTION_H
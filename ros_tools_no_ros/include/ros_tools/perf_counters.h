@@ -0,0 +1,62 @@
+#ifndef ros_tools_PERF_COUNTERS_H
+#define ros_tools_PERF_COUNTERS_H
+
+#include <cstdint>
+
+namespace RosTools
+{
+    /** @brief Hardware counter values (or differences between two readings) */
+    struct PerfSample
+    {
+        uint64_t cycles{0};
+        uint64_t instructions{0};
+        uint64_t llc_misses{0}; // Last level cache read misses
+        uint64_t branch_misses{0};
+
+        // Time (ns) the counters were enabled and actually counting (less when the PMU is shared with other events)
+        uint64_t time_enabled{0};
+        uint64_t time_running{0};
+
+        /** @brief False if the counters were not scheduled at all, such that the counts are not meaningful */
+        bool isCounting() const { return time_running > 0; }
+
+        /** @brief The counts between two readings, extrapolated to the enabled time if the counters were multiplexed */
+        PerfSample operator-(const PerfSample &other) const;
+        PerfSample &operator+=(const PerfSample &other);
+    };
+
+    /**
+     * @brief Hardware performance counters of the calling thread (Linux perf_event_open, user space only)
+     *
+     * Disabled by default. When perf is not available (e.g., not Linux, or a container without permissions), the counters
+     * report as unavailable and profiling continues with wall time only.
+     */
+    class PerfCounters
+    {
+    public:
+        /** @brief Enable or disable counting for all threads */
+        static void setEnabled(bool enabled);
+        static bool isEnabled();
+
+        /** @brief The counters of the calling thread, opened on first use */
+        static PerfCounters &get();
+
+        /** @brief Read the counters of the calling thread if counting is enabled (does not open counters otherwise) */
+        static bool sample(PerfSample &sample_out);
+
+        bool isAvailable() const { return _group_fd >= 0; }
+
+        /** @brief Read the current counter values, returns false if counting is disabled or unavailable */
+        bool read(PerfSample &sample_out) const;
+
+        ~PerfCounters();
+
+    private:
+        PerfCounters();
+
+        int _group_fd{-1}; // Leader (cycles), the other counters are read with it as one group
+        int _fds[3]{-1, -1, -1};
+    };
+}
+
+#endif // ros_tools_PERF_COUNTERS_H
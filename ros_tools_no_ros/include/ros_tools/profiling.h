@@ -1,11 +1,22 @@
 #ifndef ros_tools_PROFILING_H__
 #define ros_tools_PROFILING_H__
 
+#include <ros_tools/clock.h>
+#include <ros_tools/latency_histogram.h>
+#include <ros_tools/perf_counters.h>
+
 #include <string>
+#include <array>
+#include <atomic>
 #include <chrono>
+#include <condition_variable>
+#include <deque>
 #include <unordered_map>
+#include <memory>
 #include <mutex>
 #include <fstream>
+#include <thread>
+#include <vector>
 
 #define BENCHMARKERS RosTools::Benchmarkers::get()
 
@@ -25,11 +36,32 @@ namespace RosTools
 
         double getLast() const;
         double getTotalDuration() const;
+        int getNumRuns() const;
+
+        /** @brief Duration (s) below which the given percentage of the runs finished */
+        double getPercentile(double percentile) const;
+        const LatencyHistogram &getHistogram() const;
+
+        /** @brief Count the runs that take longer than the deadline (s), a negative deadline disables counting */
+        void setDeadline(double deadline);
+        int getDeadlineMisses() const;
+
+        /** @brief Hardware counters summed over the runs that were counted (see PerfCounters) */
+        const PerfSample &getCounters() const;
+        int getCountedRuns() const;
 
         bool isRunning() const;
 
+        /** @brief Accumulate the runs of another benchmarker (e.g., of another thread) into this one */
+        void merge(const Benchmarker &other);
+
+        /** @brief Time with the given clock instead of the default clock (Clock::getDefault()) */
+        void setClock(std::shared_ptr<Clock> clock);
+
     private:
-        std::chrono::system_clock::time_point start_time_;
+        std::shared_ptr<Clock> clock_; // nullptr: the default clock
+        Clock::TimePoint start_time_;
+        Clock::TimePoint last_stop_time_;
 
         double total_duration_ = 0.0;
         double max_duration_ = -1.0;
@@ -39,10 +71,27 @@ namespace RosTools
 
         int total_runs_ = 0;
 
+        LatencyHistogram histogram_;
+        double deadline_ = -1.0;
+        int deadline_misses_ = 0;
+
+        PerfSample start_counters_, counters_;
+        bool counting_ = false;
+        int counted_runs_ = 0;
+
         std::string name_;
         bool running_ = false;
     };
 
+    /** @brief Handle of a registered benchmarker (see Benchmarkers::registerBenchmarker) */
+    typedef int BenchmarkerHandle;
+
+    /**
+     * @brief Registry of named benchmarkers that can be used from multiple threads
+     *
+     * Benchmarkers are registered once to an integer handle. Each thread times into its own slot, without locks, and the
+     * slots are only combined when reporting. Reporting and resetting should not overlap with timing on other threads.
+     */
     class Benchmarkers
     {
     public:
@@ -52,25 +101,55 @@ namespace RosTools
             return instance;
         }
 
-        Benchmarker &getBenchmarker(std::string benchmark_name)
-        {
-            if (_benchmarkers.find(benchmark_name) == _benchmarkers.end())
-            {
-                _benchmarkers.insert(std::make_pair(benchmark_name, Benchmarker(benchmark_name)));
-            }
-            return _benchmarkers.at(benchmark_name); // Retrieve the publisher from the map
-        }
+        /** @brief Register a benchmarker (returns the existing handle if the name is already registered) */
+        BenchmarkerHandle registerBenchmarker(const std::string &name);
 
-        void print()
-        {
-            for (auto &bm : _benchmarkers)
-            {
-                bm.second.print();
-            }
-        }
+        /** @brief The benchmarker of the calling thread (lock-free once this thread has used the handle) */
+        Benchmarker &getBenchmarker(BenchmarkerHandle handle);
+
+        /** @brief Convenience wrapper: looks up (or registers) the name, then returns the benchmarker of the calling thread */
+        Benchmarker &getBenchmarker(const std::string &benchmark_name);
+
+        /** @brief All runs of this benchmarker, combined over all threads */
+        Benchmarker getAggregate(BenchmarkerHandle handle);
+
+        /** @brief Reset this benchmarker on all threads */
+        void reset(BenchmarkerHandle handle);
+
+        /** @brief Set the deadline of this benchmarker on all (also future) threads */
+        void setDeadline(BenchmarkerHandle handle, double deadline);
+
+        /** @brief Registered benchmarkers have the handles 0 ... getNumBenchmarkers() - 1 */
+        int getNumBenchmarkers();
+        std::string getName(BenchmarkerHandle handle);
+
+        /** @brief Reset all benchmarkers, e.g., between experiments */
+        void resetAll();
+
+        void print();
+
+        /** @brief Write the aggregated histograms of all benchmarkers as "<name>" followed by LatencyHistogram::write */
+        void exportHistograms(std::ostream &stream);
 
     private:
-        std::unordered_map<std::string, Benchmarker> _benchmarkers;
+        /** @brief Benchmarkers of one thread, indexed by handle (a deque, such that references remain valid) */
+        struct ThreadSlots
+        {
+            std::deque<Benchmarker> slots;
+
+            ThreadSlots();
+            ~ThreadSlots(); // Keeps the runs of threads that exit
+        };
+
+        ThreadSlots &threadSlots();
+
+        std::mutex _mutex;
+        std::vector<std::string> _names;
+        std::vector<double> _deadlines;
+        std::unordered_map<std::string, BenchmarkerHandle> _handles;
+
+        std::vector<ThreadSlots *> _threads;
+        std::vector<Benchmarker> _retired; // Runs of threads that exited
 
         std::string frame_id{"map"};
 
@@ -83,8 +162,8 @@ namespace RosTools
     class Timer
     {
     public:
-        // Duration in s
-        Timer(const double &duration = 0.);
+        // Duration in s, timed with the given clock (nullptr: the default clock)
+        Timer(const double &duration = 0., std::shared_ptr<Clock> clock = nullptr);
 
         void setDuration(const double &duration);
         void start();
@@ -93,7 +172,8 @@ namespace RosTools
         bool hasFinished();
 
     private:
-        std::chrono::system_clock::time_point start_time;
+        std::shared_ptr<Clock> clock_;
+        Clock::TimePoint start_time;
         double duration_;
     };
 
@@ -113,11 +193,15 @@ namespace RosTools
 #define PROFILE_FUNCTION()
 #endif
 
+    /** @brief One profiled scope (compact binary record, the name must outlive the session, e.g., a string literal) */
     struct ProfileResult
     {
-        std::string Name;
+        const char *Name;
         long long Start, End;
         uint32_t ThreadID;
+
+        bool HasCounters{false};
+        PerfSample Counters; // Hardware counters over the scope
     };
 
     struct InstrumentationSession
@@ -125,13 +209,55 @@ namespace RosTools
         std::string Name;
     };
 
+    /**
+     * @brief Records profiled scopes into a Chrome trace (chrome://tracing)
+     *
+     * Each thread records into its own lock-free ring buffer, a background thread drains the buffers into the trace file.
+     * Events that do not fit in a full buffer are dropped and counted. The buffer of a thread that exits is released once
+     * it has been drained.
+     */
     class Instrumentor
     {
     private:
+        static constexpr size_t BUFFER_SIZE = 4096; // Events per thread
+
+        /** @brief Single-producer (the owning thread), single-consumer (the writer thread) ring buffer */
+        struct ThreadBuffer
+        {
+            std::array<ProfileResult, BUFFER_SIZE> events;
+            std::atomic<uint64_t> head{0}; // Next event to write
+            std::atomic<uint64_t> tail{0}; // Next event to read
+            std::atomic<uint64_t> dropped{0};
+
+            std::atomic<bool> writing{false}; // Set while the owning thread records, EndSession waits for it
+            std::atomic<bool> retired{false}; // The owning thread exited, no events follow
+        };
+
+        /** @brief Owned by each recording thread, retires its buffer when the thread exits */
+        struct ThreadBufferHolder
+        {
+            std::shared_ptr<ThreadBuffer> buffer;
+            ~ThreadBufferHolder();
+        };
+
         InstrumentationSession *m_CurrentSession;
         std::ofstream m_OutputStream;
         int m_ProfileCount;
-        std::mutex m_lock;
+
+        std::atomic<bool> m_Active{false};
+        std::mutex m_lock; // Protects the list of buffers
+        std::vector<std::shared_ptr<ThreadBuffer>> m_Buffers;
+        std::vector<std::shared_ptr<ThreadBuffer>> m_DrainBuffers; // Copy of m_Buffers while draining (reused)
+        std::atomic<uint64_t> m_RetiredDropped{0};                // Dropped events of released buffers
+
+        std::thread m_Writer;
+        std::mutex m_WriterLock;
+        std::condition_variable m_WriterCondition;
+        bool m_StopWriter{false};
+
+        ThreadBuffer &GetThreadBuffer();
+        void WriterLoop();
+        uint64_t Drain(); // Returns the number of dropped events
 
     public:
         Instrumentor() : m_CurrentSession(nullptr), m_ProfileCount(0) {}
@@ -139,11 +265,22 @@ namespace RosTools
         void BeginSession(const std::string &name, const std::string &filepath = "profiler.json");
         void EndSession();
 
+        /** @brief Record a profiled scope (lock-free, does not perform I/O) */
         void WriteProfile(const ProfileResult &result);
 
+        /** @brief Events dropped in the current (or last) session because a thread buffer was full */
+        uint64_t GetDroppedCount();
+
+        /** @brief Number of thread buffers, of running threads and of exited threads that were not drained yet */
+        size_t GetThreadBufferCount();
+
         void WriteHeader();
         void WriteFooter();
 
+        /**
+         * @brief The instance is never destroyed, such that threads and static objects can still record while the program exits.
+         * A session that is still open at exit is ended by an exit handler (joining the writer and completing the trace).
+         */
         static Instrumentor &Get()
         {
             static Instrumentor *instance = new Instrumentor();
@@ -161,8 +298,11 @@ namespace RosTools
 
     private:
         const char *m_Name;
-        std::chrono::system_clock::time_point m_StartTimepoint;
+        Clock::TimePoint m_StartTimepoint;
         bool m_Stopped;
+
+        bool m_HasCounters;
+        PerfSample m_StartCounters;
     };
 
 }
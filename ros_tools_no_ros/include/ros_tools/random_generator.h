@@ -27,12 +27,17 @@ namespace RosTools
 
         static void uniformToGaussian2D(Eigen::Vector2d &uniform_variables);
 
+        /** @brief Seed generators that would be seeded randomly (seed -1) with this seed instead, e.g., to replay deterministically */
+        static void setDefaultSeed(int seed);
+
     private:
         std::mt19937 rng_double_;
         std::mt19937 rng_int_;
         std::mt19937 rng_gaussian_;
         std::uniform_real_distribution<> runif_;
         double epsilon_;
+
+        static int default_seed_;
     };
 }
 #endif
\ No newline at end of file
@@ -52,12 +52,22 @@ namespace RosTools
 
         double getPathAngle(double t) const;
 
+        /**
+         * @brief Evaluate many parameters in one pass over the segments (O(1) per parameter when t is increasing)
+         * @param velocities, accelerations, segments Optional outputs. Buffers are resized, such that they can be reused
+         */
+        void getPoints(const std::vector<double> &t, std::vector<Eigen::Vector2d> &points,
+                       std::vector<Eigen::Vector2d> *velocities = nullptr,
+                       std::vector<Eigen::Vector2d> *accelerations = nullptr,
+                       std::vector<int> *segments = nullptr) const;
 
         void samplePoints(std::vector<Eigen::Vector2d> &points, double ds) const;
         void samplePoints(std::vector<Eigen::Vector2d> &points, std::vector<double> &angles, double ds) const;
 
-        /** @brief Check the entire spline for the closest point */
+        /** @brief Check the entire spline for the closest point (segments are pruned with their bounding boxes) */
         void initializeClosestPoint(const Eigen::Vector2d &point, int &segment_out, double &t_out);
+
+        /** @brief Find the closest point in the segments around the previous closest point (a global search if the point jumped) */
         void findClosestPoint(const Eigen::Vector2d &point, int &segment_out, double &t_out, int range = 2);
 
         void getParameters(int segment_index,
@@ -66,6 +76,9 @@ namespace RosTools
 
         int numSegments() const { return _x_spline.m_x_.size() - 1; }
         double getSegmentStart(int index) const;
+
+        /** @brief Segment that contains parameter t (constant time lookup, clamped to the spline) */
+        int findSegment(double t) const;
         // double getSegmentEnd(int index) const { return _s_vector[index]; };
         double length() const { return _s_vector.back(); }
         double parameterLength() const { return _t_vector.back(); }
@@ -87,9 +100,21 @@ namespace RosTools
         int _closest_segment{-1};
         Eigen::Vector2d _prev_query_point;
 
+        struct SegmentBox
+        {
+            Eigen::Vector2d min, max;
+        };
+        std::vector<SegmentBox> _segment_boxes; // Axis-aligned bounding box of each segment
+        std::vector<int> _segment_lut;          // Segment at uniformly spaced parameter values
+        double _lut_step{1.};                   // Parameter distance between entries of the lookup table
+
         void computeDistanceVector(const std::vector<double> &x, const std::vector<double> &y, std::vector<double> &out);
 
-        double findClosestSRecursively(const Eigen::Vector2d &point, double low, double high, int num_recursions) const;
+        /** @brief Precompute the segment lookup table and bounding boxes (called on construction) */
+        void initializeLookupTables();
+
+        /** @brief Closest point on one segment via Newton iterations. Returns t, with its squared distance in dist_squared_out */
+        double findClosestOnSegment(const Eigen::Vector2d &point, int segment_index, double &dist_squared_out) const;
     };
 
     class Spline4D
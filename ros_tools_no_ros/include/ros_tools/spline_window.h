@@ -0,0 +1,75 @@
+#ifndef ros_tools_SPLINE_WINDOW_H
+#define ros_tools_SPLINE_WINDOW_H
+
+#include <ros_tools/spline.h>
+
+#include <Eigen/Dense>
+
+#include <memory>
+#include <vector>
+
+namespace RosTools
+{
+    /**
+     * @brief A cubic spline over a bounded window of a (long) path, that slides along the path as the robot progresses
+     *
+     * The window spline is parameterized over the distance along the full path, such that the path progress does not change when
+     * the window moves. Segment i of the window spline is segment firstIndex() + i of the full path. Moving the window only
+     * refits the points inside of it, so that the cost of following the path does not depend on its length.
+     */
+    class Spline2DWindow
+    {
+    public:
+        Spline2DWindow(double look_behind = 5., double look_ahead = 30., int min_segments_ahead = 0);
+
+        /** @brief Set the full path. If s is empty, the path is parameterized by the distance between its points */
+        void setPath(const std::vector<double> &x, const std::vector<double> &y, const std::vector<double> &s = {});
+        void clear();
+
+        /**
+         * @brief Find the closest point on the path and move the window along with it
+         * @return true if the window moved (i.e., getSpline() returns a new spline)
+         */
+        bool findClosestPoint(const Eigen::Vector2d &point, int &segment_out, double &s_out);
+
+        /** @brief Move the window such that it covers the path around distance s. Returns true if the window moved */
+        bool update(double s);
+
+        /** @brief The spline over the current window (nullptr before the first update) */
+        const std::shared_ptr<Spline2D> &getSpline() const { return _spline; }
+
+        /** @brief Index of the first and last path point in the window */
+        int firstIndex() const { return _first; }
+        int lastIndex() const { return _last; }
+
+        /** @brief Path segment that contains distance s (clamped to the path) */
+        int findPathSegment(double s) const;
+
+        /** @brief Values of a signal defined on the full path (e.g., a velocity profile) in the current window */
+        std::vector<double> getWindowValues(const std::vector<double> &values) const;
+
+        bool empty() const { return _s.empty(); }
+        bool coversEnd() const { return _last == numPoints() - 1; }
+        int numPoints() const { return (int)_s.size(); }
+
+        const std::vector<double> &getPathDistances() const { return _s; }
+        double pathLength() const { return _s.empty() ? 0. : _s.back(); }
+        Eigen::Vector2d getPathEnd() const { return Eigen::Vector2d(_x.back(), _y.back()); }
+
+    private:
+        double _look_behind, _look_ahead;
+        int _min_segments_ahead;
+
+        std::vector<double> _x, _y, _s;
+
+        std::shared_ptr<Spline2D> _spline{nullptr};
+        int _first{0}, _last{-1};
+
+        Eigen::Vector2d _prev_query_point;
+
+        bool needsUpdate(double s) const;
+        void fitWindow(double s);
+    };
+}
+
+#endif // ros_tools_SPLINE_WINDOW_H
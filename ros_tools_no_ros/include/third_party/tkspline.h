@@ -107,6 +107,15 @@ namespace tk
 		double operator()(double x) const;
 		double deriv(int order, double x) const;
 
+		/** @brief Segment used to evaluate each x (as in operator()). A cursor walks through the segments, O(1) per x when x is sorted */
+		void find_segments(const std::vector<double> &x, std::vector<int> &segments) const;
+
+		/** @brief Evaluate the spline and optionally its derivatives at all x in one pass (output buffers are resized) */
+		void evaluate(const std::vector<double> &x, const std::vector<int> &segments, std::vector<double> &y,
+					  std::vector<double> *dy = nullptr, std::vector<double> *ddy = nullptr) const;
+		void evaluate(const std::vector<double> &x, std::vector<double> &y,
+					  std::vector<double> *dy = nullptr, std::vector<double> *ddy = nullptr) const;
+
 		// void removeStart()
 		// {
 		// 	// Remove the first element of all computed / input vectors
@@ -0,0 +1,100 @@
+#include "ros_tools/banded_cholesky.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace RosTools
+{
+    BandedCholesky::BandedCholesky(int size, int bandwidth)
+    {
+        Reset(size, bandwidth);
+    }
+
+    void BandedCholesky::Reset(int size, int bandwidth)
+    {
+        n_ = size;
+        p_ = std::max(0, std::min(bandwidth, size - 1));
+        factorized_ = false;
+
+        // Reuse the existing storage if it is large enough
+        if (band_.rows() != p_ + 1 || band_.cols() < n_)
+            band_.resize(p_ + 1, std::max<Eigen::Index>(n_, band_.cols()));
+
+        band_.leftCols(n_).setZero();
+    }
+
+    bool BandedCholesky::Factorize()
+    {
+        // Column-wise Cholesky, L(i, j) is stored in place of A(i, j)
+        for (int j = 0; j < n_; j++)
+        {
+            int k_start = std::max(0, j - p_);
+
+            double diagonal = band_(0, j);
+            for (int k = k_start; k < j; k++)
+                diagonal -= band_(j - k, k) * band_(j - k, k);
+
+            if (diagonal <= 0.)
+                return false;
+
+            double l_jj = std::sqrt(diagonal);
+            band_(0, j) = l_jj;
+
+            int i_end = std::min(n_ - 1, j + p_);
+            for (int i = j + 1; i <= i_end; i++)
+            {
+                double value = band_(i - j, j);
+                for (int k = std::max(0, i - p_); k < j; k++)
+                    value -= band_(i - k, k) * band_(j - k, k);
+
+                band_(i - j, j) = value / l_jj;
+            }
+        }
+
+        factorized_ = true;
+        return true;
+    }
+
+    void BandedCholesky::Solve(const Eigen::VectorXd &b, Eigen::VectorXd &x) const
+    {
+        if (!factorized_)
+            throw std::runtime_error("BandedCholesky::Solve() called before Factorize()");
+
+        if (&x != &b)
+            x = b;
+
+        // Forward substitution: L y = b
+        for (int i = 0; i < n_; i++)
+        {
+            double value = x(i);
+            for (int k = std::max(0, i - p_); k < i; k++)
+                value -= band_(i - k, k) * x(k);
+            x(i) = value / band_(0, i);
+        }
+
+        // Backward substitution: L^T x = y
+        for (int i = n_ - 1; i >= 0; i--)
+        {
+            double value = x(i);
+            int k_end = std::min(n_ - 1, i + p_);
+            for (int k = i + 1; k <= k_end; k++)
+                value -= band_(k - i, i) * x(k);
+            x(i) = value / band_(0, i);
+        }
+    }
+
+    Eigen::MatrixXd BandedCholesky::ToDense() const
+    {
+        Eigen::MatrixXd result = Eigen::MatrixXd::Zero(n_, n_);
+        for (int j = 0; j < n_; j++)
+        {
+            for (int d = 0; d <= p_ && j + d < n_; d++)
+            {
+                result(j + d, j) = band_(d, j);
+                result(j, j + d) = band_(d, j);
+            }
+        }
+        return result;
+    }
+}
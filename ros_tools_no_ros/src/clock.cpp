@@ -0,0 +1,27 @@
+#include "ros_tools/clock.h"
+
+namespace RosTools
+{
+    static std::shared_ptr<Clock> &defaultClock()
+    {
+        static std::shared_ptr<Clock> clock = std::make_shared<SteadyClock>();
+        return clock;
+    }
+
+    const std::shared_ptr<Clock> &Clock::getDefault() { return defaultClock(); }
+
+    void Clock::setDefault(std::shared_ptr<Clock> clock)
+    {
+        defaultClock() = clock ? clock : std::make_shared<SteadyClock>();
+    }
+
+    void VirtualClock::setTime(double seconds)
+    {
+        _nanoseconds.store((int64_t)(seconds * 1e9), std::memory_order_release);
+    }
+
+    void VirtualClock::advance(double seconds)
+    {
+        _nanoseconds.fetch_add((int64_t)(seconds * 1e9), std::memory_order_acq_rel);
+    }
+}
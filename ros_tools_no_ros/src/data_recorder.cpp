@@ -0,0 +1,246 @@
+#include "ros_tools/data_recorder.h"
+
+#include <ros_tools/logging.h>
+
+#include <cstring>
+#include <filesystem>
+
+namespace RosTools
+{
+    static const char MAGIC[8] = {'M', 'P', 'C', 'R', 'E', 'C', '0', '1'};
+
+    template <typename T>
+    static void writeValue(std::ofstream &file, const T &value)
+    {
+        file.write(reinterpret_cast<const char *>(&value), sizeof(T));
+    }
+
+    template <typename T>
+    static bool readValue(std::ifstream &file, T &value)
+    {
+        return (bool)file.read(reinterpret_cast<char *>(&value), sizeof(T));
+    }
+
+    DataRecorder::DataRecorder(int reserve) : _reserve(reserve) {}
+
+    DataRecorder::~DataRecorder() { close(); }
+
+    ColumnHandle DataRecorder::addColumn(const std::string &name, int width)
+    {
+        ROSTOOLS_ASSERT(width == 1 || width == 2, "Data recorder columns hold scalars or points");
+
+        // Columns are registered from the recording thread, the writer only sees them through a batch
+        _columns.emplace_back(new Column());
+        Column &column = *_columns.back();
+        column.name = name;
+        column.id = _columns.size() - 1;
+        column.width = width;
+        column.active.reserve(_reserve * width);
+        column.pending.reserve(_reserve * width);
+
+        return column.id;
+    }
+
+    bool DataRecorder::open(const std::string &file_path)
+    {
+        close();
+
+        std::filesystem::path path(file_path);
+        std::error_code error;
+        if (path.has_parent_path())
+            std::filesystem::create_directories(path.parent_path(), error);
+
+        _file.open(file_path, std::ios::binary | std::ios::trunc);
+        if (!_file.good())
+        {
+            LOG_WARN("Data Recorder: Could not open " << file_path << ", not recording");
+            _file.close();
+            return false;
+        }
+
+        LOG_INFO("Data Recorder: Recording to " << file_path);
+        _file.write(MAGIC, sizeof(MAGIC));
+
+        for (auto &column : _columns)
+            column->defined = false;
+
+        _stop = false;
+        _writer = std::thread(&DataRecorder::writerLoop, this);
+        return true;
+    }
+
+    void DataRecorder::flush()
+    {
+        if (!isOpen() || _batch_ready.load(std::memory_order_acquire))
+            return; // Keep appending until the writer has finished the previous batch
+
+        // The writer is idle: swap the appended values into the pending buffers (no allocations after warm-up)
+        _batch.clear();
+        for (auto &column : _columns)
+        {
+            if (column->active.empty())
+                continue;
+
+            column->active.swap(column->pending);
+            _batch.push_back(column.get());
+        }
+
+        if (_batch.empty())
+            return;
+
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _batch_ready.store(true, std::memory_order_release);
+        }
+        _cv.notify_one();
+    }
+
+    void DataRecorder::waitUntilWritten()
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _cv.wait(lock, [this]()
+                 { return !_batch_ready.load(); });
+    }
+
+    void DataRecorder::close()
+    {
+        if (!isOpen())
+            return;
+
+        // Wait for the current batch, then hand over the remaining values
+        waitUntilWritten();
+        flush();
+
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _stop = true;
+        }
+        _cv.notify_all();
+        _writer.join();
+
+        _file.put('E');
+        _file.close();
+    }
+
+    void DataRecorder::writerLoop()
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        while (true)
+        {
+            _cv.wait(lock, [this]()
+                     { return _batch_ready.load() || _stop; });
+
+            if (_batch_ready.load())
+            {
+                lock.unlock();
+                writeBatch();
+                lock.lock();
+
+                _batch_ready.store(false, std::memory_order_release);
+                _cv.notify_all(); // close() may be waiting
+            }
+            else if (_stop)
+                return;
+        }
+    }
+
+    void DataRecorder::writeBatch()
+    {
+        for (Column *column : _batch)
+        {
+            if (!column->defined)
+            {
+                _file.put('C');
+                writeValue(_file, column->id);
+                writeValue(_file, column->width);
+                writeValue(_file, (uint32_t)column->name.size());
+                _file.write(column->name.data(), column->name.size());
+                column->defined = true;
+            }
+
+            _file.put('D');
+            writeValue(_file, column->id);
+            writeValue(_file, (uint32_t)column->pending.size());
+            _file.write(reinterpret_cast<const char *>(column->pending.data()), column->pending.size() * sizeof(double));
+
+            column->pending.clear();
+        }
+        _file.flush();
+    }
+
+    bool DataRecorder::load(const std::string &file_path, std::map<std::string, std::vector<double>> &result_scalar,
+                            std::map<std::string, std::vector<Eigen::Vector2d>> &result_vector)
+    {
+        std::ifstream file(file_path, std::ios::binary);
+
+        LOG_INFO("Data Recorder: Loading data from " << file_path);
+
+        char magic[sizeof(MAGIC)];
+        if (!file.read(magic, sizeof(magic)) || std::memcmp(magic, MAGIC, sizeof(MAGIC)) != 0)
+        {
+            LOG_WARN("Data Recorder: " << file_path << " is not a recording");
+            return false;
+        }
+
+        std::vector<std::pair<std::string, uint32_t>> columns; // Name and width per id
+        std::vector<double> values;
+
+        char type;
+        while (file.get(type))
+        {
+            uint32_t id, size;
+            if (type == 'E')
+                return true;
+
+            if (!readValue(file, id) || !readValue(file, size))
+                break;
+
+            if (type == 'C')
+            {
+                uint32_t width = size;
+                uint32_t name_length;
+                if (!readValue(file, name_length))
+                    break;
+
+                std::string name(name_length, ' ');
+                if (!file.read(&name[0], name_length))
+                    break;
+
+                if (columns.size() <= id)
+                    columns.resize(id + 1);
+                columns[id] = {name, width};
+
+                if (width == 1)
+                    result_scalar[name];
+                else
+                    result_vector[name];
+            }
+            else if (type == 'D')
+            {
+                if (id >= columns.size() || columns[id].second == 0)
+                    break;
+
+                values.resize(size);
+                if (!file.read(reinterpret_cast<char *>(values.data()), size * sizeof(double)))
+                    break;
+
+                if (columns[id].second == 1)
+                {
+                    auto &result = result_scalar[columns[id].first];
+                    result.insert(result.end(), values.begin(), values.end());
+                }
+                else
+                {
+                    auto &result = result_vector[columns[id].first];
+                    for (uint32_t i = 0; i + 1 < size; i += 2)
+                        result.emplace_back(values[i], values[i + 1]);
+                }
+            }
+            else
+                break;
+        }
+
+        LOG_WARN("Data Recorder: " << file_path << " is incomplete or corrupted, loaded the data up to that point");
+        return false;
+    }
+}
@@ -0,0 +1,146 @@
+#include "ros_tools/latency_histogram.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <string>
+
+namespace RosTools
+{
+    namespace
+    {
+        constexpr int SUB_BUCKET_BITS = 7;                // Exact below 2^7 ns
+        constexpr int SUB_BUCKETS = 1 << SUB_BUCKET_BITS; // 128
+        constexpr int HALF_SUB_BUCKETS = SUB_BUCKETS / 2; // Linear buckets per power of two
+        constexpr int MAX_SHIFT = 34;                     // Up to 2^41 ns
+        constexpr int NUM_BUCKETS = SUB_BUCKETS + MAX_SHIFT * HALF_SUB_BUCKETS;
+    }
+
+    LatencyHistogram::LatencyHistogram()
+    {
+    }
+
+    int LatencyHistogram::bucketIndex(uint64_t value)
+    {
+        if (value < (uint64_t)SUB_BUCKETS)
+            return (int)value;
+
+        int most_significant_bit = 63 - __builtin_clzll(value);
+        int shift = most_significant_bit - (SUB_BUCKET_BITS - 1); // Keep the 7 most significant bits
+        if (shift > MAX_SHIFT)
+            return NUM_BUCKETS - 1;
+
+        int sub_bucket = (int)(value >> shift); // In [64, 128)
+        return SUB_BUCKETS + (shift - 1) * HALF_SUB_BUCKETS + (sub_bucket - HALF_SUB_BUCKETS);
+    }
+
+    uint64_t LatencyHistogram::bucketUpperValue(int index)
+    {
+        if (index < SUB_BUCKETS)
+            return (uint64_t)index;
+
+        int shift = (index - SUB_BUCKETS) / HALF_SUB_BUCKETS + 1;
+        uint64_t sub_bucket = (index - SUB_BUCKETS) % HALF_SUB_BUCKETS + HALF_SUB_BUCKETS;
+        return ((sub_bucket + 1) << shift) - 1;
+    }
+
+    void LatencyHistogram::record(double duration)
+    {
+        uint64_t value = (uint64_t)std::max(0., std::round(duration * 1e9));
+
+        if (_buckets.empty())
+            _buckets.assign(NUM_BUCKETS, 0);
+        _buckets[bucketIndex(value)]++;
+        _count++;
+        _max = std::max(_max, value);
+    }
+
+    void LatencyHistogram::reset()
+    {
+        std::fill(_buckets.begin(), _buckets.end(), 0);
+        _count = 0;
+        _max = 0;
+    }
+
+    void LatencyHistogram::merge(const LatencyHistogram &other)
+    {
+        if (other._buckets.empty())
+            return;
+
+        if (_buckets.empty())
+            _buckets.assign(NUM_BUCKETS, 0);
+        for (int i = 0; i < NUM_BUCKETS; i++)
+            _buckets[i] += other._buckets[i];
+
+        _count += other._count;
+        _max = std::max(_max, other._max);
+    }
+
+    double LatencyHistogram::getPercentile(double percentile) const
+    {
+        if (_count == 0)
+            return 0.;
+
+        uint64_t rank = (uint64_t)std::ceil(std::min(100., std::max(0., percentile)) / 100. * _count);
+        rank = std::max(rank, (uint64_t)1);
+
+        uint64_t cumulative = 0;
+        for (int i = 0; i < NUM_BUCKETS; i++)
+        {
+            cumulative += _buckets[i];
+            if (cumulative >= rank)
+                return std::min(bucketUpperValue(i), _max) * 1e-9;
+        }
+        return getMax();
+    }
+
+    double LatencyHistogram::getMax() const { return _max * 1e-9; }
+
+    uint64_t LatencyHistogram::getCountAbove(double duration) const
+    {
+        uint64_t value = (uint64_t)std::max(0., std::round(duration * 1e9));
+
+        uint64_t count = 0;
+        for (int i = bucketIndex(value) + 1; i < (int)_buckets.size(); i++)
+            count += _buckets[i];
+        return count;
+    }
+
+    void LatencyHistogram::write(std::ostream &stream) const
+    {
+        stream << "max " << _max << "\n";
+        for (int i = 0; i < (int)_buckets.size(); i++)
+        {
+            if (_buckets[i] > 0)
+                stream << i << " " << _buckets[i] << "\n";
+        }
+        stream << "end\n";
+    }
+
+    bool LatencyHistogram::read(std::istream &stream)
+    {
+        std::string label;
+        uint64_t max;
+        if (!(stream >> label >> max) || label != "max")
+            return false;
+
+        LatencyHistogram histogram;
+        histogram._buckets.assign(NUM_BUCKETS, 0);
+        histogram._max = max;
+
+        std::string index;
+        uint64_t count;
+        while (stream >> index && index != "end")
+        {
+            int bucket = std::atoi(index.c_str());
+            if (!(stream >> count) || bucket < 0 || bucket >= NUM_BUCKETS)
+                return false;
+
+            histogram._buckets[bucket] += count;
+            histogram._count += count;
+        }
+
+        merge(histogram);
+        return true;
+    }
+}
@@ -0,0 +1,96 @@
+#include "ros_tools/linearization.h"
+
+#include <cmath>
+
+namespace RosTools
+{
+    void ObstacleBlock::resize(int num_stages, int num_obstacles)
+    {
+        x.resize(num_stages, num_obstacles);
+        y.resize(num_stages, num_obstacles);
+        radius.resize(num_obstacles);
+    }
+
+    void HalfspaceBlock::resize(int num_stages, int num_constraints)
+    {
+        a1.resize(num_stages, num_constraints);
+        a2.resize(num_stages, num_constraints);
+        b.resize(num_stages, num_constraints);
+    }
+
+    void projectToSafety(const ObstacleBlock &obstacles, double extra_radius, int iterations, Eigen::ArrayXd &x, Eigen::ArrayXd &y)
+    {
+        if (obstacles.numObstacles() == 0) // There is no anchor
+            return;
+
+        const int num_stages = x.size();
+        const double *anchor_x = obstacles.x.col(0).data();
+        const double *anchor_y = obstacles.y.col(0).data();
+
+        for (int iterate = 0; iterate < iterations; iterate++)
+        {
+            for (int o = 0; o < obstacles.numObstacles(); o++)
+            {
+                const double r = obstacles.radius(o) + extra_radius;
+                const double *obstacle_x = obstacles.x.col(o).data();
+                const double *obstacle_y = obstacles.y.col(o).data();
+
+                for (int k = 0; k < num_stages; k++) // Stages are independent
+                {
+                    const double px = x(k), py = y(k);
+
+                    // Reflect the position in the anchor circle (positions outside of the circle are unchanged)
+                    double reflected_x = px, reflected_y = py;
+                    double dx = px - anchor_x[k], dy = py - anchor_y[k];
+                    double dist_squared = dx * dx + dy * dy;
+                    if (dist_squared < r * r)
+                    {
+                        double scale = r / std::sqrt(dist_squared);
+                        reflected_x = 2. * (anchor_x[k] + dx * scale) - px;
+                        reflected_y = 2. * (anchor_y[k] + dy * scale) - py;
+                    }
+
+                    // Reflect the result in the obstacle circle, projecting along the direction of the original position
+                    dx = reflected_x - obstacle_x[k];
+                    dy = reflected_y - obstacle_y[k];
+                    if (dx * dx + dy * dy < r * r)
+                    {
+                        dx = px - obstacle_x[k];
+                        dy = py - obstacle_y[k];
+                        double scale = r / std::sqrt(dx * dx + dy * dy);
+                        reflected_x = 2. * (obstacle_x[k] + dx * scale) - reflected_x;
+                        reflected_y = 2. * (obstacle_y[k] + dy * scale) - reflected_y;
+                    }
+
+                    x(k) = 0.5 * (px + reflected_x);
+                    y(k) = 0.5 * (py + reflected_y);
+                }
+            }
+        }
+    }
+
+    void linearizeObstacles(const ObstacleBlock &obstacles, double extra_radius, const Eigen::ArrayXd &x, const Eigen::ArrayXd &y,
+                            HalfspaceBlock &halfspaces)
+    {
+        const int num_stages = x.size();
+        thread_local Eigen::ArrayXd dist; // Kept between calls, such that the kernel does not allocate
+        dist.resize(num_stages);
+
+        for (int o = 0; o < obstacles.numObstacles(); o++)
+        {
+            const auto obstacle_x = obstacles.x.col(o).head(num_stages);
+            const auto obstacle_y = obstacles.y.col(o).head(num_stages);
+
+            auto a1 = halfspaces.a1.col(o).head(num_stages);
+            auto a2 = halfspaces.a2.col(o).head(num_stages);
+
+            // Normalized normal vector from the position to the obstacle
+            dist = ((obstacle_x - x).square() + (obstacle_y - y).square()).sqrt();
+            a1 = (obstacle_x - x) / dist;
+            a2 = (obstacle_y - y) / dist;
+
+            // Evaluate b on the collision circle
+            halfspaces.b.col(o).head(num_stages) = a1 * obstacle_x + a2 * obstacle_y - (obstacles.radius(o) + extra_radius);
+        }
+    }
+}
@@ -7,6 +7,33 @@ namespace RosTools
         return std::sqrt((a - b).transpose() * (a - b));
     }
 
+    double pointSegmentDistance(const Eigen::Vector2d &point, const Eigen::Vector2d &a, const Eigen::Vector2d &b)
+    {
+        Eigen::Vector2d line = b - a;
+        double line_squared = line.squaredNorm();
+        if (line_squared == 0.)
+            return (point - a).norm();
+
+        double t = std::max(0., std::min((point - a).dot(line) / line_squared, 1.));
+        return (a + t * line - point).norm();
+    }
+
+    double segmentSegmentDistance(const Eigen::Vector2d &a0, const Eigen::Vector2d &a1, const Eigen::Vector2d &b0, const Eigen::Vector2d &b1)
+    {
+        auto cross = [](const Eigen::Vector2d &u, const Eigen::Vector2d &v)
+        { return u(0) * v(1) - u(1) * v(0); };
+
+        // Proper intersection: the end points of each segment lie on opposite sides of the other segment
+        double d0 = cross(a1 - a0, b0 - a0), d1 = cross(a1 - a0, b1 - a0);
+        double d2 = cross(b1 - b0, a0 - b0), d3 = cross(b1 - b0, a1 - b0);
+        if (((d0 > 0. && d1 < 0.) || (d0 < 0. && d1 > 0.)) && ((d2 > 0. && d3 < 0.) || (d2 < 0. && d3 > 0.)))
+            return 0.;
+
+        // Otherwise, the closest points include one of the end points
+        return std::min(std::min(pointSegmentDistance(a0, b0, b1), pointSegmentDistance(a1, b0, b1)),
+                        std::min(pointSegmentDistance(b0, a0, a1), pointSegmentDistance(b1, a0, a1)));
+    }
+
     // Finds the exponential CDF value at probability p (for a rate of lambda)
     double ExponentialQuantile(double lambda, double p)
     {
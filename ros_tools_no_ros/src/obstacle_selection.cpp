@@ -0,0 +1,89 @@
+#include "ros_tools/obstacle_selection.h"
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+namespace RosTools
+{
+    RiskMetric riskMetricFromString(const std::string &name)
+    {
+        if (name == "weighted_distance")
+            return RiskMetric::WEIGHTED_DISTANCE;
+        if (name == "min_distance")
+            return RiskMetric::MIN_DISTANCE;
+        if (name == "time_to_collision")
+            return RiskMetric::TIME_TO_COLLISION;
+
+        throw std::invalid_argument("Unknown obstacle risk metric: " + name);
+    }
+
+    void computeObstacleRisks(const ObstacleBlock &obstacles, const Eigen::ArrayXd &robot_x, const Eigen::ArrayXd &robot_y,
+                              double robot_radius, double dt, RiskMetric metric, std::vector<ObstacleRisk> &risks)
+    {
+        int num_stages = obstacles.numStages();
+        int num_obstacles = obstacles.numObstacles();
+
+        risks.resize(num_obstacles);
+
+        // Scratch buffers, kept between calls such that ranking does not allocate
+        thread_local Eigen::ArrayXd distances, stage_weights;
+        distances.resize(num_stages);
+        if (stage_weights.size() != num_stages)
+            stage_weights = 0.6 * Eigen::ArrayXd::LinSpaced(num_stages, 1., num_stages);
+
+        for (int o = 0; o < num_obstacles; o++)
+        {
+            // Distance at all stages (one pass over the contiguous column of this obstacle)
+            distances = ((obstacles.x.col(o) - robot_x).square() + (obstacles.y.col(o) - robot_y).square()).sqrt();
+
+            double collision_distance = obstacles.radius(o) + robot_radius;
+
+            ObstacleRisk &risk = risks[o];
+            risk.index = o;
+            risk.clearance = distances.minCoeff() - collision_distance;
+
+            switch (metric)
+            {
+            case RiskMetric::WEIGHTED_DISTANCE:
+                risk.value = (stage_weights * distances).minCoeff();
+                break;
+            case RiskMetric::MIN_DISTANCE:
+                risk.value = risk.clearance;
+                break;
+            case RiskMetric::TIME_TO_COLLISION:
+                risk.value = std::numeric_limits<double>::infinity();
+                if (risk.clearance > 0.)
+                    break;
+
+                for (int k = 0; k < num_stages; k++)
+                {
+                    if (distances(k) > collision_distance)
+                        continue;
+
+                    // Interpolate the moment of contact between the stages
+                    if (k == 0)
+                        risk.value = 0.;
+                    else
+                        risk.value = dt * ((k - 1) + (distances(k - 1) - collision_distance) / (distances(k - 1) - distances(k)));
+                    break;
+                }
+                break;
+            }
+        }
+    }
+
+    void selectCriticalObstacles(std::vector<ObstacleRisk> &risks, int max_obstacles, std::vector<int> &selected_out)
+    {
+        int num_selected = std::max(0, std::min(max_obstacles, (int)risks.size()));
+
+        // Partition such that the first num_selected risks are the most critical, then only sort those
+        if (num_selected < (int)risks.size())
+            std::nth_element(risks.begin(), risks.begin() + num_selected, risks.end());
+        std::sort(risks.begin(), risks.begin() + num_selected);
+
+        selected_out.resize(num_selected);
+        for (int i = 0; i < num_selected; i++)
+            selected_out[i] = risks[i].index;
+    }
+}
@@ -0,0 +1,160 @@
+#include "ros_tools/perf_counters.h"
+
+#include <ros_tools/logging.h>
+
+#include <atomic>
+#include <cstring>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace RosTools
+{
+    namespace
+    {
+        std::atomic<bool> perf_enabled{false};
+
+#ifdef __linux__
+        int openCounter(uint32_t type, uint64_t config, int group_fd)
+        {
+            perf_event_attr attributes;
+            std::memset(&attributes, 0, sizeof(attributes));
+            attributes.size = sizeof(attributes);
+            attributes.type = type;
+            attributes.config = config;
+            attributes.disabled = group_fd < 0 ? 1 : 0; // The group is enabled through its leader
+            attributes.exclude_kernel = 1;
+            attributes.exclude_hv = 1;
+            attributes.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+            return syscall(__NR_perf_event_open, &attributes, 0 /* this thread */, -1 /* any cpu */, group_fd, 0);
+        }
+#endif
+    }
+
+    PerfSample PerfSample::operator-(const PerfSample &other) const
+    {
+        PerfSample result;
+        result.time_enabled = time_enabled - other.time_enabled;
+        result.time_running = time_running - other.time_running;
+
+        // Multiplexed with other events in between: extrapolate the counts to the time the group was enabled
+        double scale = 1.;
+        if (result.time_running > 0 && result.time_running < result.time_enabled)
+            scale = (double)result.time_enabled / (double)result.time_running;
+
+        result.cycles = (uint64_t)((cycles - other.cycles) * scale);
+        result.instructions = (uint64_t)((instructions - other.instructions) * scale);
+        result.llc_misses = (uint64_t)((llc_misses - other.llc_misses) * scale);
+        result.branch_misses = (uint64_t)((branch_misses - other.branch_misses) * scale);
+        return result;
+    }
+
+    PerfSample &PerfSample::operator+=(const PerfSample &other)
+    {
+        time_enabled += other.time_enabled;
+        time_running += other.time_running;
+        cycles += other.cycles;
+        instructions += other.instructions;
+        llc_misses += other.llc_misses;
+        branch_misses += other.branch_misses;
+        return *this;
+    }
+
+    void PerfCounters::setEnabled(bool enabled) { perf_enabled = enabled; }
+
+    bool PerfCounters::isEnabled() { return perf_enabled; }
+
+    PerfCounters &PerfCounters::get()
+    {
+        thread_local PerfCounters counters;
+        return counters;
+    }
+
+    bool PerfCounters::sample(PerfSample &sample_out)
+    {
+        if (!perf_enabled)
+            return false;
+
+        return get().read(sample_out);
+    }
+
+    PerfCounters::PerfCounters()
+    {
+#ifdef __linux__
+        _group_fd = openCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES, -1);
+        if (_group_fd < 0)
+        {
+            static std::atomic<bool> warned{false};
+            if (!warned.exchange(true))
+                LOG_WARN("Hardware performance counters are not available (perf_event_open: " << std::strerror(errno) << "), profiling wall time only");
+            return;
+        }
+
+        _fds[0] = openCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS, _group_fd);
+        _fds[1] = openCounter(PERF_TYPE_HW_CACHE,
+                              PERF_COUNT_HW_CACHE_LL | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16),
+                              _group_fd); // Last level cache read misses (PERF_COUNT_HW_CACHE_MISSES differs per CPU)
+        _fds[2] = openCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES, _group_fd);
+
+        ioctl(_group_fd, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ioctl(_group_fd, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+#endif
+    }
+
+    PerfCounters::~PerfCounters()
+    {
+#ifdef __linux__
+        for (int fd : _fds)
+        {
+            if (fd >= 0)
+                close(fd);
+        }
+        if (_group_fd >= 0)
+            close(_group_fd);
+#endif
+    }
+
+    bool PerfCounters::read(PerfSample &sample_out) const
+    {
+        if (!perf_enabled || !isAvailable())
+            return false;
+
+#ifdef __linux__
+        // PERF_FORMAT_GROUP: the number of counters, the time the group was enabled and running, followed by the values in
+        // the order they were opened
+        uint64_t values[7] = {0, 0, 0, 0, 0, 0, 0};
+        if (::read(_group_fd, values, sizeof(values)) < (ssize_t)(4 * sizeof(uint64_t)))
+            return false;
+
+        uint64_t num_counters = values[0];
+
+        // Never scheduled on the PMU (e.g., in a VM or when all counters are taken): the values would be zeros, not counts
+        if (values[2] == 0)
+            return false;
+
+        sample_out.time_enabled = values[1];
+        sample_out.time_running = values[2];
+        sample_out.cycles = values[3];
+
+        // Counters that failed to open (e.g., no LLC event on this CPU) remain zero
+        uint64_t value = 1;
+        uint64_t *fields[3] = {&sample_out.instructions, &sample_out.llc_misses, &sample_out.branch_misses};
+        for (int i = 0; i < 3; i++)
+        {
+            if (_fds[i] >= 0 && value < num_counters)
+                *fields[i] = values[3 + value++];
+            else
+                *fields[i] = 0;
+        }
+        return true;
+#else
+        (void)sample_out;
+        return false;
+#endif
+    }
+}
@@ -4,6 +4,7 @@
 #include <ros_tools/paths.h>
 
 #include <algorithm>
+#include <cstdlib>
 #include <thread>
 
 namespace RosTools
@@ -22,13 +23,29 @@ namespace RosTools
         LOG_DIVIDER();
         LOG_VALUE("Timing of", name_);
         LOG_VALUE("Average (ms)", average_run_time);
+        LOG_VALUE("p50 (ms)", histogram_.getPercentile(50.) * 1000.0);
+        LOG_VALUE("p90 (ms)", histogram_.getPercentile(90.) * 1000.0);
+        LOG_VALUE("p99 (ms)", histogram_.getPercentile(99.) * 1000.0);
+        LOG_VALUE("p99.9 (ms)", histogram_.getPercentile(99.9) * 1000.0);
         LOG_VALUE("Max (ms)", max_duration_ * 1000.0);
+        if (deadline_ >= 0.)
+            LOG_VALUE("Deadline misses (> " + std::to_string(deadline_ * 1000.0) + " ms)", deadline_misses_);
+
+        if (counted_runs_ > 0)
+        {
+            LOG_VALUE("Cycles (per run)", counters_.cycles / counted_runs_);
+            LOG_VALUE("Instructions (per run)", counters_.instructions / counted_runs_);
+            LOG_VALUE("IPC", (double)counters_.instructions / (double)std::max(counters_.cycles, (uint64_t)1));
+            LOG_VALUE("LLC misses (per run)", counters_.llc_misses / counted_runs_);
+            LOG_VALUE("Branch misses (per run)", counters_.branch_misses / counted_runs_);
+        }
     }
 
     void Benchmarker::start()
     {
         running_ = true;
-        start_time_ = std::chrono::system_clock::now();
+        counting_ = PerfCounters::sample(start_counters_);
+        start_time_ = (clock_ ? clock_ : Clock::getDefault())->now();
     }
 
     void Benchmarker::cancel()
@@ -41,9 +58,20 @@ namespace RosTools
         if (!running_)
             return 0.0;
 
-        auto end_time = std::chrono::system_clock::now();
+        auto end_time = (clock_ ? clock_ : Clock::getDefault())->now();
         std::chrono::duration<double> current_duration = end_time - start_time_;
 
+        PerfSample end_counters;
+        if (counting_ && PerfCounters::sample(end_counters))
+        {
+            PerfSample run_counters = end_counters - start_counters_;
+            if (run_counters.isCounting()) // Otherwise the counters were not scheduled during this run
+            {
+                counters_ += run_counters;
+                counted_runs_++;
+            }
+        }
+
         if (current_duration.count() < min_duration_)
             min_duration_ = current_duration.count();
 
@@ -53,7 +81,12 @@ namespace RosTools
         total_duration_ += current_duration.count();
         total_runs_++;
 
+        histogram_.record(current_duration.count());
+        if (deadline_ >= 0. && current_duration.count() > deadline_)
+            deadline_misses_++;
+
         last_ = current_duration.count();
+        last_stop_time_ = end_time;
         running_ = false;
         return last_;
     }
@@ -62,6 +95,46 @@ namespace RosTools
 
     double Benchmarker::getTotalDuration() const { return total_duration_; }
 
+    int Benchmarker::getNumRuns() const { return total_runs_; }
+
+    double Benchmarker::getPercentile(double percentile) const { return histogram_.getPercentile(percentile); }
+
+    const LatencyHistogram &Benchmarker::getHistogram() const { return histogram_; }
+
+    void Benchmarker::setDeadline(double deadline) { deadline_ = deadline; }
+
+    int Benchmarker::getDeadlineMisses() const { return deadline_misses_; }
+
+    const PerfSample &Benchmarker::getCounters() const { return counters_; }
+
+    int Benchmarker::getCountedRuns() const { return counted_runs_; }
+
+    void Benchmarker::merge(const Benchmarker &other)
+    {
+        if (other.total_runs_ == 0)
+            return;
+
+        total_duration_ += other.total_duration_;
+        total_runs_ += other.total_runs_;
+        min_duration_ = std::min(min_duration_, other.min_duration_);
+        max_duration_ = std::max(max_duration_, other.max_duration_);
+
+        histogram_.merge(other.histogram_);
+        deadline_misses_ += other.deadline_misses_;
+        counters_ += other.counters_;
+        counted_runs_ += other.counted_runs_;
+        if (deadline_ < 0.)
+            deadline_ = other.deadline_;
+
+        if (total_runs_ == other.total_runs_ || other.last_stop_time_ > last_stop_time_) // Most recent run
+        {
+            last_ = other.last_;
+            last_stop_time_ = other.last_stop_time_;
+        }
+    }
+
+    void Benchmarker::setClock(std::shared_ptr<Clock> clock) { clock_ = clock; }
+
     void Benchmarker::reset()
     {
         total_duration_ = 0.0;
@@ -70,18 +143,188 @@ namespace RosTools
         last_ = -1.0;
         total_runs_ = 0;
         running_ = false;
+
+        histogram_.reset();
+        deadline_misses_ = 0;
+        counters_ = PerfSample();
+        counted_runs_ = 0;
     }
 
     bool Benchmarker::isRunning() const { return running_; }
 
-    Timer::Timer(const double &duration) { duration_ = duration; }
+    Benchmarkers::ThreadSlots::ThreadSlots()
+    {
+        Benchmarkers &benchmarkers = Benchmarkers::get();
+        std::lock_guard<std::mutex> lock(benchmarkers._mutex);
+        benchmarkers._threads.push_back(this);
+    }
+
+    Benchmarkers::ThreadSlots::~ThreadSlots()
+    {
+        Benchmarkers &benchmarkers = Benchmarkers::get();
+        std::lock_guard<std::mutex> lock(benchmarkers._mutex);
+        for (size_t i = 0; i < slots.size(); i++)
+            benchmarkers._retired[i].merge(slots[i]);
+
+        benchmarkers._threads.erase(std::find(benchmarkers._threads.begin(), benchmarkers._threads.end(), this));
+    }
+
+    Benchmarkers::ThreadSlots &Benchmarkers::threadSlots()
+    {
+        thread_local ThreadSlots thread_slots;
+        return thread_slots;
+    }
+
+    BenchmarkerHandle Benchmarkers::registerBenchmarker(const std::string &name)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        auto it = _handles.find(name);
+        if (it != _handles.end())
+            return it->second;
+
+        BenchmarkerHandle handle = _names.size();
+        _names.push_back(name);
+        _deadlines.push_back(-1.);
+        _handles[name] = handle;
+        _retired.emplace_back(name);
+        return handle;
+    }
+
+    Benchmarker &Benchmarkers::getBenchmarker(BenchmarkerHandle handle)
+    {
+        ThreadSlots &thread_slots = threadSlots();
+
+        if (handle >= (int)thread_slots.slots.size()) // First use of this handle on this thread
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            while ((int)thread_slots.slots.size() <= handle)
+            {
+                int new_handle = thread_slots.slots.size();
+                thread_slots.slots.emplace_back(_names[new_handle]);
+                thread_slots.slots.back().setDeadline(_deadlines[new_handle]);
+            }
+        }
+
+        return thread_slots.slots[handle];
+    }
+
+    Benchmarker &Benchmarkers::getBenchmarker(const std::string &benchmark_name)
+    {
+        // Cache the handles per thread, such that only the first lookup of a name locks
+        thread_local std::unordered_map<std::string, BenchmarkerHandle> handles;
+
+        auto it = handles.find(benchmark_name);
+        if (it == handles.end())
+            it = handles.emplace(benchmark_name, registerBenchmarker(benchmark_name)).first;
+
+        return getBenchmarker(it->second);
+    }
+
+    Benchmarker Benchmarkers::getAggregate(BenchmarkerHandle handle)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        Benchmarker aggregate(_names[handle]);
+        aggregate.setDeadline(_deadlines[handle]);
+        aggregate.merge(_retired[handle]);
+        for (auto *thread_slots : _threads)
+        {
+            if (handle < (int)thread_slots->slots.size())
+                aggregate.merge(thread_slots->slots[handle]);
+        }
+        return aggregate;
+    }
+
+    void Benchmarkers::reset(BenchmarkerHandle handle)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        _retired[handle].reset();
+        for (auto *thread_slots : _threads)
+        {
+            if (handle < (int)thread_slots->slots.size())
+                thread_slots->slots[handle].reset();
+        }
+    }
+
+    void Benchmarkers::setDeadline(BenchmarkerHandle handle, double deadline)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        _deadlines[handle] = deadline;
+        _retired[handle].setDeadline(deadline);
+        for (auto *thread_slots : _threads)
+        {
+            if (handle < (int)thread_slots->slots.size())
+                thread_slots->slots[handle].setDeadline(deadline);
+        }
+    }
+
+    int Benchmarkers::getNumBenchmarkers()
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _names.size();
+    }
+
+    std::string Benchmarkers::getName(BenchmarkerHandle handle)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _names[handle];
+    }
+
+    void Benchmarkers::resetAll()
+    {
+        for (BenchmarkerHandle handle = 0; handle < getNumBenchmarkers(); handle++)
+            reset(handle);
+    }
+
+    void Benchmarkers::print()
+    {
+        BenchmarkerHandle num_benchmarkers;
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            num_benchmarkers = _names.size();
+        }
+
+        for (BenchmarkerHandle handle = 0; handle < num_benchmarkers; handle++)
+            getAggregate(handle).print();
+    }
+
+    void Benchmarkers::exportHistograms(std::ostream &stream)
+    {
+        BenchmarkerHandle num_benchmarkers;
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            num_benchmarkers = _names.size();
+        }
+
+        for (BenchmarkerHandle handle = 0; handle < num_benchmarkers; handle++)
+        {
+            std::string name;
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                name = _names[handle];
+            }
+
+            stream << name << "\n";
+            getAggregate(handle).getHistogram().write(stream);
+        }
+    }
+
+    Timer::Timer(const double &duration, std::shared_ptr<Clock> clock)
+    {
+        duration_ = duration;
+        clock_ = clock ? clock : Clock::getDefault();
+        start_time = clock_->now();
+    }
 
     void Timer::setDuration(const double &duration) { duration_ = duration; }
-    void Timer::start() { start_time = std::chrono::system_clock::now(); }
+    void Timer::start() { start_time = clock_->now(); }
 
     double Timer::currentDuration()
     {
-        auto end_time = std::chrono::system_clock::now();
+        auto end_time = clock_->now();
         std::chrono::duration<double> current_duration = end_time - start_time;
 
         return current_duration.count();
@@ -96,15 +339,62 @@ namespace RosTools
 
     void Instrumentor::BeginSession(const std::string &name, const std::string &filepath)
     {
+        if (m_CurrentSession != nullptr)
+            EndSession();
+
+        // The instance is never destroyed, end the session at exit instead
+        static std::once_flag exit_handler;
+        std::call_once(exit_handler, []()
+                       { std::atexit([]()
+                                     { Instrumentor::Get().EndSession(); }); });
+
         std::string full_filepath = getPackagePath(name) + filepath;
         LOG_VALUE("Profiling Path", full_filepath);
         m_OutputStream.open(full_filepath);
         WriteHeader();
         m_CurrentSession = new InstrumentationSession{name};
+
+        // Reset the drop counts of a previous session (its events were all drained when it ended)
+        {
+            std::lock_guard<std::mutex> lock(m_lock);
+            for (auto &buffer : m_Buffers)
+                buffer->dropped = 0;
+            m_RetiredDropped = 0;
+        }
+
+        // Start recording and draining
+        m_StopWriter = false;
+        m_Writer = std::thread(&Instrumentor::WriterLoop, this);
+        m_Active = true;
     }
 
     void Instrumentor::EndSession()
     {
+        if (m_CurrentSession == nullptr)
+            return;
+
+        // Threads that saw the session as active finish their event first, such that the last drain includes it
+        m_Active = false;
+        {
+            std::lock_guard<std::mutex> lock(m_lock);
+            for (auto &buffer : m_Buffers)
+            {
+                while (buffer->writing.load())
+                    std::this_thread::yield();
+            }
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_WriterLock);
+            m_StopWriter = true;
+        }
+        m_WriterCondition.notify_all();
+        m_Writer.join();
+
+        uint64_t dropped = Drain(); // Events that were recorded while stopping
+        if (dropped > 0)
+            LOG_WARN("Profiler dropped " << dropped << " events in this session (the per-thread trace buffers were full)");
+
         WriteFooter();
         m_OutputStream.close();
         delete m_CurrentSession;
@@ -112,27 +402,151 @@ namespace RosTools
         m_ProfileCount = 0;
     }
 
+    Instrumentor::ThreadBufferHolder::~ThreadBufferHolder()
+    {
+        if (buffer)
+            buffer->retired.store(true, std::memory_order_release);
+    }
+
+    Instrumentor::ThreadBuffer &Instrumentor::GetThreadBuffer()
+    {
+        thread_local ThreadBufferHolder holder;
+        if (holder.buffer == nullptr)
+        {
+            // Registered once per thread, the writer keeps it alive after the thread exits until it is drained
+            holder.buffer = std::make_shared<ThreadBuffer>();
+            std::lock_guard<std::mutex> lock(m_lock);
+            m_Buffers.push_back(holder.buffer);
+        }
+        return *holder.buffer;
+    }
+
     void Instrumentor::WriteProfile(const ProfileResult &result)
+    {
+        if (!m_Active)
+            return;
+
+        ThreadBuffer &buffer = GetThreadBuffer();
+
+        // Check again while marked as writing: either EndSession waits for this event or it is not recorded
+        buffer.writing.store(true);
+        if (!m_Active)
+        {
+            buffer.writing.store(false, std::memory_order_release);
+            return;
+        }
+
+        uint64_t head = buffer.head.load(std::memory_order_relaxed);
+        if (head - buffer.tail.load(std::memory_order_acquire) >= BUFFER_SIZE)
+        {
+            buffer.dropped.fetch_add(1, std::memory_order_relaxed);
+        }
+        else
+        {
+            buffer.events[head % BUFFER_SIZE] = result;
+            buffer.head.store(head + 1, std::memory_order_release);
+        }
+        buffer.writing.store(false, std::memory_order_release);
+    }
+
+    uint64_t Instrumentor::GetDroppedCount()
     {
         std::lock_guard<std::mutex> lock(m_lock);
 
-        if (m_ProfileCount++ > 0)
-            m_OutputStream << ",";
+        uint64_t dropped = m_RetiredDropped;
+        for (auto &buffer : m_Buffers)
+            dropped += buffer->dropped.load(std::memory_order_relaxed);
+        return dropped;
+    }
 
-        std::string name = result.Name;
-        std::replace(name.begin(), name.end(), '"', '\'');
+    size_t Instrumentor::GetThreadBufferCount()
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        return m_Buffers.size();
+    }
+
+    void Instrumentor::WriterLoop()
+    {
+        uint64_t reported_dropped = 0;
+
+        std::unique_lock<std::mutex> lock(m_WriterLock);
+        while (!m_StopWriter)
+        {
+            m_WriterCondition.wait_for(lock, std::chrono::milliseconds(20));
+
+            lock.unlock();
+            uint64_t dropped = Drain();
+            lock.lock();
+
+            if (dropped > reported_dropped)
+            {
+                LOG_WARN("Profiler dropped " << dropped - reported_dropped << " events (the per-thread trace buffers were full)");
+                reported_dropped = dropped;
+            }
+        }
+    }
 
-        m_OutputStream << "{";
-        m_OutputStream << "\"cat\":\"function\",";
-        m_OutputStream << "\"dur\":" << (result.End - result.Start) << ',';
-        m_OutputStream << "\"name\":\"" << name << "\",";
-        m_OutputStream << "\"ph\":\"X\",";
-        m_OutputStream << "\"pid\":0,";
-        m_OutputStream << "\"tid\":" << result.ThreadID << ",";
-        m_OutputStream << "\"ts\":" << result.Start;
-        m_OutputStream << "}";
+    uint64_t Instrumentor::Drain()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_lock);
+            m_DrainBuffers = m_Buffers;
+        }
+
+        for (auto &buffer : m_DrainBuffers)
+        {
+            uint64_t tail = buffer->tail.load(std::memory_order_relaxed);
+            uint64_t head = buffer->head.load(std::memory_order_acquire);
+
+            for (; tail < head; tail++)
+            {
+                const ProfileResult &result = buffer->events[tail % BUFFER_SIZE];
+
+                if (m_ProfileCount++ > 0)
+                    m_OutputStream << ",";
+
+                std::string name = result.Name;
+                std::replace(name.begin(), name.end(), '"', '\'');
+
+                m_OutputStream << "{";
+                m_OutputStream << "\"cat\":\"function\",";
+                m_OutputStream << "\"dur\":" << (result.End - result.Start) << ',';
+                m_OutputStream << "\"name\":\"" << name << "\",";
+                m_OutputStream << "\"ph\":\"X\",";
+                m_OutputStream << "\"pid\":0,";
+                m_OutputStream << "\"tid\":" << result.ThreadID << ",";
+                m_OutputStream << "\"ts\":" << result.Start;
+                if (result.HasCounters)
+                {
+                    m_OutputStream << ",\"args\":{";
+                    m_OutputStream << "\"cycles\":" << result.Counters.cycles << ",";
+                    m_OutputStream << "\"instructions\":" << result.Counters.instructions << ",";
+                    m_OutputStream << "\"llc_misses\":" << result.Counters.llc_misses << ",";
+                    m_OutputStream << "\"branch_misses\":" << result.Counters.branch_misses;
+                    m_OutputStream << "}";
+                }
+                m_OutputStream << "}";
+            }
+            buffer->tail.store(tail, std::memory_order_release);
+        }
+        m_DrainBuffers.clear();
+
+        // Release the buffers of exited threads that are drained, keeping their drop counts
+        {
+            std::lock_guard<std::mutex> lock(m_lock);
+            auto released = std::remove_if(m_Buffers.begin(), m_Buffers.end(), [&](const std::shared_ptr<ThreadBuffer> &buffer)
+                                           {
+                if (!buffer->retired.load(std::memory_order_acquire) ||
+                    buffer->tail.load(std::memory_order_relaxed) != buffer->head.load(std::memory_order_acquire))
+                    return false;
+
+                m_RetiredDropped += buffer->dropped.load(std::memory_order_relaxed);
+                return true; });
+            m_Buffers.erase(released, m_Buffers.end());
+        }
 
         m_OutputStream.flush();
+        return GetDroppedCount();
     }
 
     void Instrumentor::WriteHeader()
@@ -147,7 +561,11 @@ namespace RosTools
         m_OutputStream.flush();
     }
 
-    InstrumentationTimer::InstrumentationTimer(const char *name) : m_Name(name), m_Stopped(false) { m_StartTimepoint = std::chrono::system_clock::now(); }
+    InstrumentationTimer::InstrumentationTimer(const char *name) : m_Name(name), m_Stopped(false)
+    {
+        m_HasCounters = PerfCounters::sample(m_StartCounters);
+        m_StartTimepoint = Clock::getDefault()->now();
+    }
 
     InstrumentationTimer::~InstrumentationTimer()
     {
@@ -157,13 +575,25 @@ namespace RosTools
 
     void InstrumentationTimer::Stop()
     {
-        auto endTimepoint = std::chrono::system_clock::now();
+        auto endTimepoint = Clock::getDefault()->now();
+
+        ProfileResult result;
+        PerfSample end_counters;
+        if (m_HasCounters && PerfCounters::sample(end_counters))
+        {
+            result.Counters = end_counters - m_StartCounters;
+            result.HasCounters = result.Counters.isCounting();
+        }
 
         long long start = std::chrono::time_point_cast<std::chrono::microseconds>(m_StartTimepoint).time_since_epoch().count();
         long long end = std::chrono::time_point_cast<std::chrono::microseconds>(endTimepoint).time_since_epoch().count();
 
         uint32_t threadID = std::hash<std::thread::id>{}(std::this_thread::get_id());
-        Instrumentor::Get().WriteProfile({m_Name, start, end, threadID});
+        result.Name = m_Name;
+        result.Start = start;
+        result.End = end;
+        result.ThreadID = threadID;
+        Instrumentor::Get().WriteProfile(result);
 
         m_Stopped = true;
     }
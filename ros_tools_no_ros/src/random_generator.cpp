@@ -5,8 +5,15 @@
 namespace RosTools
 {
 
+    int RandomGenerator::default_seed_ = -1;
+
+    void RandomGenerator::setDefaultSeed(int seed) { default_seed_ = seed; }
+
     RandomGenerator::RandomGenerator(int seed)
     {
+        if (seed == -1)
+            seed = default_seed_;
+
         if (seed == -1)
         {
             rng_double_ = std::mt19937(std::random_device{}());   // Standard mersenne_twister_engine seeded with rd()
@@ -5,6 +5,8 @@
 #include <ros_tools/logging.h>
 #include <ros_tools/math.h>
 
+#include <limits>
+
 namespace RosTools
 {
 
@@ -19,6 +21,8 @@ namespace RosTools
 
         _x_spline.set_points(_t_vector, x);
         _y_spline.set_points(_t_vector, y);
+
+        initializeLookupTables();
     }
 
     /** @note a spline parameterized over another vector t*/
@@ -26,6 +30,8 @@ namespace RosTools
         : _x_spline(x), _y_spline(y), _t_vector(t_vector)
     {
         computeDistanceVector(_x_spline.m_y_, _y_spline.m_y_, _s_vector); // Compute distances
+
+        initializeLookupTables();
     }
 
     Spline2D::Spline2D(const std::vector<double> &x, const std::vector<double> &y, const std::vector<double> &t)
@@ -37,6 +43,8 @@ namespace RosTools
         // Initialize two splines for x and y
         _x_spline.set_points(_t_vector, x);
         _y_spline.set_points(_t_vector, y);
+
+        initializeLookupTables();
     }
 
     Eigen::Vector2d Spline2D::getPoint(double t) const
@@ -102,6 +110,46 @@ namespace RosTools
         return std::atan2(_y_spline.deriv(1, t), _x_spline.deriv(1, t));
     }
 
+    void Spline2D::getPoints(const std::vector<double> &t, std::vector<Eigen::Vector2d> &points,
+                             std::vector<Eigen::Vector2d> *velocities,
+                             std::vector<Eigen::Vector2d> *accelerations,
+                             std::vector<int> *segments) const
+    {
+        // Per thread workspace, such that repeated calls do not allocate
+        thread_local std::vector<int> segment_buffer;
+        thread_local std::vector<double> x, y, dx, dy, ddx, ddy;
+
+        // The x and y splines share their segments
+        _x_spline.find_segments(t, segment_buffer);
+        _x_spline.evaluate(t, segment_buffer, x, velocities ? &dx : nullptr, accelerations ? &ddx : nullptr);
+        _y_spline.evaluate(t, segment_buffer, y, velocities ? &dy : nullptr, accelerations ? &ddy : nullptr);
+
+        points.resize(t.size());
+        for (size_t i = 0; i < t.size(); i++)
+            points[i] = Eigen::Vector2d(x[i], y[i]);
+
+        if (velocities)
+        {
+            velocities->resize(t.size());
+            for (size_t i = 0; i < t.size(); i++)
+                (*velocities)[i] = Eigen::Vector2d(dx[i], dy[i]);
+        }
+
+        if (accelerations)
+        {
+            accelerations->resize(t.size());
+            for (size_t i = 0; i < t.size(); i++)
+                (*accelerations)[i] = Eigen::Vector2d(ddx[i], ddy[i]);
+        }
+
+        if (segments)
+        {
+            segments->resize(t.size());
+            for (size_t i = 0; i < t.size(); i++)
+                (*segments)[i] = std::min(segment_buffer[i], numSegments() - 1); // Beyond the end: the last segment
+        }
+    }
+
     // Compute distances between points
     void Spline2D::computeDistanceVector(const std::vector<double> &x, const std::vector<double> &y, std::vector<double> &out)
     {
@@ -149,31 +197,184 @@ namespace RosTools
             return _t_vector[segment_index];
     }
 
+    void Spline2D::initializeLookupTables()
+    {
+        int num_segments = numSegments();
+        if (num_segments < 1)
+            return;
+
+        // Segment lookup table with (on average) one entry per segment
+        _lut_step = std::max((_t_vector.back() - _t_vector[0]) / num_segments, 1e-9);
+        _segment_lut.resize(num_segments + 1);
+        int segment = 0;
+        for (size_t i = 0; i < _segment_lut.size(); i++)
+        {
+            double t = _t_vector[0] + i * _lut_step;
+            while (segment < num_segments - 1 && t >= _t_vector[segment + 1])
+                segment++;
+            _segment_lut[i] = segment;
+        }
+
+        // Bounding box of each segment, from its end points and the extrema of its cubic polynomials
+        _segment_boxes.resize(num_segments);
+        for (int i = 0; i < num_segments; i++)
+        {
+            double length = _t_vector[i + 1] - _t_vector[i];
+            Eigen::Vector2d start = getPoint(_t_vector[i]);
+            Eigen::Vector2d end = getPoint(_t_vector[i + 1]);
+            _segment_boxes[i].min = start.cwiseMin(end);
+            _segment_boxes[i].max = start.cwiseMax(end);
+
+            const tk::spline *splines[2] = {&_x_spline, &_y_spline};
+            for (int dim = 0; dim < 2; dim++)
+            {
+                double a, b, c, d;
+                splines[dim]->getParameters(i, a, b, c, d);
+
+                // Roots of the derivative 3a h^2 + 2b h + c
+                double roots[2];
+                int num_roots = 0;
+                if (std::abs(a) < 1e-12)
+                {
+                    if (std::abs(b) > 1e-12)
+                        roots[num_roots++] = -c / (2. * b);
+                }
+                else
+                {
+                    double discriminant = 4. * b * b - 12. * a * c;
+                    if (discriminant >= 0.)
+                    {
+                        roots[num_roots++] = (-2. * b + std::sqrt(discriminant)) / (6. * a);
+                        roots[num_roots++] = (-2. * b - std::sqrt(discriminant)) / (6. * a);
+                    }
+                }
+
+                for (int r = 0; r < num_roots; r++)
+                {
+                    double h = roots[r];
+                    if (h <= 0. || h >= length)
+                        continue;
+
+                    double value = ((a * h + b) * h + c) * h + d;
+                    _segment_boxes[i].min(dim) = std::min(_segment_boxes[i].min(dim), value);
+                    _segment_boxes[i].max(dim) = std::max(_segment_boxes[i].max(dim), value);
+                }
+            }
+        }
+    }
+
+    int Spline2D::findSegment(double t) const
+    {
+        int num_segments = numSegments();
+        if (t <= _t_vector[0])
+            return 0;
+
+        int lut_index = std::min((int)((t - _t_vector[0]) / _lut_step), (int)_segment_lut.size() - 1);
+        int segment = _segment_lut[lut_index];
+        while (segment < num_segments - 1 && t >= _t_vector[segment + 1])
+            segment++;
+        return segment;
+    }
+
+    double Spline2D::findClosestOnSegment(const Eigen::Vector2d &point, int segment_index, double &dist_squared_out) const
+    {
+        double ax, bx, cx, dx, ay, by, cy, dy;
+        getParameters(segment_index, ax, bx, cx, dx, ay, by, cy, dy);
+        double length = _t_vector[segment_index + 1] - _t_vector[segment_index];
+
+        // Squared distance and its first two derivatives with respect to h = t - t_segment (up to a factor 2)
+        auto evaluate = [&](double h, double &gradient, double &hessian)
+        {
+            Eigen::Vector2d p(((ax * h + bx) * h + cx) * h + dx, ((ay * h + by) * h + cy) * h + dy);
+            Eigen::Vector2d v(((3. * ax * h + 2. * bx) * h + cx), ((3. * ay * h + 2. * by) * h + cy));
+            Eigen::Vector2d a(6. * ax * h + 2. * bx, 6. * ay * h + 2. * by);
+
+            Eigen::Vector2d diff = p - point;
+            gradient = diff.dot(v);
+            hessian = v.dot(v) + diff.dot(a);
+            return diff.squaredNorm();
+        };
+
+        double best_h = 0.;
+        dist_squared_out = std::numeric_limits<double>::infinity();
+
+        // Newton iterations from the start, middle and end of the segment (the squared distance to a cubic is not convex)
+        for (double h : {0., 0.5 * length, length})
+        {
+            double gradient, hessian;
+            double dist_squared = evaluate(h, gradient, hessian);
+            for (int iteration = 0; iteration < 8; iteration++)
+            {
+                double step = hessian > 1e-12 ? -gradient / hessian : -gradient; // Gradient step where the problem is not convex
+                double new_h = std::max(0., std::min(h + step, length));
+                if (std::abs(new_h - h) < 1e-10)
+                    break;
+
+                double new_gradient, new_hessian;
+                double new_dist_squared = evaluate(new_h, new_gradient, new_hessian);
+                if (new_dist_squared > dist_squared) // Only accept descending steps
+                    break;
+
+                h = new_h;
+                dist_squared = new_dist_squared;
+                gradient = new_gradient;
+                hessian = new_hessian;
+            }
+
+            if (dist_squared < dist_squared_out)
+            {
+                dist_squared_out = dist_squared;
+                best_h = h;
+            }
+        }
+
+        return _t_vector[segment_index] + best_h;
+    }
+
     void Spline2D::initializeClosestPoint(const Eigen::Vector2d &point, int &segment_out, double &t_out)
     {
-        // Computes the distance between point "s" on the spline and a vehicle position
-        auto dist_to_spline = [&](double t, const Eigen::Vector2d &point)
+        int num_segments = numSegments();
+        ROSTOOLS_ASSERT(num_segments > 0, "Could not find a closest point on the spline");
+
+        // Lower bound on the squared distance to each segment from its bounding box
+        auto box_distance = [&](int i)
         {
-            return RosTools::distance(getPoint(t), point);
+            Eigen::Vector2d outside = (_segment_boxes[i].min - point).cwiseMax(point - _segment_boxes[i].max).cwiseMax(0.);
+            return outside.squaredNorm();
         };
 
-        double min_dist = 1e9;
-        int local_segment_out = -1;
-        double local_t_out = -1.;
-        for (size_t i = 0; i < _t_vector.size() - 1; i++)
+        // Start with the most promising segment, then only refine segments that may contain a closer point
+        int first_segment = 0;
+        double min_box_distance = box_distance(0);
+        for (int i = 1; i < num_segments; i++)
         {
-            double cur_t = findClosestSRecursively(point, _t_vector[i], _t_vector[i + 1], 10); // Closest in this segment
+            double cur_box_distance = box_distance(i);
+            if (cur_box_distance < min_box_distance)
+            {
+                min_box_distance = cur_box_distance;
+                first_segment = i;
+            }
+        }
 
-            double cur_dist = dist_to_spline(cur_t, point);
-            if (cur_dist < min_dist)
+        double min_dist_squared;
+        int local_segment_out = first_segment;
+        double local_t_out = findClosestOnSegment(point, first_segment, min_dist_squared);
+
+        for (int i = 0; i < num_segments; i++)
+        {
+            if (i == first_segment || box_distance(i) >= min_dist_squared)
+                continue;
+
+            double cur_dist_squared;
+            double cur_t = findClosestOnSegment(point, i, cur_dist_squared);
+            if (cur_dist_squared < min_dist_squared)
             {
-                min_dist = cur_dist;
+                min_dist_squared = cur_dist_squared;
                 local_t_out = cur_t;
                 local_segment_out = i;
             }
         }
 
-        ROSTOOLS_ASSERT(local_segment_out != -1, "Could not find a closest point on the spline");
         segment_out = local_segment_out;
         t_out = local_t_out;
         _closest_segment = segment_out;
@@ -182,9 +383,8 @@ namespace RosTools
     // Find the distance that we travelled on the spline
     void Spline2D::findClosestPoint(const Eigen::Vector2d &point, int &segment_out, double &t_out, int range)
     {
-        if (_closest_segment == -1 || RosTools::distance(_prev_query_point, point) > 5.) // Non-initialized
+        if (_closest_segment == -1 || RosTools::distance(_prev_query_point, point) > 5.) // Non-initialized or jumped
         {
-            // LOG_INFO("Initialize Closest Point");
             initializeClosestPoint(point, segment_out, t_out);
             _prev_query_point = point;
 
@@ -192,59 +392,24 @@ namespace RosTools
         }
         _prev_query_point = point;
 
+        // Search locally: a fixed number of segments around the previous closest point
         int first_segment = std::max(0, _closest_segment - range);
-        int last_segment = std::min((int)_t_vector.size() - 1, _closest_segment + range);
+        int last_segment = std::min(numSegments() - 1, _closest_segment + range);
 
-        // Search locally
-        t_out = findClosestSRecursively(point,
-                                        _t_vector[first_segment],
-                                        _t_vector[last_segment], 0);
-        // LOG_INFO("Recursive search between " << _t_vector[first_segment] << " and " << _t_vector[last_segment] << ": " << t_out);
-
-        for (int i = first_segment; i < last_segment; i++)
+        double min_dist_squared = std::numeric_limits<double>::infinity();
+        for (int i = first_segment; i <= last_segment; i++)
         {
-            if (t_out > _t_vector[i] && t_out < _t_vector[i + 1])
+            double cur_dist_squared;
+            double cur_t = findClosestOnSegment(point, i, cur_dist_squared);
+            if (cur_dist_squared < min_dist_squared)
             {
-                segment_out = i; // Find the index to match the spline variable computed
-                _closest_segment = segment_out;
-
-                return;
+                min_dist_squared = cur_dist_squared;
+                t_out = cur_t;
+                segment_out = i;
             }
         }
 
         _closest_segment = segment_out;
-        segment_out = last_segment;
-    }
-
-    double Spline2D::findClosestSRecursively(const Eigen::Vector2d &point, double low, double high, int num_recursions) const
-    {
-        if (std::abs(high - low) <= 1e-4 || num_recursions > 40)
-        {
-            if (num_recursions > 40)
-                LOG_WARN_THROTTLE(1500, "Recursion count exceeded.");
-
-            // LOG_INFO("Difference between " << high << " and " << low << " < 1e-4. Returning " << (low + high) / 2.);
-            return (low + high) / 2.;
-        }
-
-        // Computes the distance between point "s" on the spline and a vehicle position
-        auto dist_to_spline = [&](double t, const Eigen::Vector2d &point)
-        {
-            return RosTools::distance(getPoint(t), point);
-        };
-
-        // Compute a middle s value
-        double mid = (low + high) / 2.;
-
-        // Compute the distance to the spline for high/low
-        double value_low = dist_to_spline(low, point);
-        double value_high = dist_to_spline(high, point);
-
-        // Check the next closest value
-        if (value_low < value_high)
-            return findClosestSRecursively(point, low, mid, num_recursions + 1);
-        else
-            return findClosestSRecursively(point, mid, high, num_recursions + 1);
     }
 
     void Spline2D::samplePoints(std::vector<Eigen::Vector2d> &points, double ds) const
@@ -0,0 +1,143 @@
+#include "ros_tools/spline_window.h"
+
+#include <ros_tools/math.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace RosTools
+{
+    Spline2DWindow::Spline2DWindow(double look_behind, double look_ahead, int min_segments_ahead)
+        : _look_behind(look_behind), _look_ahead(look_ahead), _min_segments_ahead(min_segments_ahead)
+    {
+    }
+
+    void Spline2DWindow::setPath(const std::vector<double> &x, const std::vector<double> &y, const std::vector<double> &s)
+    {
+        _x = x;
+        _y = y;
+
+        if (s.empty())
+        {
+            // Parameterize by the distance between points
+            _s.resize(x.size());
+            _s[0] = 0.;
+            for (size_t i = 1; i < x.size(); i++)
+                _s[i] = _s[i - 1] + std::sqrt(std::pow(x[i] - x[i - 1], 2.) + std::pow(y[i] - y[i - 1], 2.));
+        }
+        else
+        {
+            _s = s;
+        }
+
+        _spline.reset();
+        _first = 0;
+        _last = -1;
+    }
+
+    void Spline2DWindow::clear()
+    {
+        _x.clear();
+        _y.clear();
+        _s.clear();
+
+        _spline.reset();
+        _first = 0;
+        _last = -1;
+    }
+
+    bool Spline2DWindow::findClosestPoint(const Eigen::Vector2d &point, int &segment_out, double &s_out)
+    {
+        bool moved = false;
+
+        // Non-initialized or jumped: place the window around the closest path point
+        if (_spline == nullptr || RosTools::distance(_prev_query_point, point) > 5.)
+        {
+            int closest = 0;
+            double min_dist_squared = std::numeric_limits<double>::infinity();
+            for (int i = 0; i < numPoints(); i++)
+            {
+                double dist_squared = std::pow(_x[i] - point(0), 2.) + std::pow(_y[i] - point(1), 2.);
+                if (dist_squared < min_dist_squared)
+                {
+                    min_dist_squared = dist_squared;
+                    closest = i;
+                }
+            }
+
+            moved = update(_s[closest]);
+        }
+        _prev_query_point = point;
+
+        _spline->findClosestPoint(point, segment_out, s_out);
+
+        // Slide the window along if the robot progressed
+        if (update(s_out))
+        {
+            moved = true;
+            _spline->findClosestPoint(point, segment_out, s_out);
+        }
+
+        return moved;
+    }
+
+    bool Spline2DWindow::update(double s)
+    {
+        if (empty() || !needsUpdate(s))
+            return false;
+
+        fitWindow(s);
+        return true;
+    }
+
+    int Spline2DWindow::findPathSegment(double s) const
+    {
+        int index = (int)(std::upper_bound(_s.begin(), _s.end(), s) - _s.begin()) - 1;
+        return std::max(0, std::min(index, numPoints() - 2));
+    }
+
+    std::vector<double> Spline2DWindow::getWindowValues(const std::vector<double> &values) const
+    {
+        return std::vector<double>(values.begin() + _first, values.begin() + _last + 1);
+    }
+
+    bool Spline2DWindow::needsUpdate(double s) const
+    {
+        if (_spline == nullptr)
+            return true;
+
+        // Moved back close to the start of the window
+        if (_first > 0 && s - _s[_first] < 0.5 * _look_behind)
+            return true;
+
+        // Running out of look-ahead
+        if (!coversEnd() && (_s[_last] - s < 0.5 * _look_ahead || _last - findPathSegment(s) < _min_segments_ahead))
+            return true;
+
+        return false;
+    }
+
+    void Spline2DWindow::fitWindow(double s)
+    {
+        int last_point = numPoints() - 1;
+        int current = findPathSegment(s);
+
+        _first = findPathSegment(s - _look_behind);
+
+        _last = (int)(std::lower_bound(_s.begin(), _s.end(), s + _look_ahead) - _s.begin());
+        _last = std::max(_last, current + 1 + 2 * _min_segments_ahead); // Hysteresis on the number of segments ahead
+        _last = std::min(_last, last_point);
+
+        // A cubic spline needs at least three points
+        while (_last - _first < 2 && (_first > 0 || _last < last_point))
+        {
+            if (_last < last_point)
+                _last++;
+            else
+                _first--;
+        }
+
+        _spline = std::make_shared<Spline2D>(getWindowValues(_x), getWindowValues(_y), getWindowValues(_s));
+    }
+}
@@ -392,4 +392,60 @@ namespace tk
         }
         return interpol;
     }
+    void spline::find_segments(const std::vector<double> &x, std::vector<int> &segments) const
+    {
+        int n = m_x.size();
+        segments.resize(x.size());
+
+        // Same segment as operator(): m_x[idx] < x <= m_x[idx + 1], idx = 0 left of the spline, idx = n - 1 right of it
+        int idx = 0;
+        for (size_t i = 0; i < x.size(); i++)
+        {
+            while (idx < n - 1 && m_x[idx + 1] < x[i])
+                idx++;
+            while (idx > 0 && m_x[idx] >= x[i]) // Only if x is not sorted
+                idx--;
+
+            segments[i] = idx;
+        }
+    }
+
+    void spline::evaluate(const std::vector<double> &x, const std::vector<int> &segments, std::vector<double> &y,
+                          std::vector<double> *dy, std::vector<double> *ddy) const
+    {
+        assert(segments.size() == x.size());
+
+        size_t count = x.size();
+        y.resize(count);
+        if (dy)
+            dy->resize(count);
+        if (ddy)
+            ddy->resize(count);
+
+        for (size_t i = 0; i < count; i++)
+        {
+            int idx = segments[i];
+            double h = x[i] - m_x[idx];
+
+            // Left of the spline, extrapolate with the (quadratic) left boundary polynomial
+            bool left = h < 0.;
+            double a = left ? 0. : m_a[idx];
+            double b = left ? m_b0 : m_b[idx];
+            double c = left ? m_c0 : m_c[idx];
+
+            y[i] = ((a * h + b) * h + c) * h + m_y[idx];
+            if (dy)
+                (*dy)[i] = (3.0 * a * h + 2.0 * b) * h + c;
+            if (ddy)
+                (*ddy)[i] = 6.0 * a * h + 2.0 * b;
+        }
+    }
+
+    void spline::evaluate(const std::vector<double> &x, std::vector<double> &y,
+                          std::vector<double> *dy, std::vector<double> *ddy) const
+    {
+        std::vector<int> segments;
+        find_segments(x, segments);
+        evaluate(x, segments, y, dy, ddy);
+    }
 }
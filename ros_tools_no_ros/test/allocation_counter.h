@@ -0,0 +1,137 @@
+/** Counts heap allocations of all threads, include in exactly one translation unit of a test executable (it defines malloc) */
+#ifndef ROS_TOOLS_TEST_ALLOCATION_COUNTER_H
+#define ROS_TOOLS_TEST_ALLOCATION_COUNTER_H
+
+#include <execinfo.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdlib>
+#include <functional>
+#include <string>
+
+// Allocation counting on all threads (also the OpenMP workers of the code under test). malloc is interposed (operator
+// new, Eigen and the containers all end up here) and forwards to glibc. Only allocations while tracking is on are
+// counted, the first call sites are recorded.
+extern "C"
+{
+    void *__libc_malloc(size_t size);
+    void *__libc_calloc(size_t num, size_t size);
+    void *__libc_realloc(void *ptr, size_t size);
+    void *__libc_memalign(size_t alignment, size_t size);
+    void __libc_free(void *ptr);
+}
+
+namespace
+{
+    constexpr int MAX_SITES = 4;
+    constexpr int MAX_FRAMES = 12;
+
+    struct AllocationCounter
+    {
+        std::atomic<bool> tracking{false};
+        std::atomic<int> count{0};
+
+        std::atomic<int> num_sites{0}; // Claimed slots, may exceed MAX_SITES
+        void *frames[MAX_SITES][MAX_FRAMES];
+        int num_frames[MAX_SITES];
+    };
+
+    AllocationCounter counter;
+    thread_local bool in_hook = false; // backtrace() may allocate itself
+
+    void recordAllocation()
+    {
+        if (!counter.tracking.load(std::memory_order_relaxed) || in_hook)
+            return;
+
+        in_hook = true;
+        counter.count.fetch_add(1, std::memory_order_relaxed);
+        int site = counter.num_sites.fetch_add(1, std::memory_order_relaxed);
+        if (site < MAX_SITES)
+            counter.num_frames[site] = backtrace(counter.frames[site], MAX_FRAMES);
+        in_hook = false;
+    }
+}
+
+/** @brief Stops counting while in scope, e.g., to prepare the inputs of a measured cycle (no other thread should run) */
+class UntrackedScope
+{
+public:
+    UntrackedScope() : tracking_(counter.tracking.exchange(false)) {}
+    ~UntrackedScope() { counter.tracking.store(tracking_); }
+
+private:
+    bool tracking_;
+};
+
+extern "C"
+{
+    void *malloc(size_t size)
+    {
+        recordAllocation();
+        return __libc_malloc(size);
+    }
+
+    void *calloc(size_t num, size_t size)
+    {
+        recordAllocation();
+        return __libc_calloc(num, size);
+    }
+
+    void *realloc(void *ptr, size_t size)
+    {
+        recordAllocation();
+        return __libc_realloc(ptr, size);
+    }
+
+    int posix_memalign(void **ptr, size_t alignment, size_t size)
+    {
+        recordAllocation();
+        *ptr = __libc_memalign(alignment, size);
+        return *ptr == nullptr ? ENOMEM : 0;
+    }
+
+    void *aligned_alloc(size_t alignment, size_t size)
+    {
+        recordAllocation();
+        return __libc_memalign(alignment, size);
+    }
+
+    void free(void *ptr)
+    {
+        __libc_free(ptr);
+    }
+}
+
+/**
+ * @brief Run `cycle` for warm-up cycles, then count the allocations of all threads during the measured cycles. Threads
+ * started by `cycle` must have finished when it returns, such that their call sites are complete
+ */
+static int CountAllocations(const std::function<void(int)> &cycle, int warm_up, int cycles, std::string &report)
+{
+    for (int i = 0; i < warm_up; i++)
+        cycle(i);
+
+    counter.count = 0;
+    counter.num_sites = 0;
+    counter.tracking = true;
+    for (int i = warm_up; i < warm_up + cycles; i++)
+        cycle(i);
+    counter.tracking = false;
+
+    report.clear();
+    for (int site = 0; site < std::min(counter.num_sites.load(), MAX_SITES); site++)
+    {
+        char **symbols = backtrace_symbols(counter.frames[site], counter.num_frames[site]);
+        report += "Allocation " + std::to_string(site) + ":\n";
+        for (int frame = 1; frame < counter.num_frames[site]; frame++) // Skip recordAllocation
+            report += std::string("  ") + (symbols == nullptr ? "?" : symbols[frame]) + "\n";
+        std::free(symbols);
+    }
+
+    return counter.count;
+}
+
+#endif // ROS_TOOLS_TEST_ALLOCATION_COUNTER_H
@@ -0,0 +1,49 @@
+/** Microbenchmark: vectorized obstacle linearization kernels against the scalar per-stage loop */
+#include "linearization_reference.h"
+
+#include <ros_tools/profiling.h>
+
+#include <iostream>
+
+using namespace RosTools;
+
+int main()
+{
+    const int num_stages = 30;
+    const int repetitions = 2000;
+    std::mt19937 rng(1);
+
+    for (int num_obstacles : {4, 12, 32})
+    {
+        ObstacleBlock obstacles;
+        Eigen::ArrayXd x, y;
+        FillRandomScenario(obstacles, x, y, num_stages, num_obstacles, rng);
+
+        HalfspaceBlock halfspaces;
+        halfspaces.resize(num_stages, num_obstacles);
+
+        Benchmarker scalar("scalar loop (" + std::to_string(num_obstacles) + " obstacles)");
+        Benchmarker kernel("kernel (" + std::to_string(num_obstacles) + " obstacles)");
+
+        for (int i = 0; i < repetitions; i++)
+        {
+            Eigen::ArrayXd x_copy = x, y_copy = y;
+            scalar.start();
+            ReferenceLinearization(obstacles, 0.325, x_copy, y_copy, halfspaces);
+            scalar.stop();
+
+            x_copy = x;
+            y_copy = y;
+            kernel.start();
+            projectToSafety(obstacles, 0.325, 3, x_copy, y_copy);
+            linearizeObstacles(obstacles, 0.325, x_copy, y_copy, halfspaces);
+            kernel.stop();
+        }
+
+        scalar.print();
+        kernel.print();
+        std::cout << "speedup: " << scalar.getTotalDuration() / kernel.getTotalDuration() << "x" << std::endl;
+    }
+
+    return 0;
+}
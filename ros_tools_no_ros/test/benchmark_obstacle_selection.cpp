@@ -0,0 +1,102 @@
+/** Microbenchmark: partial top-K obstacle selection against a full sort, and the selection quality of each risk metric */
+#include <ros_tools/obstacle_selection.h>
+#include <ros_tools/profiling.h>
+
+#include <algorithm>
+#include <iostream>
+#include <random>
+
+using namespace RosTools;
+
+// A crowd of constant velocity obstacles around a robot that drives along the x-axis
+static void FillCrowd(ObstacleBlock &obstacles, Eigen::ArrayXd &robot_x, Eigen::ArrayXd &robot_y,
+                      int num_stages, int num_obstacles, double dt, std::mt19937 &rng)
+{
+    std::uniform_real_distribution<double> position(-30., 30.), velocity(-2., 2.), radius(0.3, 0.6);
+
+    obstacles.resize(num_stages, num_obstacles);
+    for (int o = 0; o < num_obstacles; o++)
+    {
+        obstacles.radius(o) = radius(rng);
+        double x = position(rng), y = position(rng), vx = velocity(rng), vy = velocity(rng);
+        for (int k = 0; k < num_stages; k++)
+        {
+            obstacles.x(k, o) = x + vx * k * dt;
+            obstacles.y(k, o) = y + vy * k * dt;
+        }
+    }
+
+    robot_x = 1.5 * dt * Eigen::ArrayXd::LinSpaced(num_stages, 0., num_stages - 1);
+    robot_y = Eigen::ArrayXd::Zero(num_stages);
+}
+
+int main()
+{
+    const int num_stages = 30;
+    const int max_obstacles = 100;
+    const double dt = 0.2;
+    const double robot_radius = 0.325;
+    const int repetitions = 200;
+    std::mt19937 rng(1);
+
+    for (int num_obstacles : {200, 1000, 5000, 20000})
+    {
+        ObstacleBlock obstacles;
+        Eigen::ArrayXd robot_x, robot_y;
+        FillCrowd(obstacles, robot_x, robot_y, num_stages, num_obstacles, dt, rng);
+
+        std::vector<ObstacleRisk> risks, risks_copy;
+        std::vector<int> selected;
+
+        Benchmarker metric("risk metric (" + std::to_string(num_obstacles) + " obstacles)");
+        Benchmarker full_sort("full sort (" + std::to_string(num_obstacles) + " obstacles)");
+        Benchmarker partial("nth_element (" + std::to_string(num_obstacles) + " obstacles)");
+
+        for (int i = 0; i < repetitions; i++)
+        {
+            metric.start();
+            computeObstacleRisks(obstacles, robot_x, robot_y, robot_radius, dt, RiskMetric::TIME_TO_COLLISION, risks);
+            metric.stop();
+
+            risks_copy = risks;
+            full_sort.start();
+            std::sort(risks_copy.begin(), risks_copy.end());
+            full_sort.stop();
+
+            risks_copy = risks;
+            partial.start();
+            selectCriticalObstacles(risks_copy, max_obstacles, selected);
+            partial.stop();
+        }
+
+        metric.print();
+        full_sort.print();
+        partial.print();
+        std::cout << "selection speedup: " << full_sort.getTotalDuration() / partial.getTotalDuration() << "x" << std::endl;
+
+        // Quality: how many of the obstacles that collide with the robot within the horizon are kept by each metric
+        computeObstacleRisks(obstacles, robot_x, robot_y, robot_radius, dt, RiskMetric::MIN_DISTANCE, risks);
+        int num_colliding = std::count_if(risks.begin(), risks.end(), [](const ObstacleRisk &risk)
+                                          { return risk.clearance <= 0.; });
+
+        std::vector<std::pair<std::string, RiskMetric>> metrics = {{"weighted_distance", RiskMetric::WEIGHTED_DISTANCE},
+                                                                   {"min_distance", RiskMetric::MIN_DISTANCE},
+                                                                   {"time_to_collision", RiskMetric::TIME_TO_COLLISION}};
+        for (auto &named_metric : metrics)
+        {
+            computeObstacleRisks(obstacles, robot_x, robot_y, robot_radius, dt, named_metric.second, risks);
+            std::vector<double> clearances(num_obstacles);
+            for (auto &risk : risks)
+                clearances[risk.index] = risk.clearance;
+
+            selectCriticalObstacles(risks, max_obstacles, selected);
+            int kept = std::count_if(selected.begin(), selected.end(), [&](int index)
+                                     { return clearances[index] <= 0.; });
+
+            std::cout << "  " << named_metric.first << ": kept " << kept << " / " << std::min(num_colliding, max_obstacles)
+                      << " colliding obstacles" << std::endl;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,69 @@
+#ifndef ros_tools_TEST_LINEARIZATION_REFERENCE_H
+#define ros_tools_TEST_LINEARIZATION_REFERENCE_H
+
+#include <ros_tools/linearization.h>
+#include <ros_tools/projection.h>
+
+#include <random>
+
+/** @brief Random obstacles and positions around the origin over num_stages stages */
+inline void FillRandomScenario(RosTools::ObstacleBlock &obstacles, Eigen::ArrayXd &x, Eigen::ArrayXd &y,
+                               int num_stages, int num_obstacles, std::mt19937 &rng)
+{
+    std::uniform_real_distribution<double> position(-5., 5.), radius(0.3, 1.);
+
+    obstacles.resize(num_stages, num_obstacles);
+    for (int o = 0; o < num_obstacles; o++)
+    {
+        obstacles.radius(o) = radius(rng);
+        for (int k = 0; k < num_stages; k++)
+        {
+            obstacles.x(k, o) = position(rng);
+            obstacles.y(k, o) = position(rng);
+        }
+    }
+
+    x.resize(num_stages);
+    y.resize(num_stages);
+    for (int k = 0; k < num_stages; k++)
+    {
+        x(k) = position(rng);
+        y(k) = position(rng);
+    }
+}
+
+/** @brief The scalar loop the kernels replace: per stage, project with DouglasRachford, then linearize one obstacle at a time */
+inline void ReferenceLinearization(const RosTools::ObstacleBlock &obstacles, double extra_radius,
+                                   Eigen::ArrayXd &x, Eigen::ArrayXd &y, RosTools::HalfspaceBlock &halfspaces)
+{
+    MPCPlanner::DouglasRachford dr_projection;
+
+    for (int k = 0; k < x.size(); k++)
+    {
+        Eigen::Vector2d pos(x(k), y(k));
+        Eigen::Vector2d anchor(obstacles.x(k, 0), obstacles.y(k, 0));
+
+        for (int iterate = 0; iterate < 3; iterate++)
+        {
+            for (int o = 0; o < obstacles.numObstacles(); o++)
+                dr_projection.douglasRachfordProjection(pos, Eigen::Vector2d(obstacles.x(k, o), obstacles.y(k, o)), anchor,
+                                                        obstacles.radius(o) + extra_radius, pos);
+        }
+
+        for (int o = 0; o < obstacles.numObstacles(); o++)
+        {
+            Eigen::Vector2d obstacle_pos(obstacles.x(k, o), obstacles.y(k, o));
+            double dist = (obstacle_pos - pos).norm();
+
+            halfspaces.a1(k, o) = (obstacle_pos(0) - pos(0)) / dist;
+            halfspaces.a2(k, o) = (obstacle_pos(1) - pos(1)) / dist;
+            halfspaces.b(k, o) = halfspaces.a1(k, o) * obstacle_pos(0) + halfspaces.a2(k, o) * obstacle_pos(1) -
+                                 (obstacles.radius(o) + extra_radius);
+        }
+
+        x(k) = pos(0);
+        y(k) = pos(1);
+    }
+}
+
+#endif // ros_tools_TEST_LINEARIZATION_REFERENCE_H
@@ -0,0 +1,247 @@
+/** Checks that the per-cycle planning kernels do not allocate on the heap once they are warmed up */
+#include <gtest/gtest.h>
+
+#include <ros_tools/data_recorder.h>
+#include <ros_tools/linearization.h>
+#include <ros_tools/obstacle_selection.h>
+#include <ros_tools/profiling.h>
+#include <ros_tools/spline.h>
+#include <ros_tools/spline_window.h>
+
+#include "allocation_counter.h"
+
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace RosTools;
+
+// Obstacles moving with constant velocity around a robot that drives along the x-axis
+static void FillScenario(ObstacleBlock &obstacles, Eigen::ArrayXd &x, Eigen::ArrayXd &y, int num_stages, int num_obstacles, double dt)
+{
+    obstacles.resize(num_stages, num_obstacles);
+    for (int o = 0; o < num_obstacles; o++)
+    {
+        obstacles.radius(o) = 0.4;
+        for (int k = 0; k < num_stages; k++)
+        {
+            obstacles.x(k, o) = 2. * o + std::cos(o) * k * dt;
+            obstacles.y(k, o) = 3. * std::sin(o) + std::sin(o) * k * dt;
+        }
+    }
+
+    x = 1.5 * dt * Eigen::ArrayXd::LinSpaced(num_stages, 0., num_stages - 1);
+    y = Eigen::ArrayXd::Zero(num_stages);
+}
+
+TEST(AllocationTest, CounterDetectsAllocations)
+{
+    std::string report;
+    int allocations = CountAllocations([](int i)
+                                       { std::vector<double> values(10 + i);
+                                         EXPECT_EQ(values.size(), 10 + i); },
+                                       0, 3, report);
+    EXPECT_EQ(allocations, 3);
+    EXPECT_FALSE(report.empty());
+}
+
+TEST(AllocationTest, CounterDetectsAllocationsOnOtherThreads)
+{
+    // The worker is started before measuring and allocates during the measured cycle
+    std::atomic<bool> go{false}, done{false};
+    std::vector<double> *values = nullptr;
+    std::thread worker([&]()
+                       {
+        while (!go.load())
+            std::this_thread::yield();
+        values = new std::vector<double>(10); // The vector and its storage
+        done = true; });
+
+    std::string report;
+    int allocations = CountAllocations([&](int)
+                                       {
+        go = true;
+        while (!done.load())
+            std::this_thread::yield(); },
+                                       0, 1, report);
+    worker.join();
+    delete values;
+
+    EXPECT_EQ(allocations, 2);
+    EXPECT_FALSE(report.empty());
+}
+
+TEST(AllocationTest, SplineEvaluationDoesNotAllocate)
+{
+    std::vector<double> x, y;
+    for (int i = 0; i < 40; i++)
+    {
+        x.push_back(i);
+        y.push_back(std::sin(0.3 * i));
+    }
+    Spline2D spline(x, y);
+
+    std::vector<double> t(30);
+    std::vector<Eigen::Vector2d> points, velocities;
+    int segment;
+    double s;
+
+    std::string report;
+    int allocations = CountAllocations([&](int i)
+                                       {
+        Eigen::Vector2d robot(0.1 * i, 0.5);
+        spline.findClosestPoint(robot, segment, s);
+
+        for (size_t k = 0; k < t.size(); k++)
+            t[k] = s + 0.5 * k;
+        spline.getPoints(t, points, &velocities); },
+                                       5, 50, report);
+    EXPECT_EQ(allocations, 0) << report;
+}
+
+TEST(AllocationTest, SplineWindowDoesNotAllocateWithoutRefit)
+{
+    std::vector<double> x, y;
+    for (int i = 0; i < 200; i++)
+    {
+        x.push_back(i);
+        y.push_back(0.);
+    }
+    Spline2DWindow window(5., 30.);
+    window.setPath(x, y);
+
+    int segment;
+    double s;
+
+    // Moving 5 cm per cycle, such that the window is not refit while measuring
+    std::string report;
+    int allocations = CountAllocations([&](int i)
+                                       { window.findClosestPoint(Eigen::Vector2d(10. + 0.05 * i, 0.2), segment, s); },
+                                       5, 50, report);
+    EXPECT_EQ(allocations, 0) << report;
+}
+
+TEST(AllocationTest, ObstacleKernelsDoNotAllocate)
+{
+    const int num_stages = 30;
+    const double dt = 0.2;
+
+    ObstacleBlock obstacles;
+    Eigen::ArrayXd robot_x, robot_y;
+    FillScenario(obstacles, robot_x, robot_y, num_stages, 40, dt);
+
+    Eigen::ArrayXd x(num_stages), y(num_stages);
+    HalfspaceBlock halfspaces;
+    halfspaces.resize(num_stages, 40);
+
+    std::vector<ObstacleRisk> risks;
+    std::vector<int> selected;
+
+    std::string report;
+    int allocations = CountAllocations([&](int i)
+                                       {
+        (void)i;
+        computeObstacleRisks(obstacles, robot_x, robot_y, 0.325, dt, RiskMetric::TIME_TO_COLLISION, risks);
+        selectCriticalObstacles(risks, 12, selected);
+
+        x = robot_x;
+        y = robot_y;
+        projectToSafety(obstacles, 0.325, 3, x, y);
+        linearizeObstacles(obstacles, 0.325, x, y, halfspaces); },
+                                       5, 50, report);
+    EXPECT_EQ(allocations, 0) << report;
+}
+
+TEST(AllocationTest, ParallelPlannersDoNotAllocate)
+{
+    // As in the parallel guidance planners: each thread runs its own kernels, all threads are counted. The threads are
+    // started (and warmed up) before measuring and then run one cycle per measured cycle
+    const int num_threads = 8;
+    std::atomic<int> cycles_started{0}, cycles_done{0};
+    std::atomic<bool> stop{false};
+
+    std::vector<std::thread> threads;
+    for (int thread = 0; thread < num_threads; thread++)
+    {
+        threads.emplace_back([&, thread]()
+                             {
+            ObstacleBlock obstacles;
+            Eigen::ArrayXd robot_x, robot_y;
+            FillScenario(obstacles, robot_x, robot_y, 30, 20 + thread, 0.2);
+
+            std::vector<ObstacleRisk> risks;
+            std::vector<int> selected;
+            for (int cycle = 0;; cycle++)
+            {
+                while (cycles_started.load() == cycle && !stop.load())
+                    std::this_thread::yield();
+                if (stop.load())
+                    break;
+
+                computeObstacleRisks(obstacles, robot_x, robot_y, 0.325, 0.2, RiskMetric::MIN_DISTANCE, risks);
+                selectCriticalObstacles(risks, 12, selected);
+                cycles_done++;
+            } });
+    }
+
+    std::string report;
+    int allocations = CountAllocations([&](int i)
+                                       {
+        cycles_started = i + 1;
+        while (cycles_done.load() < num_threads * (i + 1))
+            std::this_thread::yield(); },
+                                       5, 50, report);
+    EXPECT_EQ(allocations, 0) << report;
+
+    stop = true;
+    for (auto &thread : threads)
+        thread.join();
+}
+
+TEST(AllocationTest, UnusedBenchmarkerDoesNotAllocate)
+{
+    // As the local timers in the solver: constructed every cycle, the histogram is only allocated when recording
+    std::string report;
+    int allocations = CountAllocations([](int i)
+                                       {
+        Benchmarker timer("iteration");
+        EXPECT_EQ(timer.getPercentile(50.), 0.);
+        EXPECT_EQ(timer.getHistogram().getCountAbove(0.001 * i), 0u); },
+                                       0, 10, report);
+    EXPECT_EQ(allocations, 0) << report;
+}
+
+TEST(AllocationTest, DataRecorderDoesNotAllocate)
+{
+    std::string file = testing::TempDir() + "/allocations.mpcrec";
+
+    DataRecorder recorder(4096); // Room for the values appended between two flushes
+    ColumnHandle runtime = recorder.addColumn("runtime");
+    ColumnHandle pose = recorder.addColumn("pose", 2);
+    ASSERT_TRUE(recorder.open(file));
+
+    // Per cycle: append into the preallocated columns, every other cycle hand them to the writer thread. Waiting for the
+    // writer keeps the backlog at two cycles, such that the result does not depend on how fast the file is written
+    std::string report;
+    int allocations = CountAllocations([&](int i)
+                                       {
+        recorder.append(runtime, 0.01 * i);
+        for (int o = 0; o < 20; o++)
+            recorder.append(pose, Eigen::Vector2d(i, o));
+
+        if (i % 2 == 1)
+        {
+            recorder.flush();
+            recorder.waitUntilWritten();
+        } },
+                                       5, 200, report);
+    EXPECT_EQ(allocations, 0) << report;
+
+    recorder.close();
+    std::remove(file.c_str());
+}
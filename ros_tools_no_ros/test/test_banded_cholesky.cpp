@@ -0,0 +1,89 @@
+#include <gtest/gtest.h>
+
+#include <ros_tools/banded_cholesky.h>
+
+#include <random>
+
+using namespace RosTools;
+
+// Fill a random symmetric positive definite banded system (diagonally dominant)
+static void FillRandomSystem(BandedCholesky &system, int size, int bandwidth, std::mt19937 &rng)
+{
+    std::uniform_real_distribution<double> dist(-1., 1.);
+
+    system.Reset(size, bandwidth);
+    for (int j = 0; j < size; j++)
+    {
+        for (int i = j + 1; i <= std::min(size - 1, j + bandwidth); i++)
+            system(i, j) = dist(rng);
+    }
+
+    for (int j = 0; j < size; j++)
+        system(j, j) = 2. * (bandwidth + 1);
+}
+
+TEST(BandedCholeskyTest, MatchesDenseSolve)
+{
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<double> dist(-1., 1.);
+
+    BandedCholesky system;
+    for (int size : {1, 2, 5, 20, 101})
+    {
+        for (int bandwidth : {0, 1, 4})
+        {
+            FillRandomSystem(system, size, bandwidth, rng);
+            Eigen::MatrixXd dense = system.ToDense();
+
+            Eigen::VectorXd b(size);
+            for (int i = 0; i < size; i++)
+                b(i) = dist(rng);
+
+            ASSERT_TRUE(system.Factorize());
+
+            Eigen::VectorXd x;
+            system.Solve(b, x);
+
+            Eigen::VectorXd x_dense = dense.inverse() * b;
+            EXPECT_LT((x - x_dense).norm(), 1e-9) << "size: " << size << ", bandwidth: " << bandwidth;
+        }
+    }
+}
+
+TEST(BandedCholeskyTest, SolvesInPlaceAndReuses)
+{
+    // Second-order difference (smoothness) matrix with an identity regularization
+    BandedCholesky system;
+    for (int size : {40, 10, 40})
+    {
+        system.Reset(size, 4);
+        for (int j = 0; j < size; j++)
+        {
+            system(j, j) = 6. + 1.;
+            if (j + 2 < size)
+                system(j + 2, j) = -4.;
+            if (j + 4 < size)
+                system(j + 4, j) = 1.;
+        }
+        Eigen::MatrixXd dense = system.ToDense();
+
+        Eigen::VectorXd x = Eigen::VectorXd::LinSpaced(size, -1., 1.);
+        Eigen::VectorXd b = x;
+
+        ASSERT_TRUE(system.Factorize());
+        system.Solve(x, x);
+
+        EXPECT_LT((dense * x - b).norm(), 1e-9);
+    }
+}
+
+TEST(BandedCholeskyTest, RejectsIndefiniteSystems)
+{
+    BandedCholesky system(3, 1);
+    system(0, 0) = 1.;
+    system(1, 0) = 2.;
+    system(1, 1) = 1.;
+    system(2, 2) = 1.;
+
+    EXPECT_FALSE(system.Factorize());
+}
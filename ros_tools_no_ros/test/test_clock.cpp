@@ -0,0 +1,83 @@
+#include <gtest/gtest.h>
+
+#include <ros_tools/clock.h>
+#include <ros_tools/profiling.h>
+
+#include <memory>
+
+using namespace RosTools;
+
+TEST(ClockTest, SteadyClockIsMonotonic)
+{
+    SteadyClock clock;
+    Clock::TimePoint previous = clock.now();
+    for (int i = 0; i < 1000; i++)
+    {
+        Clock::TimePoint current = clock.now();
+        EXPECT_GE(current, previous);
+        previous = current;
+    }
+}
+
+TEST(ClockTest, VirtualClockOnlyMovesWhenAdvanced)
+{
+    VirtualClock clock;
+    Clock::TimePoint start = clock.now();
+    EXPECT_EQ(clock.now(), start);
+
+    clock.advance(0.05);
+    EXPECT_NEAR(clock.secondsSince(start), 0.05, 1e-9);
+
+    clock.setTime(10.);
+    EXPECT_NEAR(std::chrono::duration<double>(clock.now().time_since_epoch()).count(), 10., 1e-9);
+}
+
+TEST(ClockTest, TimerDeadlineWithVirtualClock)
+{
+    auto clock = std::make_shared<VirtualClock>();
+    Timer timer(0.02, clock);
+    timer.start();
+    EXPECT_FALSE(timer.hasFinished());
+
+    clock->advance(0.019);
+    EXPECT_FALSE(timer.hasFinished());
+
+    clock->advance(0.002);
+    EXPECT_TRUE(timer.hasFinished());
+    EXPECT_NEAR(timer.currentDuration(), 0.021, 1e-9);
+}
+
+TEST(ClockTest, BenchmarkerDeadlineMissesWithVirtualClock)
+{
+    auto clock = std::make_shared<VirtualClock>();
+    Benchmarker benchmarker("virtual");
+    benchmarker.setClock(clock);
+    benchmarker.setDeadline(0.05);
+
+    // Alternate between runs that make and miss the deadline
+    for (int i = 0; i < 10; i++)
+    {
+        benchmarker.start();
+        clock->advance(i % 2 == 0 ? 0.04 : 0.06);
+        benchmarker.stop();
+    }
+
+    EXPECT_EQ(benchmarker.getNumRuns(), 10);
+    EXPECT_EQ(benchmarker.getDeadlineMisses(), 5);
+    EXPECT_NEAR(benchmarker.getTotalDuration(), 0.5, 1e-9);
+    EXPECT_NEAR(benchmarker.getLast(), 0.06, 1e-9);
+}
+
+TEST(ClockTest, DefaultClockCanBeReplaced)
+{
+    auto clock = std::make_shared<VirtualClock>();
+    Clock::setDefault(clock);
+
+    Timer timer(1.0); // Uses the default clock
+    timer.start();
+    clock->advance(2.0);
+    EXPECT_TRUE(timer.hasFinished());
+
+    Clock::setDefault(nullptr);
+    EXPECT_NE(std::dynamic_pointer_cast<SteadyClock>(Clock::getDefault()), nullptr);
+}
@@ -0,0 +1,83 @@
+#include <gtest/gtest.h>
+
+#include <ros_tools/data_recorder.h>
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+using namespace RosTools;
+
+static std::string TemporaryFile(const std::string &name)
+{
+    return testing::TempDir() + "/" + name + ".mpcrec";
+}
+
+TEST(DataRecorderTest, RoundTrip)
+{
+    std::string file = TemporaryFile("round_trip");
+    {
+        DataRecorder recorder(4); // Small buffers, such that they grow while the writer is busy
+        ColumnHandle runtime = recorder.addColumn("runtime");
+        ColumnHandle pose = recorder.addColumn("pose", 2);
+        ColumnHandle unused = recorder.addColumn("unused");
+        (void)unused;
+        ASSERT_TRUE(recorder.open(file));
+
+        for (int i = 0; i < 1000; i++)
+        {
+            recorder.append(runtime, 0.001 * i);
+            recorder.append(pose, Eigen::Vector2d(i, -i));
+            if (i == 500)
+            {
+                ColumnHandle late = recorder.addColumn("late"); // Columns can be added while recording
+                recorder.append(late, 42.);
+            }
+            recorder.flush();
+        }
+    } // Closed by the destructor
+
+    std::map<std::string, std::vector<double>> scalars;
+    std::map<std::string, std::vector<Eigen::Vector2d>> points;
+    ASSERT_TRUE(DataRecorder::load(file, scalars, points));
+
+    ASSERT_EQ(scalars["runtime"].size(), 1000u);
+    ASSERT_EQ(points["pose"].size(), 1000u);
+    for (int i = 0; i < 1000; i++)
+    {
+        EXPECT_EQ(scalars["runtime"][i], 0.001 * i); // Bit exact
+        EXPECT_EQ(points["pose"][i], Eigen::Vector2d(i, -i));
+    }
+    EXPECT_EQ(scalars["late"], std::vector<double>({42.}));
+    EXPECT_EQ(scalars.count("unused"), 0u); // Only columns with data are written
+
+    std::remove(file.c_str());
+}
+
+TEST(DataRecorderTest, LoadsTruncatedRecordings)
+{
+    std::string file = TemporaryFile("truncated");
+    {
+        DataRecorder recorder;
+        ColumnHandle value = recorder.addColumn("value");
+        ASSERT_TRUE(recorder.open(file));
+        for (int i = 0; i < 10; i++)
+            recorder.append(value, i);
+    }
+
+    // Without the end marker (e.g., a crashed planner) the data up to that point is still loaded
+    std::ifstream in(file, std::ios::binary);
+    std::string contents((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    in.close();
+    std::ofstream(file, std::ios::binary | std::ios::trunc) << contents.substr(0, contents.size() - 1);
+
+    std::map<std::string, std::vector<double>> scalars;
+    std::map<std::string, std::vector<Eigen::Vector2d>> points;
+    EXPECT_FALSE(DataRecorder::load(file, scalars, points));
+    EXPECT_EQ(scalars["value"].size(), 10u);
+
+    std::ofstream(file, std::ios::binary | std::ios::trunc) << "not a recording";
+    EXPECT_FALSE(DataRecorder::load(file, scalars, points));
+
+    std::remove(file.c_str());
+}
@@ -0,0 +1,68 @@
+#include <gtest/gtest.h>
+
+#include "linearization_reference.h"
+
+using namespace RosTools;
+
+TEST(LinearizationTest, MatchesScalarLoop)
+{
+    std::mt19937 rng(1);
+
+    for (int num_obstacles : {1, 4, 12})
+    {
+        ObstacleBlock obstacles;
+        Eigen::ArrayXd x, y;
+        FillRandomScenario(obstacles, x, y, 30, num_obstacles, rng);
+
+        Eigen::ArrayXd x_ref = x, y_ref = y;
+        HalfspaceBlock reference;
+        reference.resize(30, num_obstacles + 2);
+        ReferenceLinearization(obstacles, 0.325, x_ref, y_ref, reference);
+
+        HalfspaceBlock halfspaces;
+        halfspaces.resize(30, num_obstacles + 2); // Additional columns remain available for other constraints
+        projectToSafety(obstacles, 0.325, 3, x, y);
+        linearizeObstacles(obstacles, 0.325, x, y, halfspaces);
+
+        EXPECT_LT((x - x_ref).abs().maxCoeff(), 1e-9);
+        EXPECT_LT((y - y_ref).abs().maxCoeff(), 1e-9);
+
+        auto used = Eigen::seqN(0, num_obstacles);
+        EXPECT_LT((halfspaces.a1(Eigen::all, used) - reference.a1(Eigen::all, used)).abs().maxCoeff(), 1e-9);
+        EXPECT_LT((halfspaces.a2(Eigen::all, used) - reference.a2(Eigen::all, used)).abs().maxCoeff(), 1e-9);
+        EXPECT_LT((halfspaces.b(Eigen::all, used) - reference.b(Eigen::all, used)).abs().maxCoeff(), 1e-9);
+    }
+}
+
+TEST(LinearizationTest, HalfspacesSeparatePositionFromObstacle)
+{
+    std::mt19937 rng(2);
+
+    ObstacleBlock obstacles;
+    Eigen::ArrayXd x, y;
+    FillRandomScenario(obstacles, x, y, 20, 1, rng); // A single obstacle is always projected out of
+
+    HalfspaceBlock halfspaces;
+    halfspaces.resize(20, 1);
+    projectToSafety(obstacles, 0.5, 3, x, y);
+    linearizeObstacles(obstacles, 0.5, x, y, halfspaces);
+
+    for (int k = 0; k < 20; k++)
+    {
+        // The obstacle center violates its constraint, the projected position satisfies it
+        EXPECT_GT(halfspaces.a1(k, 0) * obstacles.x(k, 0) + halfspaces.a2(k, 0) * obstacles.y(k, 0), halfspaces.b(k, 0));
+        EXPECT_LE(halfspaces.a1(k, 0) * x(k) + halfspaces.a2(k, 0) * y(k), halfspaces.b(k, 0) + 1e-9);
+    }
+}
+
+TEST(LinearizationTest, NoObstacles)
+{
+    ObstacleBlock obstacles;
+    obstacles.resize(10, 0);
+
+    Eigen::ArrayXd x = Eigen::ArrayXd::LinSpaced(10, 0., 1.), y = Eigen::ArrayXd::Zero(10);
+    Eigen::ArrayXd x_before = x;
+    projectToSafety(obstacles, 0.5, 3, x, y);
+
+    EXPECT_TRUE((x == x_before).all());
+}
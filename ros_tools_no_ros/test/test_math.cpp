@@ -0,0 +1,35 @@
+#include <gtest/gtest.h>
+
+#include <ros_tools/math.h>
+
+using namespace RosTools;
+
+TEST(MathTest, PointSegmentDistance)
+{
+    Eigen::Vector2d a(0., 0.), b(2., 0.);
+
+    EXPECT_NEAR(pointSegmentDistance(Eigen::Vector2d(1., 1.), a, b), 1., 1e-12);  // Above the segment
+    EXPECT_NEAR(pointSegmentDistance(Eigen::Vector2d(-3., 4.), a, b), 5., 1e-12); // Beyond the start
+    EXPECT_NEAR(pointSegmentDistance(Eigen::Vector2d(3., 0.), a, b), 1., 1e-12);  // Beyond the end
+    EXPECT_NEAR(pointSegmentDistance(Eigen::Vector2d(1., 2.), a, a), std::sqrt(5.), 1e-12); // Degenerate segment
+}
+
+TEST(MathTest, SegmentSegmentDistance)
+{
+    Eigen::Vector2d a0(0., 0.), a1(2., 0.);
+
+    // Crossing segments
+    EXPECT_NEAR(segmentSegmentDistance(a0, a1, Eigen::Vector2d(1., -1.), Eigen::Vector2d(1., 1.)), 0., 1e-12);
+
+    // Parallel segments
+    EXPECT_NEAR(segmentSegmentDistance(a0, a1, Eigen::Vector2d(0., 1.5), Eigen::Vector2d(2., 1.5)), 1.5, 1e-12);
+
+    // Touching at an end point
+    EXPECT_NEAR(segmentSegmentDistance(a0, a1, Eigen::Vector2d(2., 0.), Eigen::Vector2d(3., 3.)), 0., 1e-12);
+
+    // Segment that would cross the line through a0-a1, but not the segment itself
+    EXPECT_NEAR(segmentSegmentDistance(a0, a1, Eigen::Vector2d(3., -1.), Eigen::Vector2d(3., 1.)), 1., 1e-12);
+
+    // Symmetric
+    EXPECT_NEAR(segmentSegmentDistance(Eigen::Vector2d(3., -1.), Eigen::Vector2d(3., 1.), a0, a1), 1., 1e-12);
+}
@@ -0,0 +1,86 @@
+#include <gtest/gtest.h>
+
+#include <ros_tools/obstacle_selection.h>
+
+#include <algorithm>
+#include <limits>
+#include <random>
+
+using namespace RosTools;
+
+// Obstacles moving with constant velocity, starting at (x, y)
+static void SetConstantVelocity(ObstacleBlock &obstacles, int o, double x, double y, double vx, double vy, double dt)
+{
+    for (int k = 0; k < obstacles.numStages(); k++)
+    {
+        obstacles.x(k, o) = x + vx * k * dt;
+        obstacles.y(k, o) = y + vy * k * dt;
+    }
+}
+
+TEST(ObstacleSelectionTest, SelectionMatchesFullSort)
+{
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<double> value(0., 10.);
+
+    for (int num_obstacles : {0, 1, 10, 1000})
+    {
+        for (int max_obstacles : {0, 1, 8, 100, 2000})
+        {
+            std::vector<ObstacleRisk> risks(num_obstacles);
+            for (int i = 0; i < num_obstacles; i++)
+                risks[i] = {std::floor(value(rng)), value(rng), i}; // Many ties in the value
+
+            std::vector<ObstacleRisk> sorted = risks;
+            std::sort(sorted.begin(), sorted.end());
+
+            std::vector<int> selected;
+            selectCriticalObstacles(risks, max_obstacles, selected);
+
+            ASSERT_EQ((int)selected.size(), std::min(num_obstacles, max_obstacles));
+            for (size_t i = 0; i < selected.size(); i++)
+                EXPECT_EQ(selected[i], sorted[i].index);
+        }
+    }
+}
+
+TEST(ObstacleSelectionTest, TimeToCollisionPrefersOncomingObstacles)
+{
+    const int num_stages = 30;
+    const double dt = 0.2;
+
+    ObstacleBlock obstacles;
+    obstacles.resize(num_stages, 2);
+    obstacles.radius.setConstant(0.5);
+    SetConstantVelocity(obstacles, 0, 2., 0., 1., 0., dt);  // Close, but moving away
+    SetConstantVelocity(obstacles, 1, 8., 0., -3., 0., dt); // Further, but moving towards the robot
+
+    // The robot stands still at the origin
+    Eigen::ArrayXd robot_x = Eigen::ArrayXd::Zero(num_stages), robot_y = Eigen::ArrayXd::Zero(num_stages);
+
+    std::vector<ObstacleRisk> risks;
+    std::vector<int> selected;
+
+    computeObstacleRisks(obstacles, robot_x, robot_y, 0.5, dt, RiskMetric::TIME_TO_COLLISION, risks);
+    EXPECT_EQ(risks[0].value, std::numeric_limits<double>::infinity());
+    EXPECT_NEAR(risks[1].value, (8. - 1.) / 3., 1e-9); // Contact when the distance equals both radii
+    selectCriticalObstacles(risks, 1, selected);
+    EXPECT_EQ(selected[0], 1);
+
+    computeObstacleRisks(obstacles, robot_x, robot_y, 0.5, dt, RiskMetric::MIN_DISTANCE, risks);
+    selectCriticalObstacles(risks, 1, selected);
+    EXPECT_EQ(selected[0], 1);
+
+    // The distance heuristic discounts later stages and keeps the close obstacle instead
+    computeObstacleRisks(obstacles, robot_x, robot_y, 0.5, dt, RiskMetric::WEIGHTED_DISTANCE, risks);
+    selectCriticalObstacles(risks, 1, selected);
+    EXPECT_EQ(selected[0], 0);
+}
+
+TEST(ObstacleSelectionTest, ParsesMetrics)
+{
+    EXPECT_EQ(riskMetricFromString("time_to_collision"), RiskMetric::TIME_TO_COLLISION);
+    EXPECT_EQ(riskMetricFromString("min_distance"), RiskMetric::MIN_DISTANCE);
+    EXPECT_EQ(riskMetricFromString("weighted_distance"), RiskMetric::WEIGHTED_DISTANCE);
+    EXPECT_THROW(riskMetricFromString("closest"), std::invalid_argument);
+}
@@ -0,0 +1,390 @@
+#include <gtest/gtest.h>
+
+#include <ros_tools/profiling.h>
+
+#include <simple_json.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+using namespace RosTools;
+
+/** @brief Start a trace session that writes into the temporary directory, returns the path of the trace */
+static std::string BeginTraceSession(const std::string &file)
+{
+    setenv("profiling_test_PATH", testing::TempDir().c_str(), 1); // The trace is written to <name>_PATH/<file>
+    Instrumentor::Get().BeginSession("profiling_test", file);
+    return testing::TempDir() + "/" + file;
+}
+
+/** @brief Parse the trace, fails if it is not a complete JSON document */
+static simple_json::Value ReadTrace(const std::string &path)
+{
+    std::ifstream stream(path);
+    std::stringstream buffer;
+    buffer << stream.rdbuf();
+    std::string trace = buffer.str();
+
+    EXPECT_GE(trace.size(), 2u);
+    EXPECT_EQ(trace.substr(trace.size() - 2), "]}"); // The parser does not check the end of the document
+    return simple_json::Parser::parse(trace);
+}
+
+static ProfileResult Event(const char *name, long long start, uint32_t thread_id)
+{
+    ProfileResult result;
+    result.Name = name;
+    result.Start = start;
+    result.End = start + 1;
+    result.ThreadID = thread_id;
+    return result;
+}
+
+TEST(ProfilingTest, HandlesAreRegisteredOnce)
+{
+    BenchmarkerHandle handle = BENCHMARKERS.registerBenchmarker("test_register");
+    EXPECT_EQ(BENCHMARKERS.registerBenchmarker("test_register"), handle);
+    EXPECT_NE(BENCHMARKERS.registerBenchmarker("test_register_other"), handle);
+
+    // The string API resolves to the same benchmarker of this thread
+    EXPECT_EQ(&BENCHMARKERS.getBenchmarker("test_register"), &BENCHMARKERS.getBenchmarker(handle));
+
+    EXPECT_EQ(BENCHMARKERS.getName(handle), "test_register");
+    EXPECT_GT(BENCHMARKERS.getNumBenchmarkers(), handle);
+
+    BENCHMARKERS.getBenchmarker(handle).start();
+    BENCHMARKERS.getBenchmarker(handle).stop();
+    BENCHMARKERS.resetAll();
+    EXPECT_EQ(BENCHMARKERS.getAggregate(handle).getNumRuns(), 0);
+}
+
+TEST(ProfilingTest, ReferencesRemainValidWhenRegistering)
+{
+    Benchmarker &first = BENCHMARKERS.getBenchmarker("test_reference");
+    for (int i = 0; i < 100; i++)
+        BENCHMARKERS.getBenchmarker("test_reference_" + std::to_string(i));
+
+    EXPECT_EQ(&first, &BENCHMARKERS.getBenchmarker("test_reference"));
+}
+
+TEST(ProfilingTest, AggregatesOverThreads)
+{
+    BenchmarkerHandle handle = BENCHMARKERS.registerBenchmarker("test_threads");
+    BENCHMARKERS.reset(handle);
+
+    const int num_threads = 8;
+    const int runs = 1000;
+
+    // Half of the threads exit before reporting, the other half keep running
+    std::vector<std::thread> threads;
+    bool done = false;
+    std::mutex mutex;
+    std::condition_variable condition;
+    int num_finished = 0;
+    for (int thread = 0; thread < num_threads; thread++)
+    {
+        threads.emplace_back([&, thread]()
+                             {
+            for (int i = 0; i < runs; i++)
+            {
+                Benchmarker &benchmarker = BENCHMARKERS.getBenchmarker(handle);
+                benchmarker.start();
+                benchmarker.stop();
+            }
+
+            std::unique_lock<std::mutex> lock(mutex);
+            num_finished++;
+            condition.notify_all();
+            if (thread % 2 == 1)
+                condition.wait(lock, [&]() { return done; }); });
+    }
+
+    for (int thread = 0; thread < num_threads; thread += 2)
+        threads[thread].join();
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        condition.wait(lock, [&]() { return num_finished == num_threads; });
+    }
+
+    Benchmarker aggregate = BENCHMARKERS.getAggregate(handle);
+    EXPECT_EQ(aggregate.getNumRuns(), num_threads * runs);
+    EXPECT_GE(aggregate.getTotalDuration(), 0.);
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        done = true;
+    }
+    condition.notify_all();
+    for (int thread = 1; thread < num_threads; thread += 2)
+        threads[thread].join();
+
+    EXPECT_EQ(BENCHMARKERS.getAggregate(handle).getNumRuns(), num_threads * runs);
+
+    BENCHMARKERS.reset(handle);
+    EXPECT_EQ(BENCHMARKERS.getAggregate(handle).getNumRuns(), 0);
+}
+
+TEST(ProfilingTest, HistogramPercentiles)
+{
+    LatencyHistogram histogram;
+    for (int i = 1; i <= 10000; i++)
+        histogram.record(i * 1e-6); // 1 us to 10 ms
+
+    EXPECT_EQ(histogram.getCount(), 10000u);
+    for (double percentile : {50., 90., 99., 99.9})
+    {
+        double expected = percentile / 100. * 10000 * 1e-6;
+        EXPECT_NEAR(histogram.getPercentile(percentile), expected, expected / 64.) << "p" << percentile;
+    }
+    EXPECT_DOUBLE_EQ(histogram.getMax(), 10000 * 1e-6);
+    EXPECT_EQ(histogram.getPercentile(100.), histogram.getMax());
+    EXPECT_NEAR((double)histogram.getCountAbove(9e-3), 1000., 9e-3 / 64. / 1e-6); // One bucket (~1.6% of 9 ms) of samples
+}
+
+TEST(ProfilingTest, HistogramMergeAndDump)
+{
+    LatencyHistogram fast, slow;
+    for (int i = 0; i < 990; i++)
+        fast.record(1e-3);
+    for (int i = 0; i < 10; i++)
+        slow.record(50e-3);
+
+    std::stringstream dump;
+    slow.write(dump);
+
+    LatencyHistogram merged = fast;
+    ASSERT_TRUE(merged.read(dump));
+    EXPECT_EQ(merged.getCount(), 1000u);
+    EXPECT_NEAR(merged.getPercentile(50.), 1e-3, 1e-3 / 64.);
+    EXPECT_NEAR(merged.getPercentile(99.9), 50e-3, 50e-3 / 64.); // The tail that the average hides
+    EXPECT_DOUBLE_EQ(merged.getMax(), 50e-3);
+
+    std::stringstream malformed("max 10\n5");
+    EXPECT_FALSE(merged.read(malformed));
+}
+
+TEST(ProfilingTest, CountsDeadlineMisses)
+{
+    BenchmarkerHandle handle = BENCHMARKERS.registerBenchmarker("test_deadline");
+    BENCHMARKERS.setDeadline(handle, 1e-3);
+
+    std::thread thread([&]()
+                       {
+        Benchmarker &benchmarker = BENCHMARKERS.getBenchmarker(handle);
+        for (int i = 0; i < 3; i++)
+        {
+            benchmarker.start();
+            std::this_thread::sleep_for(std::chrono::milliseconds(i == 0 ? 3 : 0));
+            benchmarker.stop();
+        } });
+    thread.join();
+
+    Benchmarker aggregate = BENCHMARKERS.getAggregate(handle);
+    EXPECT_EQ(aggregate.getNumRuns(), 3);
+    EXPECT_EQ(aggregate.getDeadlineMisses(), 1);
+    EXPECT_GE(aggregate.getPercentile(100.), 3e-3);
+}
+
+TEST(ProfilingTest, HardwareCountersAreOptional)
+{
+    PerfSample sample;
+    PerfCounters::setEnabled(false);
+    EXPECT_FALSE(PerfCounters::sample(sample));
+
+    // Without access to perf (e.g., in a container) or when the counters are never scheduled (e.g., in a VM), nothing is
+    // counted and profiling works as before
+    PerfCounters::setEnabled(true);
+    bool available = PerfCounters::sample(sample);
+    if (!PerfCounters::get().isAvailable())
+    {
+        EXPECT_FALSE(available);
+    }
+
+    Benchmarker benchmarker("test_counters");
+    for (int i = 0; i < 3; i++)
+    {
+        benchmarker.start();
+        benchmarker.stop();
+    }
+    EXPECT_EQ(benchmarker.getNumRuns(), 3);
+    EXPECT_EQ(benchmarker.getCountedRuns(), available ? 3 : 0);
+    if (available)
+    {
+        EXPECT_GT(benchmarker.getCounters().instructions, 0u);
+    }
+
+    PerfCounters::setEnabled(false);
+}
+
+TEST(ProfilingTest, HardwareCountersAreScaledWhenMultiplexed)
+{
+    PerfSample start, end;
+    start.cycles = 1000;
+    start.instructions = 2000;
+    start.time_enabled = 100;
+    start.time_running = 100;
+
+    // Counting half of the time in between: the counts are extrapolated to the enabled time
+    end.cycles = 1500;
+    end.instructions = 2600;
+    end.time_enabled = 300;
+    end.time_running = 200;
+
+    PerfSample difference = end - start;
+    EXPECT_TRUE(difference.isCounting());
+    EXPECT_EQ(difference.cycles, 1000u);
+    EXPECT_EQ(difference.instructions, 1200u);
+
+    // Not scheduled in between: not counting
+    end.time_running = start.time_running;
+    EXPECT_FALSE((end - start).isCounting());
+}
+
+TEST(ProfilingTest, TraceContainsTheEventsOfAllThreads)
+{
+    std::string path = BeginTraceSession("threads.json");
+
+    // Fewer events per thread than fit in its buffer: nothing is dropped, while the writer drains concurrently
+    const int num_threads = 4;
+    const int events = 2000;
+    std::vector<std::thread> threads;
+    for (int thread = 0; thread < num_threads; thread++)
+    {
+        threads.emplace_back([thread]()
+                             {
+            for (int i = 0; i < events; i++)
+            {
+                Instrumentor::Get().WriteProfile(Event("scope \"quoted\"", i, thread));
+                if (i % 500 == 0)
+                    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            } });
+    }
+    for (auto &thread : threads)
+        thread.join();
+
+    Instrumentor::Get().EndSession();
+    EXPECT_EQ(Instrumentor::Get().GetDroppedCount(), 0u);
+
+    simple_json::Value trace;
+    ASSERT_NO_THROW(trace = ReadTrace(path));
+    ASSERT_TRUE(trace["traceEvents"].is_array());
+
+    const simple_json::Value &trace_events = trace.as_object().at("traceEvents");
+    ASSERT_EQ(trace_events.size(), (size_t)(num_threads * events));
+
+    // All events of each thread, in the order they were recorded
+    std::map<int, int> next_start;
+    for (size_t i = 0; i < trace_events.size(); i++)
+    {
+        const simple_json::Value &event = trace_events[i];
+        EXPECT_EQ(event["name"].as_string(), "scope 'quoted'");
+        EXPECT_EQ(event["dur"].as_double(), 1.);
+
+        int thread = (int)event["tid"].as_double();
+        EXPECT_EQ((int)event["ts"].as_double(), next_start[thread]);
+        next_start[thread]++;
+    }
+    for (int thread = 0; thread < num_threads; thread++)
+        EXPECT_EQ(next_start[thread], events);
+
+    std::remove(path.c_str());
+}
+
+TEST(ProfilingTest, TraceCountsDroppedEvents)
+{
+    std::string path = BeginTraceSession("dropped.json");
+
+    // Many times the size of the buffer at once, faster than the writer drains it (every 20 ms)
+    const int events = 100000;
+    std::thread producer([]()
+                         {
+        for (int i = 0; i < events; i++)
+            Instrumentor::Get().WriteProfile(Event("burst", i, 0)); });
+    producer.join();
+
+    Instrumentor::Get().EndSession();
+    uint64_t dropped = Instrumentor::Get().GetDroppedCount();
+    EXPECT_GT(dropped, 0u);
+
+    // Every event is either in the trace or counted as dropped
+    simple_json::Value trace;
+    ASSERT_NO_THROW(trace = ReadTrace(path));
+    EXPECT_EQ(trace["traceEvents"].size() + dropped, (size_t)events);
+
+    std::remove(path.c_str());
+}
+
+TEST(ProfilingTest, ExitedThreadsReleaseTheirBuffers)
+{
+    size_t buffers = Instrumentor::Get().GetThreadBufferCount();
+    std::string path = BeginTraceSession("exited.json");
+
+    std::vector<std::thread> threads;
+    for (int thread = 0; thread < 4; thread++)
+    {
+        threads.emplace_back([thread]()
+                             { Instrumentor::Get().WriteProfile(Event("short-lived", 0, thread)); });
+    }
+    for (auto &thread : threads)
+        thread.join();
+
+    // Their events are still written, then the buffers are released
+    Instrumentor::Get().EndSession();
+    EXPECT_EQ(Instrumentor::Get().GetThreadBufferCount(), buffers);
+
+    simple_json::Value trace;
+    ASSERT_NO_THROW(trace = ReadTrace(path));
+    EXPECT_EQ(trace["traceEvents"].size(), 4u);
+
+    std::remove(path.c_str());
+}
+
+TEST(ProfilingTest, EventsRecordedWhileEndingAreInTheTrace)
+{
+    std::string path = BeginTraceSession("ending.json");
+
+    // The session ends while the producers record: no event may be left behind for the next session
+    std::atomic<bool> stop{false};
+    std::atomic<int> started{0};
+    std::vector<std::thread> threads;
+    for (int thread = 0; thread < 4; thread++)
+    {
+        threads.emplace_back([&, thread]()
+                             {
+            started++;
+            for (int i = 0; !stop; i++)
+            {
+                Instrumentor::Get().WriteProfile(Event("ending", i, thread));
+                if (i % 1000 == 0)
+                    std::this_thread::yield();
+            } });
+    }
+    while (started < 4)
+        std::this_thread::yield();
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+
+    Instrumentor::Get().EndSession();
+    simple_json::Value trace;
+    ASSERT_NO_THROW(trace = ReadTrace(path));
+    EXPECT_GT(trace["traceEvents"].size(), 0u);
+
+    stop = true;
+    for (auto &thread : threads)
+        thread.join();
+
+    std::string next_path = BeginTraceSession("after_ending.json");
+    Instrumentor::Get().EndSession();
+    ASSERT_NO_THROW(trace = ReadTrace(next_path));
+    EXPECT_EQ(trace["traceEvents"].size(), 0u);
+
+    std::remove(path.c_str());
+    std::remove(next_path.c_str());
+}
@@ -1,6 +1,7 @@
 #include <gtest/gtest.h>
 
 #include <ros_tools/spline.h>
+#include <ros_tools/spline_window.h>
 
 using namespace RosTools;
 
@@ -47,6 +48,138 @@ TEST_F(SplineTest, TestName)
     ASSERT_TRUE(std::abs(s_out - 2.5) < 1e-5);
 }
 
+TEST_F(SplineTest, ClosestPointOnCurvedSpline)
+{
+    // Winding path, compared against a dense sampling of the spline
+    std::vector<double> x, y;
+    for (int i = 0; i < 30; i++)
+    {
+        x.push_back(i * 0.8);
+        y.push_back(3. * std::sin(i * 0.4));
+    }
+    Spline2D spline(x, y);
+
+    for (int i = 0; i < 8; i++)
+        ASSERT_EQ(spline.findSegment(spline.getSegmentStart(i) + 1e-6), i);
+    ASSERT_EQ(spline.findSegment(-1.), 0);
+    ASSERT_EQ(spline.findSegment(spline.length() + 1.), spline.numSegments() - 1);
+
+    // Follow the path with a point offset to the side, as a robot tracking it would
+    for (double s = 0.; s < spline.length(); s += 0.37)
+    {
+        Eigen::Vector2d query = spline.getPoint(s) + 0.5 * spline.getOrthogonal(s);
+
+        double best_s = 0., best_distance = 1e9;
+        for (double s_sample = 0.; s_sample <= spline.length(); s_sample += 1e-3)
+        {
+            double distance = (spline.getPoint(s_sample) - query).norm();
+            if (distance < best_distance)
+            {
+                best_distance = distance;
+                best_s = s_sample;
+            }
+        }
+
+        int segment_out;
+        double s_out;
+        spline.findClosestPoint(query, segment_out, s_out);
+        EXPECT_NEAR((spline.getPoint(s_out) - query).norm(), best_distance, 1e-5) << "s: " << s << ", found: " << s_out << ", expected: " << best_s;
+        EXPECT_EQ(segment_out, spline.findSegment(s_out));
+    }
+}
+
+TEST_F(SplineTest, WindowFollowsLongPath)
+{
+    // A long winding route with a point every meter
+    std::vector<double> x, y;
+    for (int i = 0; i < 2000; i++)
+    {
+        x.push_back(i * 0.9);
+        y.push_back(10. * std::sin(i * 0.01));
+    }
+    Spline2D full_spline(x, y);
+
+    Spline2DWindow window(5., 30., 5);
+    window.setPath(x, y);
+    ASSERT_EQ(window.getSpline(), nullptr);
+
+    int num_moves = 0;
+    double prev_s = 0.;
+    for (double s = 0.; s < full_spline.length(); s += 0.5)
+    {
+        Eigen::Vector2d robot = full_spline.getPoint(s) + 0.3 * full_spline.getOrthogonal(s);
+
+        int segment_out;
+        double s_out;
+        if (window.findClosestPoint(robot, segment_out, s_out))
+            num_moves++;
+
+        // The window is bounded and the progress is continuous across window moves
+        const auto &spline = window.getSpline();
+        ASSERT_LE(window.lastIndex() - window.firstIndex(), 60);
+        EXPECT_NEAR(s_out, s, 0.05) << "window: [" << window.firstIndex() << ", " << window.lastIndex() << "]";
+        EXPECT_GE(s_out, prev_s - 1e-6);
+        prev_s = s_out;
+
+        // Window segments map to path segments
+        EXPECT_EQ(window.firstIndex() + segment_out, window.findPathSegment(s_out));
+        EXPECT_GE(spline->numSegments() - segment_out, std::min(5, window.numPoints() - 1 - window.findPathSegment(s_out)));
+
+        // Away from its ends, the window spline matches the spline over the full path
+        EXPECT_LT((spline->getPoint(s_out) - full_spline.getPoint(s_out)).norm(), 1e-3);
+    }
+
+    EXPECT_TRUE(window.coversEnd());
+    EXPECT_GT(num_moves, 50);
+    EXPECT_LT(num_moves, 200);
+}
+
+TEST_F(SplineTest, BatchEvaluationMatchesPointwise)
+{
+    std::vector<double> x, y;
+    for (int i = 0; i < 25; i++)
+    {
+        x.push_back(i * 1.3 + 0.2 * std::sin(i));
+        y.push_back(2. * std::cos(i * 0.5));
+    }
+    Spline2D spline(x, y);
+
+    // Increasing, decreasing, on the knots and outside of the spline
+    std::vector<double> t;
+    for (double cur_t = -1.; cur_t < spline.parameterLength() + 1.; cur_t += 0.13)
+        t.push_back(cur_t);
+    for (int i = 0; i <= spline.numSegments(); i++)
+        t.push_back(spline.getSegmentStart(i));
+    t.push_back(0.5 * spline.parameterLength());
+
+    std::vector<Eigen::Vector2d> points, velocities, accelerations;
+    std::vector<int> segments;
+    spline.getPoints(t, points, &velocities, &accelerations, &segments);
+    ASSERT_EQ(points.size(), t.size());
+
+    for (size_t i = 0; i < t.size(); i++)
+    {
+        EXPECT_LT((points[i] - spline.getPoint(t[i])).norm(), 1e-12) << "t: " << t[i];
+        EXPECT_LT((velocities[i] - spline.getVelocity(t[i])).norm(), 1e-12) << "t: " << t[i];
+        if (t[i] >= 0.)
+        {
+            EXPECT_LT((accelerations[i] - spline.getAcceleration(t[i])).norm(), 1e-12) << "t: " << t[i];
+        }
+
+        // The segment that contains t (or the one that ends at t)
+        EXPECT_GE(t[i], spline.getSegmentStart(segments[i]) - 1e-12 - (segments[i] == 0 ? 1. : 0.));
+        EXPECT_LE(t[i], spline.getSegmentStart(segments[i] + 1) + 1e-12 + (segments[i] == spline.numSegments() - 1 ? 1. : 0.));
+    }
+
+    // Reusing the buffers with fewer parameters
+    std::vector<double> y_batch;
+    std::vector<double> t_short(t.begin(), t.begin() + 5);
+    spline.getXSpline().evaluate(t_short, y_batch);
+    ASSERT_EQ(y_batch.size(), 5u);
+    for (size_t i = 0; i < t_short.size(); i++)
+        EXPECT_DOUBLE_EQ(y_batch[i], spline.getX(t_short[i]));
+}
+
 // Run all the tests
 int main(int argc, char **argv)
 {